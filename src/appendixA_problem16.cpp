@@ -1,20 +1,301 @@
 #include "appendixA_problem16.hpp"
 
+#include <bit>
+#include <cstring>
+#include <print>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace SCO {
 // Both numA and numB have the same length
 Result binarySum(const std::string &numA, const std::string &numB) {
-  int carry = 0;
-  int prevCarry = 0;
-  Result result{std::string(numA.size(), 0)};
+  auto packedA = packBits(numA);
+  auto packedB = packBits(numB);
+  if (not packedA or not packedB) {
+    return {};
+  }
+
+  auto packedResult = binarySum(*packedA, *packedB);
+  if (not packedResult) {
+    return {};
+  }
+
+  return {unpackBits(packedResult->sum), packedResult->overflow};
+}
+
+bool PackedBits::signBit() const {
+  if (numBits == 0) {
+    return false;
+  }
+  return (limbs[(numBits - 1) / 64] >> ((numBits - 1) % 64)) & 1;
+}
+
+void PackedBits::clearUnusedBits() {
+  if (numBits % 64 != 0) {
+    limbs.back() &= (std::uint64_t{1} << (numBits % 64)) - 1;
+  }
+}
+
+namespace {
+constexpr std::uint64_t asciiZeros = 0x3030303030303030;
+// Gathers the low bit of each byte, first byte into the most significant
+// bit, in the top byte of the product
+constexpr std::uint64_t gatherBitsMultiplier = 0x8040201008040201;
+// Bit of the formatted byte each output byte tests, most significant first
+constexpr std::uint64_t spreadBitsMask = 0x0102040810204080;
+
+std::uint64_t loadCharacters(const char *characters) {
+  std::uint64_t word;
+  std::memcpy(&word, characters, sizeof(word));
+  if constexpr (std::endian::native == std::endian::big) {
+    word = std::byteswap(word);
+  }
+  return word;
+}
 
-  for (int i = static_cast<int>(numA.size()) - 1; i >= 0; i--) {
-    int sum = (numA[i] - '0') + (numB[i] - '0') + carry;
-    result.sum[i] = (sum % 2) + '0';
-    prevCarry = carry;
-    carry = sum / 2;
+void storeCharacters(std::uint64_t word, char *characters) {
+  if constexpr (std::endian::native == std::endian::big) {
+    word = std::byteswap(word);
   }
+  std::memcpy(characters, &word, sizeof(word));
+}
+
+#ifdef __SSE2__
+// SSE2 is part of x86-64, so these need no target flags. Sixteen characters
+// go through one compare and one movemask, which puts byte i in bit i, so
+// the bytes are reversed first to get the first character on top.
+__m128i reverseBytes(__m128i x) {
+  x = _mm_shuffle_epi32(x, 0x4E);
+  x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0x1B), 0x1B);
+  return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+// The 16 bits that sixteen '0' and '1' characters spell, or nullopt
+std::optional<unsigned> parseSixteen(const char *characters) {
+  const __m128i loaded =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters));
+  // Only '0' and '1' become '1' when bit 0 is set
+  const __m128i ones = _mm_set1_epi8('1');
+  const __m128i valid =
+      _mm_cmpeq_epi8(_mm_or_si128(loaded, _mm_set1_epi8(1)), ones);
+  if (_mm_movemask_epi8(valid) != 0xFFFF) {
+    return std::nullopt;
+  }
+  // Moves bit 0 of each character to the top of its byte for movemask
+  return static_cast<unsigned>(
+      _mm_movemask_epi8(_mm_slli_epi64(reverseBytes(loaded), 7)));
+}
+
+void formatSixteen(unsigned bits, char *characters) {
+  // The high byte spread over the first eight characters, the low byte over
+  // the last eight, then one bit of it kept per character
+  const auto spread = [](unsigned byte) {
+    return static_cast<long long>(byte * 0x0101010101010101);
+  };
+  const __m128i broadcast =
+      _mm_set_epi64x(spread(bits & 0xFF), spread(bits >> 8));
+  const __m128i mask = _mm_set1_epi64x(spreadBitsMask);
+  const __m128i set = _mm_cmpeq_epi8(_mm_and_si128(broadcast, mask), mask);
+  // set is -1 for the characters that become '1'
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(characters),
+                   _mm_sub_epi8(_mm_set1_epi8('0'), set));
+}
+#endif
+} // namespace
+
+std::optional<std::uint64_t> parseBitWord(std::string_view bits) {
+  if (bits.size() > 64) {
+    return std::nullopt;
+  }
+
+  std::uint64_t word = 0;
+  std::size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= bits.size(); i += 16) {
+    const auto sixteen = parseSixteen(bits.data() + i);
+    if (not sixteen) {
+      return std::nullopt;
+    }
+    word = (word << 16) | *sixteen;
+  }
+#endif
+  for (; i + 8 <= bits.size(); i += 8) {
+    // '0' and '1' become bytes 0 and 1; anything else leaves a high bit set
+    const std::uint64_t digits = loadCharacters(bits.data() + i) ^ asciiZeros;
+    if ((digits & ~0x0101010101010101) != 0) {
+      return std::nullopt;
+    }
+    word = (word << 8) | ((digits * gatherBitsMultiplier) >> 56);
+  }
+  for (; i < bits.size(); i++) {
+    const unsigned digit = static_cast<unsigned char>(bits[i]) ^ '0';
+    if (digit > 1) {
+      return std::nullopt;
+    }
+    word = (word << 1) | digit;
+  }
+
+  return word;
+}
+
+void formatBitWord(std::uint64_t word, std::span<char> out) {
+  std::size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= out.size(); i += 16) {
+    formatSixteen((word >> (out.size() - i - 16)) & 0xFFFF, out.data() + i);
+  }
+#endif
+  for (; i + 8 <= out.size(); i += 8) {
+    const std::uint64_t byte = (word >> (out.size() - i - 8)) & 0xFF;
+    // Broadcast the byte, keep one bit per output byte, then turn every
+    // nonzero byte into 1
+    const std::uint64_t spread = (byte * 0x0101010101010101) & spreadBitsMask;
+    const std::uint64_t digits =
+        ((spread + 0x7F7F7F7F7F7F7F7F) & 0x8080808080808080) >> 7;
+    storeCharacters(digits | asciiZeros, out.data() + i);
+  }
+  for (; i < out.size(); i++) {
+    out[i] = static_cast<char>('0' + ((word >> (out.size() - 1 - i)) & 1));
+  }
+}
+
+std::optional<PackedBits> packBits(std::string_view bits) {
+  PackedBits packed{bits.size(),
+                    std::vector<std::uint64_t>((bits.size() + 63) / 64)};
+
+  // Limb l holds the 64 characters ending 64 * l characters from the end;
+  // the last limb takes whatever is left at the front
+  for (std::size_t l = 0; l < packed.limbs.size(); l++) {
+    const std::size_t end = bits.size() - 64 * l;
+    const std::size_t begin = end >= 64 ? end - 64 : 0;
+    auto limb = parseBitWord(bits.substr(begin, end - begin));
+    if (not limb) {
+      const std::size_t position = bits.find_first_not_of("01", begin);
+      std::print("Invalid character '{}' at position {} of a bit string\n",
+                 bits[position], position);
+      return std::nullopt;
+    }
+    packed.limbs[l] = *limb;
+  }
+
+  return packed;
+}
+
+std::string unpackBits(const PackedBits &packed) {
+  // Every character is written once by formatBitWord, so the string is not
+  // filled first; that fill alone cost more than the formatting
+  std::string bits;
+  bits.resize_and_overwrite(packed.numBits, [&](char *out, std::size_t size) {
+    for (std::size_t l = 0; l < packed.limbs.size(); l++) {
+      const std::size_t end = size - 64 * l;
+      const std::size_t begin = end >= 64 ? end - 64 : 0;
+      formatBitWord(packed.limbs[l], std::span(out + begin, end - begin));
+    }
+    return size;
+  });
+  return bits;
+}
+
+namespace {
+// One step of a carry chain. With __builtin_addcll the compiler emits a
+// single add-with-carry per limb; __builtin_add_overflow is the portable
+// spelling that GCC also turns into adc.
+std::uint64_t addWithCarry(std::uint64_t a, std::uint64_t b,
+                           std::uint64_t carryIn, std::uint64_t &carryOut) {
+#if defined(__has_builtin) && __has_builtin(__builtin_addcll)
+  unsigned long long carry;
+  std::uint64_t sum = __builtin_addcll(a, b, carryIn, &carry);
+  carryOut = carry;
+  return sum;
+#else
+  std::uint64_t sum;
+  const bool carryA = __builtin_add_overflow(a, b, &sum);
+  const bool carryB = __builtin_add_overflow(sum, carryIn, &sum);
+  carryOut = carryA | carryB;
+  return sum;
+#endif
+}
+
+std::uint64_t subtractWithBorrow(std::uint64_t a, std::uint64_t b,
+                                 std::uint64_t borrowIn,
+                                 std::uint64_t &borrowOut) {
+#if defined(__has_builtin) && __has_builtin(__builtin_subcll)
+  unsigned long long borrow;
+  std::uint64_t difference = __builtin_subcll(a, b, borrowIn, &borrow);
+  borrowOut = borrow;
+  return difference;
+#else
+  std::uint64_t difference;
+  const bool borrowA = __builtin_sub_overflow(a, b, &difference);
+  const bool borrowB =
+      __builtin_sub_overflow(difference, borrowIn, &difference);
+  borrowOut = borrowA | borrowB;
+  return difference;
+#endif
+}
+
+bool haveSameWidth(const PackedBits &numA, const PackedBits &numB) {
+  if (numA.numBits != numB.numBits) {
+    std::print("Operands have different widths: {} and {} bits\n",
+               numA.numBits, numB.numBits);
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+std::uint64_t addLimbs(std::span<const std::uint64_t> a,
+                       std::span<const std::uint64_t> b,
+                       std::span<std::uint64_t> out, std::uint64_t carry) {
+  for (std::size_t i = 0; i < a.size(); i++) {
+    out[i] = addWithCarry(a[i], b[i], carry, carry);
+  }
+  return carry;
+}
+
+std::uint64_t subtractLimbs(std::span<const std::uint64_t> a,
+                            std::span<const std::uint64_t> b,
+                            std::span<std::uint64_t> out,
+                            std::uint64_t borrow) {
+  for (std::size_t i = 0; i < a.size(); i++) {
+    out[i] = subtractWithBorrow(a[i], b[i], borrow, borrow);
+  }
+  return borrow;
+}
+
+std::optional<PackedResult> binarySum(const PackedBits &numA,
+                                      const PackedBits &numB) {
+  if (not haveSameWidth(numA, numB)) {
+    return std::nullopt;
+  }
+
+  PackedResult result{{numA.numBits,
+                       std::vector<std::uint64_t>(numA.limbs.size())}};
+  addLimbs(numA.limbs, numB.limbs, result.sum.limbs);
+  result.sum.clearUnusedBits();
+
+  // Adding two numbers of the same sign must keep that sign
+  result.overflow = numA.signBit() == numB.signBit() and
+                    result.sum.signBit() != numA.signBit();
+  return result;
+}
+
+std::optional<PackedResult> binaryDifference(const PackedBits &numA,
+                                             const PackedBits &numB) {
+  if (not haveSameWidth(numA, numB)) {
+    return std::nullopt;
+  }
+
+  PackedResult result{{numA.numBits,
+                       std::vector<std::uint64_t>(numA.limbs.size())}};
+  subtractLimbs(numA.limbs, numB.limbs, result.sum.limbs);
+  result.sum.clearUnusedBits();
 
-  result.overflow = carry != prevCarry;
+  // Subtracting a number of the other sign must keep numA's sign
+  result.overflow = numA.signBit() != numB.signBit() and
+                    result.sum.signBit() != numA.signBit();
   return result;
 }
 } // namespace SCO
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace SCO {
@@ -10,4 +14,50 @@ struct Result {
 };
 
 Result binarySum(const std::string &numA, const std::string &numB);
+
+// Fixed-width two's complement number packed 64 bits per limb, least
+// significant limb first. Bits of the last limb past numBits are clear.
+struct PackedBits {
+  std::size_t numBits = 0;
+  std::vector<std::uint64_t> limbs;
+
+  bool signBit() const;
+  void clearUnusedBits();
+};
+
+struct PackedResult {
+  PackedBits sum;
+  bool overflow = false;
+};
+
+// Parses up to 64 '0'/'1' characters, most significant bit first, eight
+// characters per 64-bit load. nullopt if any other character is found.
+std::optional<std::uint64_t> parseBitWord(std::string_view bits);
+// Writes the low out.size() (at most 64) bits of word to out as '0'/'1',
+// most significant bit first, eight characters per 64-bit store
+void formatBitWord(std::uint64_t word, std::span<char> out);
+
+// Converts between PackedBits and '0'/'1' strings, most significant bit
+// first like binarySum's
+std::optional<PackedBits> packBits(std::string_view bits);
+std::string unpackBits(const PackedBits &packed);
+
+// out = a + b + carry over limb spans of the same size; returns the carry
+// out of the last limb. out may alias a or b.
+std::uint64_t addLimbs(std::span<const std::uint64_t> a,
+                       std::span<const std::uint64_t> b,
+                       std::span<std::uint64_t> out, std::uint64_t carry = 0);
+// out = a - b - borrow; returns the borrow out of the last limb
+std::uint64_t subtractLimbs(std::span<const std::uint64_t> a,
+                            std::span<const std::uint64_t> b,
+                            std::span<std::uint64_t> out,
+                            std::uint64_t borrow = 0);
+
+// Two's complement addition and subtraction of operands of the same width,
+// wrapping to that width. overflow is set when the signed result does not
+// fit.
+std::optional<PackedResult> binarySum(const PackedBits &numA,
+                                      const PackedBits &numB);
+std::optional<PackedResult> binaryDifference(const PackedBits &numA,
+                                             const PackedBits &numB);
 } // namespace SCO
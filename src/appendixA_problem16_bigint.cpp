@@ -0,0 +1,649 @@
+#include "appendixA_problem16_bigint.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <print>
+#include <span>
+#include <utility>
+
+#include "appendixA_problem16.hpp"
+
+namespace SCO {
+namespace {
+using Limbs = std::vector<std::uint64_t>;
+using UInt128 = unsigned __int128;
+
+// Below these sizes the quadratic algorithms win
+constexpr std::size_t reciprocalBaseLimbs = 16;
+constexpr std::size_t formatBaseLimbs = 32;
+constexpr std::size_t parseBaseChunks = 32;
+
+void trim(Limbs &a) {
+  while (not a.empty() and a.back() == 0) {
+    a.pop_back();
+  }
+}
+
+std::span<const std::uint64_t> trimmed(std::span<const std::uint64_t> a) {
+  while (not a.empty() and a.back() == 0) {
+    a = a.first(a.size() - 1);
+  }
+  return a;
+}
+
+BigInteger makeBigInteger(Limbs limbs, bool negative = false) {
+  BigInteger result;
+  result.limbs = std::move(limbs);
+  result.negative = negative;
+  result.normalize();
+  return result;
+}
+
+int compareMagnitudes(std::span<const std::uint64_t> a,
+                      std::span<const std::uint64_t> b) {
+  if (a.size() != b.size()) {
+    return a.size() < b.size() ? -1 : 1;
+  }
+  for (std::size_t i = a.size(); i-- > 0;) {
+    if (a[i] != b[i]) {
+      return a[i] < b[i] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+// a += b << (64 * offset); a must already be wide enough for the result
+void addInto(Limbs &a, std::span<const std::uint64_t> b,
+             std::size_t offset = 0) {
+  std::span<std::uint64_t> target(a.data() + offset, b.size());
+  std::uint64_t carry = addLimbs(target, b, target);
+  for (std::size_t i = offset + b.size(); carry != 0; i++) {
+    a[i]++;
+    carry = a[i] == 0;
+  }
+}
+
+// a -= b << (64 * offset); the result must not be negative
+void subtractFrom(Limbs &a, std::span<const std::uint64_t> b,
+                  std::size_t offset = 0) {
+  std::span<std::uint64_t> target(a.data() + offset, b.size());
+  std::uint64_t borrow = subtractLimbs(target, b, target);
+  for (std::size_t i = offset + b.size(); borrow != 0; i++) {
+    borrow = a[i] == 0;
+    a[i]--;
+  }
+}
+
+Limbs addMagnitudes(std::span<const std::uint64_t> a,
+                    std::span<const std::uint64_t> b) {
+  if (a.size() < b.size()) {
+    std::swap(a, b);
+  }
+  Limbs result(a.begin(), a.end());
+  result.push_back(0);
+  addInto(result, b);
+  trim(result);
+  return result;
+}
+
+// a - b for a >= b
+Limbs subtractMagnitudes(std::span<const std::uint64_t> a,
+                         std::span<const std::uint64_t> b) {
+  Limbs result(a.begin(), a.end());
+  subtractFrom(result, trimmed(b));
+  trim(result);
+  return result;
+}
+
+// a = a * multiplier + addend
+void multiplyAddSmall(Limbs &a, std::uint64_t multiplier,
+                      std::uint64_t addend) {
+  std::uint64_t carry = addend;
+  for (auto &limb : a) {
+    const UInt128 product = UInt128{limb} * multiplier + carry;
+    limb = static_cast<std::uint64_t>(product);
+    carry = static_cast<std::uint64_t>(product >> 64);
+  }
+  if (carry != 0) {
+    a.push_back(carry);
+  }
+}
+
+// Divides a in place, returning the remainder
+std::uint64_t divideSmall(Limbs &a, std::uint64_t divisor) {
+  UInt128 remainder = 0;
+  for (std::size_t i = a.size(); i-- > 0;) {
+    const UInt128 current = (remainder << 64) | a[i];
+    a[i] = static_cast<std::uint64_t>(current / divisor);
+    remainder = current % divisor;
+  }
+  trim(a);
+  return static_cast<std::uint64_t>(remainder);
+}
+
+// out must be zeroed and hold a.size() + b.size() limbs
+void multiplySchoolbook(std::span<const std::uint64_t> a,
+                        std::span<const std::uint64_t> b,
+                        std::span<std::uint64_t> out) {
+  for (std::size_t i = 0; i < a.size(); i++) {
+    std::uint64_t carry = 0;
+    for (std::size_t j = 0; j < b.size(); j++) {
+      const UInt128 product = UInt128{a[i]} * b[j] + out[i + j] + carry;
+      out[i + j] = static_cast<std::uint64_t>(product);
+      carry = static_cast<std::uint64_t>(product >> 64);
+    }
+    out[i + b.size()] = carry;
+  }
+}
+
+Limbs multiplyMagnitudes(std::span<const std::uint64_t> a,
+                         std::span<const std::uint64_t> b,
+                         std::size_t karatsubaThreshold) {
+  a = trimmed(a);
+  b = trimmed(b);
+  if (a.empty() or b.empty()) {
+    return {};
+  }
+  if (a.size() < b.size()) {
+    std::swap(a, b);
+  }
+
+  Limbs result(a.size() + b.size());
+  if (b.size() < std::max<std::size_t>(karatsubaThreshold, 2)) {
+    multiplySchoolbook(a, b, result);
+  } else if (a.size() >= 2 * b.size()) {
+    // Unbalanced operands: multiply b by b-sized slices of a
+    for (std::size_t offset = 0; offset < a.size(); offset += b.size()) {
+      auto slice = a.subspan(offset, std::min(b.size(), a.size() - offset));
+      addInto(result, multiplyMagnitudes(slice, b, karatsubaThreshold),
+              offset);
+    }
+  } else {
+    // a1 B^m + a0 times b1 B^m + b0 with three half-size products:
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2 is the middle term
+    const std::size_t m = a.size() / 2;
+    const auto a0 = a.first(m);
+    const auto a1 = a.subspan(m);
+    const auto b0 = b.first(m);
+    const auto b1 = b.subspan(m);
+
+    const Limbs z0 = multiplyMagnitudes(a0, b0, karatsubaThreshold);
+    const Limbs z2 = multiplyMagnitudes(a1, b1, karatsubaThreshold);
+    Limbs z1 = multiplyMagnitudes(addMagnitudes(a0, a1),
+                                  addMagnitudes(b0, b1), karatsubaThreshold);
+    subtractFrom(z1, z0);
+    subtractFrom(z1, z2);
+    trim(z1);
+
+    addInto(result, z0);
+    addInto(result, z1, m);
+    addInto(result, z2, 2 * m);
+  }
+
+  trim(result);
+  return result;
+}
+
+Limbs shiftLeftMagnitude(std::span<const std::uint64_t> a, std::size_t bits) {
+  if (a.empty()) {
+    return {};
+  }
+
+  const std::size_t limbShift = bits / 64;
+  const std::size_t bitShift = bits % 64;
+  Limbs result(a.size() + limbShift + 1);
+  for (std::size_t i = 0; i < a.size(); i++) {
+    result[i + limbShift] |= a[i] << bitShift;
+    if (bitShift != 0) {
+      result[i + limbShift + 1] |= a[i] >> (64 - bitShift);
+    }
+  }
+  trim(result);
+  return result;
+}
+
+// Sets lostBits when any bit shifted out was set
+Limbs shiftRightMagnitude(std::span<const std::uint64_t> a, std::size_t bits,
+                          bool &lostBits) {
+  const std::size_t limbShift = bits / 64;
+  const std::size_t bitShift = bits % 64;
+  lostBits = false;
+  for (std::size_t i = 0; i < std::min(limbShift, a.size()); i++) {
+    lostBits = lostBits or a[i] != 0;
+  }
+  if (limbShift >= a.size()) {
+    return {};
+  }
+  if (bitShift != 0) {
+    lostBits = lostBits or (a[limbShift] << (64 - bitShift)) != 0;
+  }
+
+  Limbs result(a.size() - limbShift);
+  for (std::size_t i = 0; i < result.size(); i++) {
+    result[i] = a[i + limbShift] >> bitShift;
+    if (bitShift != 0 and i + limbShift + 1 < a.size()) {
+      result[i] |= a[i + limbShift + 1] << (64 - bitShift);
+    }
+  }
+  trim(result);
+  return result;
+}
+
+// Knuth's Algorithm D (TAOCP 4.3.1) on 64-bit digits
+void divideMagnitudes(std::span<const std::uint64_t> u,
+                      std::span<const std::uint64_t> v, Limbs &quotient,
+                      Limbs &remainder) {
+  u = trimmed(u);
+  v = trimmed(v);
+  if (compareMagnitudes(u, v) < 0) {
+    quotient.clear();
+    remainder.assign(u.begin(), u.end());
+    return;
+  }
+  if (v.size() == 1) {
+    quotient.assign(u.begin(), u.end());
+    remainder = {divideSmall(quotient, v[0])};
+    trim(remainder);
+    return;
+  }
+
+  // Normalize so the divisor's top bit is set, which keeps every trial
+  // quotient digit within two of the real one
+  const std::size_t n = v.size();
+  const std::size_t m = u.size() - n;
+  const int shift = std::countl_zero(v.back());
+  Limbs vn = shiftLeftMagnitude(v, shift);
+  Limbs un = shiftLeftMagnitude(u, shift);
+  un.resize(u.size() + 1);
+
+  quotient.assign(m + 1, 0);
+  for (std::size_t j = m + 1; j-- > 0;) {
+    const UInt128 numerator = (UInt128{un[j + n]} << 64) | un[j + n - 1];
+    UInt128 qhat = numerator / vn[n - 1];
+    UInt128 rhat = numerator % vn[n - 1];
+    while ((qhat >> 64) != 0 or
+           qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+      qhat--;
+      rhat += vn[n - 1];
+      if ((rhat >> 64) != 0) {
+        break;
+      }
+    }
+
+    // un[j .. j + n] -= qhat * vn
+    const std::uint64_t q = static_cast<std::uint64_t>(qhat);
+    std::uint64_t carry = 0;
+    std::uint64_t borrow = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      const UInt128 product = UInt128{q} * vn[i] + carry;
+      carry = static_cast<std::uint64_t>(product >> 64);
+      const std::uint64_t low = static_cast<std::uint64_t>(product);
+      const std::uint64_t x = un[i + j];
+      const std::uint64_t difference = x - low;
+      const std::uint64_t result = difference - borrow;
+      borrow = (x < low) + (difference < borrow);
+      un[i + j] = result;
+    }
+    const std::uint64_t x = un[j + n];
+    const std::uint64_t difference = x - carry;
+    un[j + n] = difference - borrow;
+    const bool negative = x < carry or difference < borrow;
+
+    quotient[j] = q;
+    if (negative) {
+      // qhat was one too large: add the divisor back
+      quotient[j]--;
+      std::span<std::uint64_t> window(un.data() + j, n);
+      un[j + n] += addLimbs(window, vn, window);
+    }
+  }
+
+  bool lostBits;
+  remainder = shiftRightMagnitude(std::span(un).first(n), shift, lostBits);
+  trim(quotient);
+}
+
+// floor(B^(2n) / p) for n = p.size() and B = 2^64, by Newton's iteration
+// from the reciprocal of p's top half
+Limbs reciprocal(const Limbs &p) {
+  const std::size_t n = p.size();
+  if (n <= reciprocalBaseLimbs) {
+    Limbs power(2 * n + 1);
+    power.back() = 1;
+    Limbs quotient;
+    Limbs remainder;
+    divideMagnitudes(power, p, quotient, remainder);
+    return quotient;
+  }
+
+  // Two guard limbs keep the estimate within a few units of the result
+  const std::size_t h = std::min(n, n / 2 + 2);
+  const Limbs topHalf(p.end() - h, p.end());
+  const BigInteger estimate = makeBigInteger(reciprocal(topHalf))
+                              << 64 * (n - h);
+
+  // x + x (B^2n - p x) / B^2n, then an exact correction that divides
+  // only a few limbs
+  const BigInteger divisor = makeBigInteger(p);
+  const BigInteger power = BigInteger(1) << 128 * n;
+  const BigInteger error = power - divisor * estimate;
+  BigInteger result = estimate + ((estimate * error) >> 128 * n);
+
+  auto correction = divide(power - divisor * result, divisor);
+  result = result + correction->quotient;
+  if (correction->remainder.negative) {
+    result = result - 1;
+  }
+  return result.limbs;
+}
+
+// n / p for n < B^(2 p.size()), with p's reciprocal from reciprocal()
+void divideBarrett(std::span<const std::uint64_t> n, const Limbs &p,
+                   const Limbs &pReciprocal, Limbs &quotient,
+                   Limbs &remainder) {
+  // Underestimates the quotient by at most two
+  const Limbs product =
+      multiplyMagnitudes(n, pReciprocal, defaultKaratsubaThreshold);
+  const std::size_t shift = 2 * p.size();
+  quotient.assign(product.begin() + std::min(shift, product.size()),
+                  product.end());
+  remainder = subtractMagnitudes(
+      n, multiplyMagnitudes(quotient, p, defaultKaratsubaThreshold));
+
+  while (compareMagnitudes(remainder, p) >= 0) {
+    remainder = subtractMagnitudes(remainder, p);
+    quotient = addMagnitudes(quotient, Limbs{1});
+  }
+}
+
+int digitValue(char c) {
+  if (c >= '0' and c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' and c <= 'z') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' and c <= 'Z') {
+    return c - 'A' + 10;
+  }
+  return 36;
+}
+
+// chunkBase^(2^k) and their reciprocals, built on demand; chunkBase is the
+// largest power of the base that fits in a limb
+struct RadixPowers {
+  unsigned base;
+  std::size_t chunkDigits = 0;
+  std::uint64_t chunkBase = 1;
+  std::vector<Limbs> powers;
+  std::vector<Limbs> reciprocals;
+
+  explicit RadixPowers(unsigned base) : base(base) {
+    while (chunkBase <= UINT64_MAX / base) {
+      chunkBase *= base;
+      chunkDigits++;
+    }
+    powers.push_back({chunkBase});
+  }
+
+  std::size_t digits(std::size_t k) const { return chunkDigits << k; }
+
+  const Limbs &power(std::size_t k) {
+    while (powers.size() <= k) {
+      powers.push_back(multiplyMagnitudes(powers.back(), powers.back(),
+                                          defaultKaratsubaThreshold));
+    }
+    return powers[k];
+  }
+
+  const Limbs &reciprocalOf(std::size_t k) {
+    if (reciprocals.size() <= k) {
+      reciprocals.resize(k + 1);
+    }
+    if (reciprocals[k].empty()) {
+      reciprocals[k] = reciprocal(power(k));
+    }
+    return reciprocals[k];
+  }
+};
+
+constexpr char digitCharacters[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// Appends n's digits: exactly width of them, or without leading zeros when
+// width is 0
+void formatDigits(std::span<const std::uint64_t> n, RadixPowers &powers,
+                  std::size_t width, std::string &out) {
+  if (n.size() <= formatBaseLimbs) {
+    Limbs rest(n.begin(), n.end());
+    std::string digits;
+    while (not rest.empty()) {
+      std::uint64_t chunk = divideSmall(rest, powers.chunkBase);
+      for (std::size_t d = 0; d < powers.chunkDigits; d++) {
+        digits.push_back(digitCharacters[chunk % powers.base]);
+        chunk /= powers.base;
+      }
+    }
+    while (not digits.empty() and digits.back() == '0') {
+      digits.pop_back();
+    }
+    if (digits.size() < width) {
+      digits.resize(width, '0');
+    }
+    out.append(digits.rbegin(), digits.rend());
+    return;
+  }
+
+  // Split by the smallest power at least half n's size, so n < power^2
+  std::size_t k = 0;
+  while (2 * powers.power(k).size() < n.size()) {
+    k++;
+  }
+  Limbs quotient;
+  Limbs remainder;
+  divideBarrett(n, powers.power(k), powers.reciprocalOf(k), quotient,
+                remainder);
+
+  formatDigits(quotient, powers, width == 0 ? 0 : width - powers.digits(k),
+               out);
+  formatDigits(remainder, powers, powers.digits(k), out);
+}
+
+Limbs parseDigits(std::string_view digits, RadixPowers &powers) {
+  if (digits.size() <= parseBaseChunks * powers.chunkDigits) {
+    Limbs value;
+    for (std::size_t begin = 0; begin < digits.size();
+         begin += powers.chunkDigits) {
+      const auto chunk = digits.substr(begin, powers.chunkDigits);
+      std::uint64_t chunkValue = 0;
+      std::uint64_t multiplier = 1;
+      for (char c : chunk) {
+        chunkValue = chunkValue * powers.base + digitValue(c);
+        multiplier *= powers.base;
+      }
+      multiplyAddSmall(value, multiplier, chunkValue);
+    }
+    trim(value);
+    return value;
+  }
+
+  // high * base^digits(k) + low with the largest power shorter than digits
+  std::size_t k = 0;
+  while (powers.digits(k + 1) < digits.size()) {
+    k++;
+  }
+  const std::size_t split = digits.size() - powers.digits(k);
+  Limbs value =
+      multiplyMagnitudes(parseDigits(digits.substr(0, split), powers),
+                         powers.power(k), defaultKaratsubaThreshold);
+  const Limbs low = parseDigits(digits.substr(split), powers);
+  value.resize(std::max(value.size(), low.size()) + 1);
+  addInto(value, low);
+  trim(value);
+  return value;
+}
+} // namespace
+
+BigInteger::BigInteger(std::int64_t value) : negative(value < 0) {
+  const std::uint64_t magnitude =
+      negative ? 0 - static_cast<std::uint64_t>(value)
+               : static_cast<std::uint64_t>(value);
+  if (magnitude != 0) {
+    limbs.push_back(magnitude);
+  }
+}
+
+std::size_t BigInteger::bitWidth() const {
+  return limbs.empty()
+             ? 0
+             : 64 * (limbs.size() - 1) + std::bit_width(limbs.back());
+}
+
+void BigInteger::normalize() {
+  trim(limbs);
+  if (limbs.empty()) {
+    negative = false;
+  }
+}
+
+std::strong_ordering operator<=>(const BigInteger &a, const BigInteger &b) {
+  if (a.negative != b.negative) {
+    return a.negative ? std::strong_ordering::less
+                      : std::strong_ordering::greater;
+  }
+  const int comparison = a.negative ? compareMagnitudes(b.limbs, a.limbs)
+                                    : compareMagnitudes(a.limbs, b.limbs);
+  return comparison <=> 0;
+}
+
+BigInteger operator-(const BigInteger &a) {
+  return makeBigInteger(a.limbs, not a.negative);
+}
+
+BigInteger operator+(const BigInteger &a, const BigInteger &b) {
+  if (a.negative == b.negative) {
+    return makeBigInteger(addMagnitudes(a.limbs, b.limbs), a.negative);
+  }
+  if (compareMagnitudes(a.limbs, b.limbs) >= 0) {
+    return makeBigInteger(subtractMagnitudes(a.limbs, b.limbs), a.negative);
+  }
+  return makeBigInteger(subtractMagnitudes(b.limbs, a.limbs), b.negative);
+}
+
+BigInteger operator-(const BigInteger &a, const BigInteger &b) {
+  return a + (-b);
+}
+
+BigInteger operator*(const BigInteger &a, const BigInteger &b) {
+  return multiply(a, b);
+}
+
+BigInteger operator<<(const BigInteger &a, std::size_t bits) {
+  return makeBigInteger(shiftLeftMagnitude(a.limbs, bits), a.negative);
+}
+
+BigInteger operator>>(const BigInteger &a, std::size_t bits) {
+  bool lostBits;
+  BigInteger result =
+      makeBigInteger(shiftRightMagnitude(a.limbs, bits, lostBits), a.negative);
+  // Truncating the magnitude rounds a negative number up
+  if (a.negative and lostBits) {
+    result = result - 1;
+  }
+  return result;
+}
+
+BigInteger multiply(const BigInteger &a, const BigInteger &b,
+                    std::size_t karatsubaThreshold) {
+  return makeBigInteger(
+      multiplyMagnitudes(a.limbs, b.limbs, karatsubaThreshold),
+      a.negative != b.negative);
+}
+
+std::optional<BigIntegerDivision> divide(const BigInteger &numerator,
+                                         const BigInteger &denominator) {
+  if (denominator.isZero()) {
+    std::print("Division by zero\n");
+    return std::nullopt;
+  }
+
+  Limbs quotient;
+  Limbs remainder;
+  divideMagnitudes(numerator.limbs, denominator.limbs, quotient, remainder);
+  return BigIntegerDivision{
+      makeBigInteger(std::move(quotient),
+                     numerator.negative != denominator.negative),
+      makeBigInteger(std::move(remainder), numerator.negative)};
+}
+
+std::optional<BigInteger> parseBigInteger(std::string_view digits,
+                                          unsigned base) {
+  if (base < 2 or base > 36) {
+    std::print("Unsupported base {}\n", base);
+    return std::nullopt;
+  }
+
+  const bool negative = digits.starts_with('-');
+  if (negative) {
+    digits.remove_prefix(1);
+  }
+  if (digits.empty()) {
+    std::print("Missing digits\n");
+    return std::nullopt;
+  }
+  for (std::size_t i = 0; i < digits.size(); i++) {
+    if (digitValue(digits[i]) >= static_cast<int>(base)) {
+      std::print("Invalid digit '{}' at position {} for base {}\n",
+                 digits[i], i, base);
+      return std::nullopt;
+    }
+  }
+
+  if (std::has_single_bit(base)) {
+    // Each digit is a fixed group of bits, read from the least significant
+    const int bitsPerDigit = std::countr_zero(base);
+    Limbs limbs((digits.size() * bitsPerDigit + 63) / 64);
+    for (std::size_t i = 0; i < digits.size(); i++) {
+      const std::uint64_t value = digitValue(digits[digits.size() - 1 - i]);
+      const std::size_t bit = i * bitsPerDigit;
+      limbs[bit / 64] |= value << (bit % 64);
+      if (bit % 64 + bitsPerDigit > 64) {
+        limbs[bit / 64 + 1] |= value >> (64 - bit % 64);
+      }
+    }
+    return makeBigInteger(std::move(limbs), negative);
+  }
+
+  RadixPowers powers(base);
+  return makeBigInteger(parseDigits(digits, powers), negative);
+}
+
+std::string toString(const BigInteger &value, unsigned base) {
+  if (base < 2 or base > 36) {
+    std::print("Unsupported base {}\n", base);
+    return {};
+  }
+  if (value.isZero()) {
+    return "0";
+  }
+
+  std::string result = value.negative ? "-" : "";
+  if (std::has_single_bit(base)) {
+    const std::size_t bitsPerDigit = std::countr_zero(base);
+    const std::size_t numDigits =
+        (value.bitWidth() + bitsPerDigit - 1) / bitsPerDigit;
+    for (std::size_t d = numDigits; d-- > 0;) {
+      const std::size_t bit = d * bitsPerDigit;
+      std::uint64_t digit = value.limbs[bit / 64] >> (bit % 64);
+      if (bit % 64 + bitsPerDigit > 64 and bit / 64 + 1 < value.limbs.size()) {
+        digit |= value.limbs[bit / 64 + 1] << (64 - bit % 64);
+      }
+      result.push_back(digitCharacters[digit & (base - 1)]);
+    }
+    return result;
+  }
+
+  RadixPowers powers(base);
+  formatDigits(value.limbs, powers, 0, result);
+  return result;
+}
+} // namespace SCO
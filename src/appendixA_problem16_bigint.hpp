@@ -0,0 +1,63 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SCO {
+// Limbs per operand below which multiplication is schoolbook
+inline constexpr std::size_t defaultKaratsubaThreshold = 32;
+
+// Arbitrary-precision integer in sign-magnitude form: 64-bit limbs, least
+// significant first, with no leading zero limbs. Zero has no limbs and is
+// never negative.
+struct BigInteger {
+  bool negative = false;
+  std::vector<std::uint64_t> limbs;
+
+  BigInteger() = default;
+  BigInteger(std::int64_t value);
+
+  bool isZero() const { return limbs.empty(); }
+  std::size_t bitWidth() const;
+  // Restores the invariants after limbs were changed directly
+  void normalize();
+
+  bool operator==(const BigInteger &) const = default;
+};
+
+std::strong_ordering operator<=>(const BigInteger &a, const BigInteger &b);
+
+BigInteger operator-(const BigInteger &a);
+BigInteger operator+(const BigInteger &a, const BigInteger &b);
+BigInteger operator-(const BigInteger &a, const BigInteger &b);
+BigInteger operator*(const BigInteger &a, const BigInteger &b);
+BigInteger operator<<(const BigInteger &a, std::size_t bits);
+// Rounds towards negative infinity like >> on signed integers
+BigInteger operator>>(const BigInteger &a, std::size_t bits);
+
+// Schoolbook below karatsubaThreshold limbs, Karatsuba above
+BigInteger multiply(const BigInteger &a, const BigInteger &b,
+                    std::size_t karatsubaThreshold = defaultKaratsubaThreshold);
+
+struct BigIntegerDivision {
+  BigInteger quotient;
+  BigInteger remainder;
+};
+
+// Truncating division like / and % on built-in integers, using Knuth's
+// Algorithm D. nullopt when dividing by zero.
+std::optional<BigIntegerDivision> divide(const BigInteger &numerator,
+                                         const BigInteger &denominator);
+
+// Digits in bases 2 to 36, with an optional leading '-'. Power-of-two bases
+// convert in linear time, others divide and conquer over powers of the
+// base: parsing multiplies halves together and formatting splits with
+// Barrett division by precomputed reciprocals.
+std::optional<BigInteger> parseBigInteger(std::string_view digits,
+                                          unsigned base = 10);
+std::string toString(const BigInteger &value, unsigned base = 10);
+} // namespace SCO
@@ -0,0 +1,232 @@
+#include <chrono>
+#include <print>
+#include <random>
+
+#include "appendixA_problem16_bigint.hpp"
+#include "gtest/gtest.h"
+
+namespace SCO {
+namespace {
+BigInteger randomBigInteger(std::mt19937_64 &generator, std::size_t numLimbs,
+                            bool allowNegative = true) {
+  BigInteger value;
+  for (std::size_t i = 0; i < numLimbs; i++) {
+    // Runs of all-zero and all-one limbs hit the carry and correction paths
+    switch (generator() % 4) {
+    case 0:
+      value.limbs.push_back(0);
+      break;
+    case 1:
+      value.limbs.push_back(UINT64_MAX);
+      break;
+    default:
+      value.limbs.push_back(generator());
+      break;
+    }
+  }
+  value.negative = allowNegative and (generator() & 1);
+  value.normalize();
+  return value;
+}
+
+BigInteger fromInt128(__int128 value) {
+  const bool negative = value < 0;
+  unsigned __int128 magnitude =
+      negative ? 0 - static_cast<unsigned __int128>(value)
+               : static_cast<unsigned __int128>(value);
+  BigInteger result;
+  result.limbs = {static_cast<std::uint64_t>(magnitude),
+                  static_cast<std::uint64_t>(magnitude >> 64)};
+  result.negative = negative;
+  result.normalize();
+  return result;
+}
+
+// Digits by repeated division by the base, for checking toString
+std::string toStringSlowly(BigInteger value, unsigned base) {
+  if (value.isZero()) {
+    return "0";
+  }
+  const bool negative = value.negative;
+  value.negative = false;
+  std::string digits;
+  while (not value.isZero()) {
+    auto division = divide(value, BigInteger(base));
+    const std::uint64_t digit =
+        division->remainder.isZero() ? 0 : division->remainder.limbs[0];
+    digits.push_back("0123456789abcdefghijklmnopqrstuvwxyz"[digit]);
+    value = division->quotient;
+  }
+  if (negative) {
+    digits.push_back('-');
+  }
+  return {digits.rbegin(), digits.rend()};
+}
+} // namespace
+
+TEST(BigIntegerTest, MatchesInt128) {
+  std::mt19937_64 generator(42);
+  for (int sample = 0; sample < 2000; sample++) {
+    const __int128 a = static_cast<std::int64_t>(generator()) >>
+                       (generator() % 64);
+    const __int128 b = static_cast<std::int64_t>(generator()) >>
+                       (generator() % 64);
+    const BigInteger bigA = fromInt128(a);
+    const BigInteger bigB = fromInt128(b);
+
+    EXPECT_EQ(bigA + bigB, fromInt128(a + b));
+    EXPECT_EQ(bigA - bigB, fromInt128(a - b));
+    EXPECT_EQ(bigA * bigB, fromInt128(a * b));
+    EXPECT_EQ(bigA <=> bigB, a <=> b);
+    EXPECT_EQ(bigA << 37, fromInt128(a * (__int128{1} << 37)));
+    EXPECT_EQ(bigA >> 5, fromInt128(a >> 5));
+    if (b != 0) {
+      auto division = divide(bigA, bigB);
+      ASSERT_TRUE(division.has_value());
+      EXPECT_EQ(division->quotient, fromInt128(a / b));
+      EXPECT_EQ(division->remainder, fromInt128(a % b));
+    }
+  }
+
+  EXPECT_FALSE(divide(BigInteger(1), BigInteger()).has_value());
+  EXPECT_EQ(BigInteger(-1) >> 100, BigInteger(-1));
+  EXPECT_EQ(BigInteger(INT64_MIN).limbs[0], std::uint64_t{1} << 63);
+}
+
+TEST(BigIntegerTest, KaratsubaMatchesSchoolbook) {
+  std::mt19937_64 generator(42);
+  for (auto [sizeA, sizeB] : {std::pair{40, 40}, {64, 33}, {100, 7},
+                              {257, 130}, {300, 299}}) {
+    const BigInteger a = randomBigInteger(generator, sizeA);
+    const BigInteger b = randomBigInteger(generator, sizeB);
+    const BigInteger schoolbook = multiply(a, b, SIZE_MAX);
+    for (std::size_t threshold : {2, 4, 16, 32}) {
+      EXPECT_EQ(multiply(a, b, threshold), schoolbook)
+          << sizeA << "x" << sizeB << " limbs, threshold " << threshold;
+    }
+  }
+}
+
+TEST(BigIntegerTest, DivisionIdentity) {
+  std::mt19937_64 generator(42);
+  for (int sample = 0; sample < 300; sample++) {
+    const BigInteger numerator =
+        randomBigInteger(generator, 1 + generator() % 40);
+    const BigInteger denominator =
+        randomBigInteger(generator, 1 + generator() % 20);
+    if (denominator.isZero()) {
+      continue;
+    }
+
+    auto division = divide(numerator, denominator);
+    ASSERT_TRUE(division.has_value());
+    EXPECT_EQ(division->quotient * denominator + division->remainder,
+              numerator);
+    BigInteger absRemainder = division->remainder;
+    absRemainder.negative = false;
+    BigInteger absDenominator = denominator;
+    absDenominator.negative = false;
+    EXPECT_LT(absRemainder, absDenominator);
+    EXPECT_TRUE(division->remainder.isZero() or
+                division->remainder.negative == numerator.negative);
+  }
+
+  // Divisor with a top limb of 0x8000... and a numerator that makes the
+  // trial quotient digit too large, so the add-back step runs
+  BigInteger numerator;
+  numerator.limbs = {0, 0, 0x8000000000000000, 0x7FFFFFFFFFFFFFFF};
+  BigInteger denominator;
+  denominator.limbs = {1, 0, 0x8000000000000000};
+  auto division = divide(numerator, denominator);
+  EXPECT_EQ(division->quotient * denominator + division->remainder, numerator);
+  EXPECT_LT(division->remainder, denominator);
+}
+
+TEST(BigIntegerTest, RadixConversion) {
+  EXPECT_EQ(toString(BigInteger()), "0");
+  EXPECT_EQ(toString(BigInteger(-255), 16), "-ff");
+  EXPECT_EQ(toString(BigInteger(8), 8), "10");
+  EXPECT_EQ(toString(BigInteger(INT64_MIN)), "-9223372036854775808");
+  EXPECT_EQ(parseBigInteger("-9223372036854775808"), BigInteger(INT64_MIN));
+  EXPECT_EQ(parseBigInteger("DeadBeef", 16), BigInteger(0xDEADBEEF));
+  EXPECT_EQ(parseBigInteger("777", 8), BigInteger(511));
+  EXPECT_EQ(parseBigInteger("-101", 2), BigInteger(-5));
+  EXPECT_EQ(parseBigInteger("000123"), BigInteger(123));
+  EXPECT_FALSE(parseBigInteger("12a").has_value());
+  EXPECT_FALSE(parseBigInteger("-").has_value());
+  EXPECT_FALSE(parseBigInteger("1", 37).has_value());
+
+  BigInteger power = 1;
+  for (int i = 0; i < 1000; i++) {
+    power = power * 10;
+  }
+  EXPECT_EQ(toString(power), "1" + std::string(1000, '0'));
+  EXPECT_EQ(parseBigInteger("1" + std::string(1000, '0')), power);
+
+  // Large enough to take the divide-and-conquer paths in both directions
+  std::mt19937_64 generator(42);
+  for (unsigned base : {2, 3, 8, 10, 16, 36}) {
+    const BigInteger value = randomBigInteger(generator, 300);
+    const std::string digits = toString(value, base);
+    EXPECT_EQ(digits, toStringSlowly(value, base)) << "base " << base;
+    EXPECT_EQ(parseBigInteger(digits, base), value) << "base " << base;
+  }
+
+  const BigInteger huge = randomBigInteger(generator, 3000, false);
+  EXPECT_EQ(parseBigInteger(toString(huge)), huge);
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(BigIntegerTest, DISABLED_Benchmark) {
+  std::mt19937_64 generator(42);
+  using Clock = std::chrono::steady_clock;
+
+  std::print("multiplication, microseconds per product\n{:>8}", "limbs");
+  const std::vector<std::size_t> thresholds = {8, 16, 32, 64, 128, SIZE_MAX};
+  for (std::size_t threshold : thresholds) {
+    std::print(" {:>10}", threshold == SIZE_MAX ? std::string("schoolbook")
+                                                : std::to_string(threshold));
+  }
+  std::print("\n");
+  for (std::size_t numLimbs : {64, 256, 1024, 4096}) {
+    const BigInteger a = randomBigInteger(generator, numLimbs, false);
+    const BigInteger b = randomBigInteger(generator, numLimbs, false);
+    std::print("{:>8}", numLimbs);
+    for (std::size_t threshold : thresholds) {
+      const int repetitions = static_cast<int>(std::max<std::size_t>(
+          1, 4'000'000 / (numLimbs * numLimbs)));
+      auto start = Clock::now();
+      for (int r = 0; r < repetitions; r++) {
+        auto product = multiply(a, b, threshold);
+      }
+      std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+      std::print(" {:>10.1f}", elapsed.count() / repetitions);
+    }
+    std::print("\n");
+  }
+
+  for (std::size_t numLimbs : {256, 1024, 4096}) {
+    const BigInteger numerator = randomBigInteger(generator, 2 * numLimbs);
+    const BigInteger denominator = randomBigInteger(generator, numLimbs);
+    auto start = Clock::now();
+    auto division = divide(numerator, denominator);
+    std::chrono::duration<double, std::milli> divideElapsed =
+        Clock::now() - start;
+
+    start = Clock::now();
+    const std::string digits = toString(numerator);
+    std::chrono::duration<double, std::milli> formatElapsed =
+        Clock::now() - start;
+
+    start = Clock::now();
+    auto parsed = parseBigInteger(digits);
+    std::chrono::duration<double, std::milli> parseElapsed =
+        Clock::now() - start;
+
+    std::print("{} by {} limbs: divide {:.2f} ms; {} decimal digits: "
+               "format {:.2f} ms, parse {:.2f} ms\n",
+               2 * numLimbs, numLimbs, divideElapsed.count(), digits.size(),
+               formatElapsed.count(), parseElapsed.count());
+  }
+}
+} // namespace SCO
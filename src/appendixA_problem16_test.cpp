@@ -1,3 +1,8 @@
+#include <chrono>
+#include <cstdint>
+#include <print>
+#include <random>
+
 #include "appendixA_problem16.hpp"
 #include "gtest/gtest.h"
 
@@ -123,4 +128,206 @@ TEST(BinarySumTest, EightBitOverflow) {
   EXPECT_TRUE(result.overflow);
 }
 
-} // namespace SCO
\ No newline at end of file
+namespace {
+std::string toBitString(std::int64_t value, std::size_t numBits) {
+  std::string bits(numBits, '0');
+  for (std::size_t i = 0; i < numBits; i++) {
+    bits[numBits - 1 - i] = static_cast<char>('0' + ((value >> i) & 1));
+  }
+  return bits;
+}
+
+bool fitsInBits(std::int64_t value, std::size_t numBits) {
+  return value >= -(std::int64_t{1} << (numBits - 1)) and
+         value < (std::int64_t{1} << (numBits - 1));
+}
+} // namespace
+
+TEST(PackedBitsTest, RoundTrip) {
+  std::mt19937_64 generator(40);
+  for (std::size_t numBits : {0, 1, 63, 64, 65, 200}) {
+    std::string bits(numBits, '0');
+    for (auto &c : bits) {
+      c = static_cast<char>('0' + (generator() & 1));
+    }
+
+    auto packed = packBits(bits);
+    ASSERT_TRUE(packed.has_value());
+    EXPECT_EQ(packed->limbs.size(), (numBits + 63) / 64);
+    EXPECT_EQ(unpackBits(*packed), bits);
+  }
+
+  EXPECT_FALSE(packBits("0102").has_value());
+}
+
+TEST(PackedBitsTest, MatchesSignedArithmetic) {
+  std::mt19937_64 generator(40);
+  for (std::size_t numBits : {2, 4, 8, 31, 32, 33, 62}) {
+    for (int sample = 0; sample < 200; sample++) {
+      const std::int64_t range = std::int64_t{1} << (numBits - 1);
+      const std::int64_t a =
+          static_cast<std::int64_t>(generator() % (2 * range)) - range;
+      const std::int64_t b =
+          static_cast<std::int64_t>(generator() % (2 * range)) - range;
+
+      auto packedA = packBits(toBitString(a, numBits));
+      auto packedB = packBits(toBitString(b, numBits));
+      ASSERT_TRUE(packedA and packedB);
+
+      auto sum = binarySum(*packedA, *packedB);
+      ASSERT_TRUE(sum.has_value());
+      EXPECT_EQ(unpackBits(sum->sum), toBitString(a + b, numBits));
+      EXPECT_EQ(sum->overflow, not fitsInBits(a + b, numBits));
+
+      auto difference = binaryDifference(*packedA, *packedB);
+      ASSERT_TRUE(difference.has_value());
+      EXPECT_EQ(unpackBits(difference->sum), toBitString(a - b, numBits));
+      EXPECT_EQ(difference->overflow, not fitsInBits(a - b, numBits));
+
+      auto result = binarySum(toBitString(a, numBits), toBitString(b, numBits));
+      EXPECT_EQ(result.sum, toBitString(a + b, numBits));
+      EXPECT_EQ(result.overflow, sum->overflow);
+    }
+  }
+}
+
+TEST(PackedBitsTest, CarryPropagatesAcrossLimbs) {
+  // 0111...1 + 1 over 130 bits carries through two full limbs and overflows
+  auto packedA = packBits("0" + std::string(129, '1'));
+  auto packedB = packBits(std::string(129, '0') + "1");
+  ASSERT_TRUE(packedA and packedB);
+
+  auto sum = binarySum(*packedA, *packedB);
+  ASSERT_TRUE(sum.has_value());
+  EXPECT_EQ(unpackBits(sum->sum), "1" + std::string(129, '0'));
+  EXPECT_TRUE(sum->overflow);
+
+  auto difference = binaryDifference(sum->sum, *packedB);
+  ASSERT_TRUE(difference.has_value());
+  EXPECT_EQ(unpackBits(difference->sum), "0" + std::string(129, '1'));
+  EXPECT_TRUE(difference->overflow);
+
+  EXPECT_FALSE(binarySum(*packedA, *packBits("01")).has_value());
+}
+
+TEST(PackedBitsTest, BitWordConversion) {
+  // Every byte pattern through the multiply-gather and the spread
+  for (std::uint64_t byte = 0; byte < 256; byte++) {
+    const std::string bits = toBitString(static_cast<std::int64_t>(byte), 8);
+    EXPECT_EQ(parseBitWord(bits), byte) << bits;
+
+    std::string formatted(8, ' ');
+    formatBitWord(byte, formatted);
+    EXPECT_EQ(formatted, bits);
+  }
+
+  std::mt19937_64 generator(41);
+  for (std::size_t length = 0; length <= 64; length++) {
+    const std::uint64_t word =
+        length == 64 ? generator()
+                     : generator() & ((std::uint64_t{1} << length) - 1);
+    std::string formatted(length, ' ');
+    formatBitWord(word, formatted);
+    EXPECT_EQ(parseBitWord(formatted), word) << formatted;
+
+    // A bad character is caught wherever it is
+    for (std::size_t i = 0; i < length; i++) {
+      for (char bad : {'2', '/', 'a', '\0', '\x80', '\xB1'}) {
+        std::string corrupted = formatted;
+        corrupted[i] = bad;
+        EXPECT_FALSE(parseBitWord(corrupted).has_value()) << corrupted;
+      }
+    }
+  }
+
+  EXPECT_FALSE(parseBitWord(std::string(65, '0')).has_value());
+}
+
+TEST(PackedBitsTest, StringViewInput) {
+  const std::string text = "x0110y";
+  auto packed = packBits(std::string_view(text).substr(1, 4));
+  ASSERT_TRUE(packed.has_value());
+  EXPECT_EQ(packed->limbs[0], 0b0110);
+  EXPECT_FALSE(packBits(std::string(100, '1') + "2").has_value());
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(PackedBitsTest, DISABLED_ConversionBenchmark) {
+  constexpr std::size_t numBits = 64'000'000;
+  std::mt19937_64 generator(41);
+  std::string bits(numBits, '0');
+  for (auto &c : bits) {
+    c = static_cast<char>('0' + (generator() & 1));
+  }
+
+  // Character at a time, as packBits used to
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::uint64_t> limbs((numBits + 63) / 64);
+  for (std::size_t i = 0; i < numBits; i++) {
+    limbs[i / 64] |= std::uint64_t(bits[numBits - 1 - i] - '0') << (i % 64);
+  }
+  std::chrono::duration<double> characterElapsed =
+      std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  auto packed = packBits(bits);
+  std::chrono::duration<double> packElapsed =
+      std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(packed->limbs, limbs);
+
+  start = std::chrono::steady_clock::now();
+  auto unpacked = unpackBits(*packed);
+  std::chrono::duration<double> unpackElapsed =
+      std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(unpacked, bits);
+
+  std::print("parse: characters {:.2f} GB/s, packBits {:.2f} GB/s; "
+             "unpackBits {:.2f} GB/s\n",
+             numBits / characterElapsed.count() / 1e9,
+             numBits / packElapsed.count() / 1e9,
+             numBits / unpackElapsed.count() / 1e9);
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(PackedBitsTest, DISABLED_Benchmark) {
+  constexpr std::size_t numBits = 1'000'000;
+  std::mt19937_64 generator(40);
+  std::string numA(numBits, '0');
+  std::string numB(numBits, '0');
+  for (std::size_t i = 0; i < numBits; i++) {
+    numA[i] = static_cast<char>('0' + (generator() & 1));
+    numB[i] = static_cast<char>('0' + (generator() & 1));
+  }
+
+  // The character-at-a-time loop binarySum used before packing
+  auto start = std::chrono::steady_clock::now();
+  int carry = 0;
+  std::string sum(numBits, 0);
+  for (int i = static_cast<int>(numBits) - 1; i >= 0; i--) {
+    int bitSum = (numA[i] - '0') + (numB[i] - '0') + carry;
+    sum[i] = (bitSum % 2) + '0';
+    carry = bitSum / 2;
+  }
+  std::chrono::duration<double, std::micro> characterElapsed =
+      std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  auto result = binarySum(numA, numB);
+  std::chrono::duration<double, std::micro> adapterElapsed =
+      std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(result.sum, sum);
+
+  auto packedA = packBits(numA);
+  auto packedB = packBits(numB);
+  start = std::chrono::steady_clock::now();
+  auto packedSum = binarySum(*packedA, *packedB);
+  auto packedDifference = binaryDifference(*packedA, *packedB);
+  std::chrono::duration<double, std::micro> packedElapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::print("{} bits: characters {:.0f} us, string adapter {:.0f} us, "
+             "packed add+subtract {:.0f} us\n",
+             numBits, characterElapsed.count(), adapterElapsed.count(),
+             packedElapsed.count());
+}
+} // namespace SCO
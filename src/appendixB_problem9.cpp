@@ -1,27 +1,32 @@
 #include <bit>
 #include <print>
 
+#include "appendixA_problem16.hpp"
 #include "appendixB_problem9.hpp"
+#include "appendixB_problem9_format.hpp"
+#include "appendixB_problem9_softfloat.hpp"
 
 namespace SCO {
 IEEE754Float unpack(float packed) {
   auto bits = std::bit_cast<uint32_t>(packed);
-  return IEEE754Float{.sign = (bits >> 31) & 0x1,
-                      .exponent = (bits >> 23) & 0xFF,
-                      .significand = (bits) & 0x7FFFFF};
+  return IEEE754Float{
+      .sign = bits >> (Binary32::totalBits - 1),
+      .exponent = (bits & Binary32::exponentMask) >> Binary32::fractionBits,
+      .significand = bits & Binary32::fractionMask};
 }
 
 float pack(IEEE754Float unpacked) {
-  return std::bit_cast<float>((unpacked.sign << 31) |
-                              ((unpacked.exponent & 0xFF) << 23) |
-                              (unpacked.significand & 0x7FFFFF));
+  return std::bit_cast<float>(
+      (unpacked.sign << (Binary32::totalBits - 1)) |
+      ((unpacked.exponent << Binary32::fractionBits) & Binary32::exponentMask) |
+      (unpacked.significand & Binary32::fractionMask));
 }
 
 float sum(float numA, float numB) {
+#if SCO_TRACE_SUM
   // 1. Extract sign, exponent, significand from both numbers
   IEEE754Float rawNumA = unpack(numA);
   IEEE754Float rawNumB = unpack(numB);
-  IEEE754Float result;
 
   std::println(
       "================================================================");
@@ -32,73 +37,41 @@ float sum(float numA, float numB) {
   std::println(
       "    numB: value={}, sign={:b}, exponent={:08b}, significand={:023b}",
       numB, rawNumB.sign, rawNumB.exponent, rawNumB.significand);
+#endif
 
-  if (std::bit_cast<std::uint32_t>(numA) == 0x0) {
-    return numB;
-  }
+  // 2. Align, add, normalize and round to nearest even
+  FloatEnvironment environment;
+  float packed = std::bit_cast<float>(
+      softFloatAdd(std::bit_cast<std::uint32_t>(numA),
+                   std::bit_cast<std::uint32_t>(numB), environment));
 
-  if (std::bit_cast<std::uint32_t>(numB) == 0x0) {
-    return numA;
-  }
+#if SCO_TRACE_SUM
+  IEEE754Float result = unpack(packed);
+  std::println(
+      "    Result: value={}, sign={:b}, exponent={:08b}, significand={:023b}",
+      packed, result.sign, result.exponent, result.significand);
+#endif
 
-  // 2. Align exponents → shift smaller number right until exponents match
-  rawNumB.significand = rawNumB.significand | (1 << 23);
-  rawNumA.significand = rawNumA.significand | (1 << 23);
-  if (rawNumA.exponent > rawNumB.exponent) {
-    while (rawNumA.exponent != rawNumB.exponent) {
-      rawNumB.significand >>= 1;
-      rawNumB.exponent++;
-    }
-  } else {
-    while (rawNumA.exponent != rawNumB.exponent) {
-      rawNumA.significand >>= 1;
-      rawNumA.exponent++;
-    }
-  }
+  return packed;
+}
 
-  result.exponent = rawNumA.exponent; // Both exponents are now the same
+std::string toBitString(float num) {
+  std::string bits(32, '0');
+  formatBitWord(std::bit_cast<std::uint32_t>(num), bits);
+  return bits;
+}
 
-  // 3. Add (or subtract) significands
-  if (rawNumA.sign == rawNumB.sign) {
-    result.significand = rawNumA.significand + rawNumB.significand;
-    result.sign = rawNumA.sign; // Both signs are the same
-  } else {
-    if (rawNumA.significand >= rawNumB.significand) {
-      result.significand = rawNumA.significand - rawNumB.significand;
-      result.sign = rawNumA.sign;
-    } else {
-      result.significand = rawNumB.significand - rawNumA.significand;
-      result.sign = rawNumB.sign;
-    }
+std::optional<float> fromBitString(std::string_view bits) {
+  if (bits.size() != 32) {
+    std::print("A float has 32 bits, got {}\n", bits.size());
+    return std::nullopt;
   }
 
-  // 4. Renormalize result → shift until form is 1.something
-  if (result.significand) {
-    if (result.significand & (1 << 24)) { // If we have a carry bit, shift right
-      result.significand >>= 1;
-      result.exponent++;
-    } else {
-      while (not(result.significand & (1 << 23))) {
-        result.significand <<= 1;
-        result.exponent--;
-      }
-    }
-
-    // Remove the implicit leading 1 bit
-    result.significand = result.significand & 0x7FFFFF;
-  } else {
-    result.exponent = 0;
-    result.sign = 0; // Sign of zero is positive
+  auto word = parseBitWord(bits);
+  if (not word) {
+    std::print("Invalid character in bit string '{}'\n", bits);
+    return std::nullopt;
   }
-
-  // 5. Pack back into IEEE format
-  float packed = pack(result);
-
-  std::println(
-      "    Result: value={}, sign={:b}, exponent={:08b}, significand={:023b}",
-      packed, result.sign, result.exponent, result.significand);
-
-  // 7. Check for overflow/underflow
-  return packed;
+  return std::bit_cast<float>(static_cast<std::uint32_t>(*word));
 }
 } // namespace SCO
@@ -1,6 +1,15 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// sum() prints every step unless built with SCO_TRACE_SUM=0, which the
+// verification harness needs to get through billions of additions
+#ifndef SCO_TRACE_SUM
+#define SCO_TRACE_SUM 1
+#endif
 
 namespace SCO {
 struct IEEE754Float {
@@ -11,4 +20,8 @@ struct IEEE754Float {
 
 IEEE754Float extract(float num);
 float sum(float numA, float numB);
+
+// The 32 bits of a float as '0'/'1' text, sign bit first, and back
+std::string toBitString(float num);
+std::optional<float> fromBitString(std::string_view bits);
 } // namespace SCO
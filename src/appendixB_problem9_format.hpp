@@ -0,0 +1,453 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <print>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "appendixB_problem9_softfloat.hpp"
+
+namespace SCO {
+enum class FloatEncoding : std::uint8_t {
+  // Infinities at the top exponent field, NaNs with any nonzero fraction
+  IEEE = 0,
+  // No infinities; the top exponent field holds finite values too and only
+  // an all-ones fraction there is NaN, like the FP8 E4M3 of the OCP spec
+  FiniteOnly,
+};
+
+// Soft-float arithmetic for any binary interchange format with up to 11
+// exponent and 52 fraction bits, on bit patterns in the smallest unsigned
+// type that holds them. Results are correctly rounded in every RoundingMode,
+// with the NaN and tininess conventions of softFloatAdd. Overflow in
+// FiniteOnly formats gives NaN where IEEE formats give infinity.
+//
+// Internally a finite value is a 128-bit significand with its leading one
+// at bit 126: value = significand / 2^126 * 2^exponent. That is wide enough
+// for an exact binary64 product.
+template <int ExponentBits, int FractionBits,
+          FloatEncoding Encoding = FloatEncoding::IEEE>
+struct SoftFloat {
+  static_assert(ExponentBits >= 2 and ExponentBits <= 11);
+  static_assert(FractionBits >= 1 and FractionBits <= 52);
+
+  static constexpr int exponentBits = ExponentBits;
+  static constexpr int fractionBits = FractionBits;
+  static constexpr int totalBits = 1 + ExponentBits + FractionBits;
+  static constexpr FloatEncoding encoding = Encoding;
+
+  using Bits = std::conditional_t<
+      totalBits <= 8, std::uint8_t,
+      std::conditional_t<
+          totalBits <= 16, std::uint16_t,
+          std::conditional_t<totalBits <= 32, std::uint32_t, std::uint64_t>>>;
+  using UInt128 = unsigned __int128;
+
+  static constexpr Bits signMask =
+      static_cast<Bits>(std::uint64_t{1} << (totalBits - 1));
+  static constexpr Bits exponentMask = static_cast<Bits>(
+      ((std::uint64_t{1} << ExponentBits) - 1) << FractionBits);
+  static constexpr Bits fractionMask =
+      static_cast<Bits>((std::uint64_t{1} << FractionBits) - 1);
+  static constexpr Bits quietBit =
+      static_cast<Bits>(std::uint64_t{1} << (FractionBits - 1));
+  static constexpr int bias = (1 << (ExponentBits - 1)) - 1;
+  static constexpr int maxExponentField = (1 << ExponentBits) - 1;
+
+  static constexpr Bits quietNaN =
+      Encoding == FloatEncoding::IEEE ? exponentMask | quietBit
+                                      : exponentMask | fractionMask;
+  // The NaN invalid operations return: negative and quiet, like x86
+  static constexpr Bits defaultNaN = signMask | quietNaN;
+  // What overflow and division by zero return, before the sign
+  static constexpr Bits infinity =
+      Encoding == FloatEncoding::IEEE ? exponentMask : quietNaN;
+  static constexpr Bits maxFinite =
+      Encoding == FloatEncoding::IEEE ? exponentMask - 1
+                                      : exponentMask | (fractionMask - 1);
+
+  static constexpr bool isNaN(Bits a) {
+    if constexpr (Encoding == FloatEncoding::IEEE) {
+      return (a & exponentMask) == exponentMask and (a & fractionMask) != 0;
+    } else {
+      return (a & ~signMask) == quietNaN;
+    }
+  }
+  static constexpr bool isSignalingNaN(Bits a) {
+    return Encoding == FloatEncoding::IEEE and isNaN(a) and
+           (a & quietBit) == 0;
+  }
+  static constexpr bool isInfinity(Bits a) {
+    return Encoding == FloatEncoding::IEEE and
+           (a & ~signMask) == exponentMask;
+  }
+  static constexpr bool isZero(Bits a) { return (a & ~signMask) == 0; }
+
+  static Bits add(Bits a, Bits b, FloatEnvironment &environment) {
+    return addSigned(a, b, false, environment);
+  }
+
+  static Bits subtract(Bits a, Bits b, FloatEnvironment &environment) {
+    return addSigned(a, b, true, environment);
+  }
+
+  static Bits multiply(Bits a, Bits b, FloatEnvironment &environment) {
+    if (isNaN(a) or isNaN(b)) {
+      return propagateNaN(a, b, environment);
+    }
+    const bool sign = (a ^ b) & signMask;
+    const Bits signBit = sign ? signMask : 0;
+    if (isInfinity(a) or isInfinity(b)) {
+      if (isZero(a) or isZero(b)) {
+        environment.flags |= FloatInvalid;
+        return defaultNaN;
+      }
+      return signBit | infinity;
+    }
+    if (isZero(a) or isZero(b)) {
+      return signBit;
+    }
+
+    int exponentA;
+    int exponentB;
+    const UInt128 product =
+        UInt128{unpack(a, exponentA)} * unpack(b, exponentB);
+    const int shift = countLeadingZeros(product) - 1;
+    return roundAndPack(sign,
+                        exponentA + exponentB + 126 - 2 * FractionBits - shift,
+                        product << shift, environment);
+  }
+
+  static Bits divide(Bits a, Bits b, FloatEnvironment &environment) {
+    if (isNaN(a) or isNaN(b)) {
+      return propagateNaN(a, b, environment);
+    }
+    const bool sign = (a ^ b) & signMask;
+    const Bits signBit = sign ? signMask : 0;
+    if (isInfinity(a)) {
+      if (isInfinity(b)) {
+        environment.flags |= FloatInvalid;
+        return defaultNaN;
+      }
+      return signBit | infinity;
+    }
+    if (isInfinity(b)) {
+      return signBit;
+    }
+    if (isZero(b)) {
+      if (isZero(a)) {
+        environment.flags |= FloatInvalid;
+        return defaultNaN;
+      }
+      environment.flags |= FloatDivideByZero;
+      return signBit | infinity;
+    }
+    if (isZero(a)) {
+      return signBit;
+    }
+
+    // The quotient gets at least 72 bits, far more than rounding needs,
+    // and a sticky bit for a nonzero remainder
+    int exponentA;
+    int exponentB;
+    const UInt128 dividend = UInt128{unpack(a, exponentA)}
+                             << (125 - FractionBits);
+    const std::uint64_t divisor = unpack(b, exponentB);
+    const UInt128 quotient =
+        (dividend / divisor) | UInt128{dividend % divisor != 0};
+    const int shift = countLeadingZeros(quotient) - 1;
+    return roundAndPack(sign, exponentA - exponentB + 1 + FractionBits - shift,
+                        quotient << shift, environment);
+  }
+
+  static Bits squareRoot(Bits a, FloatEnvironment &environment) {
+    if (isNaN(a)) {
+      return propagateNaN(a, a, environment);
+    }
+    if (isZero(a) or (isInfinity(a) and not(a & signMask))) {
+      return a;
+    }
+    if (a & signMask) {
+      environment.flags |= FloatInvalid;
+      return defaultNaN;
+    }
+
+    // Halve an even exponent; the radicand significand * 2^(124 - F) has an
+    // even scale 2^124 whatever the parity of F, and a 62-bit root
+    int exponent;
+    std::uint64_t significand = unpack(a, exponent);
+    if (exponent % 2 != 0) {
+      significand <<= 1;
+      exponent--;
+    }
+    UInt128 remainder = UInt128{significand} << (124 - FractionBits);
+    UInt128 root = 0;
+    for (UInt128 bit = UInt128{1} << 126; bit != 0; bit >>= 2) {
+      if (remainder >= root + bit) {
+        remainder -= root + bit;
+        root = (root >> 1) + bit;
+      } else {
+        root >>= 1;
+      }
+    }
+
+    root |= remainder != 0;
+    const int shift = countLeadingZeros(root) - 1;
+    return roundAndPack(false, exponent / 2 + 64 - shift, root << shift,
+                        environment);
+  }
+
+  // Significand of a finite nonzero value with its leading one at bit
+  // FractionBits, and the unbiased exponent: value = significand /
+  // 2^FractionBits * 2^exponent. Subnormals come out normalized.
+  static std::uint64_t unpack(Bits a, int &exponent) {
+    const int field = static_cast<int>((a & exponentMask) >> FractionBits);
+    std::uint64_t significand = a & fractionMask;
+    if (field == 0) {
+      const int shift = std::countl_zero(significand) - (63 - FractionBits);
+      exponent = 1 - bias - shift;
+      return significand << shift;
+    }
+    exponent = field - bias;
+    return significand | (std::uint64_t{1} << FractionBits);
+  }
+
+  // Rounds a significand with its leading one at bit 126 to the format.
+  // Tininess is detected after rounding.
+  static Bits roundAndPack(bool sign, int exponent, UInt128 significand,
+                           FloatEnvironment &environment) {
+    constexpr int restBits = 126 - FractionBits;
+    constexpr UInt128 restMask = (UInt128{1} << restBits) - 1;
+    constexpr std::uint64_t carry = std::uint64_t{2} << FractionBits;
+    const Bits signBit = sign ? signMask : 0;
+
+    int field = exponent + bias;
+    bool tiny = false;
+    if (field < 1) {
+      // Tiny if rounding with an unbounded exponent stays below the
+      // smallest normal
+      const auto kept = static_cast<std::uint64_t>(significand >> restBits);
+      tiny = field < 0 or not(roundsUp(sign, kept, significand & restMask,
+                                       environment.rounding) and
+                              kept + 1 == carry);
+      significand = shiftRightJam(significand, 1 - field);
+      field = 1;
+    }
+
+    auto kept = static_cast<std::uint64_t>(significand >> restBits);
+    const UInt128 rest = significand & restMask;
+    if (rest != 0) {
+      environment.flags |= FloatInexact;
+      if (tiny) {
+        environment.flags |= FloatUnderflow;
+      }
+    }
+    if (roundsUp(sign, kept, rest, environment.rounding)) {
+      kept++;
+      if (kept == carry) {
+        kept >>= 1;
+        field++;
+      }
+    }
+
+    const bool overflow =
+        Encoding == FloatEncoding::IEEE
+            ? field >= maxExponentField
+            : field > maxExponentField or
+                  (field == maxExponentField and
+                   (kept & fractionMask) == fractionMask);
+    if (overflow) {
+      environment.flags |= FloatOverflow | FloatInexact;
+      const bool toInfinity =
+          environment.rounding == RoundingMode::NearestEven or
+          environment.rounding == RoundingMode::NearestAway or
+          (environment.rounding == RoundingMode::Upward and not sign) or
+          (environment.rounding == RoundingMode::Downward and sign);
+      return signBit | (toInfinity ? infinity : maxFinite);
+    }
+
+    // Subnormal results keep field 1 without the implicit bit, which
+    // encodes as field 0
+    const std::uint64_t exponentField = kept >> FractionBits ? field : 0;
+    return signBit | static_cast<Bits>((exponentField << FractionBits) |
+                                       (kept & fractionMask));
+  }
+
+  static int countLeadingZeros(UInt128 x) {
+    const auto high = static_cast<std::uint64_t>(x >> 64);
+    return high != 0 ? std::countl_zero(high)
+                     : 64 + std::countl_zero(static_cast<std::uint64_t>(x));
+  }
+
+  // Shifts right, ORing every bit shifted out into bit 0
+  static UInt128 shiftRightJam(UInt128 x, int shift) {
+    if (shift >= 127) {
+      return x != 0;
+    }
+    return (x >> shift) | UInt128{(x & ((UInt128{1} << shift) - 1)) != 0};
+  }
+
+private:
+  static bool roundsUp(bool sign, std::uint64_t kept, UInt128 rest,
+                       RoundingMode rounding) {
+    constexpr UInt128 halfway = UInt128{1} << (125 - FractionBits);
+    switch (rounding) {
+    case RoundingMode::NearestEven:
+      return rest > halfway or (rest == halfway and (kept & 1));
+    case RoundingMode::NearestAway:
+      return rest >= halfway;
+    case RoundingMode::TowardZero:
+      return false;
+    case RoundingMode::Upward:
+      return rest != 0 and not sign;
+    case RoundingMode::Downward:
+      return rest != 0 and sign;
+    }
+    return false;
+  }
+
+  static Bits propagateNaN(Bits a, Bits b, FloatEnvironment &environment) {
+    if (isSignalingNaN(a) or isSignalingNaN(b)) {
+      environment.flags |= FloatInvalid;
+    }
+    return (isNaN(a) ? a : b) | quietBit;
+  }
+
+  static Bits addSigned(Bits a, Bits b, bool negateB,
+                        FloatEnvironment &environment) {
+    if (isNaN(a) or isNaN(b)) {
+      return propagateNaN(a, b, environment);
+    }
+    if (negateB) {
+      b ^= signMask;
+    }
+
+    const bool signA = a & signMask;
+    const bool signB = b & signMask;
+    if (isInfinity(a) or isInfinity(b)) {
+      if (isInfinity(a) and isInfinity(b) and signA != signB) {
+        environment.flags |= FloatInvalid;
+        return defaultNaN;
+      }
+      return isInfinity(a) ? a : b;
+    }
+    if (isZero(a) or isZero(b)) {
+      if (not isZero(a) or not isZero(b)) {
+        return isZero(a) ? b : a;
+      }
+      const bool negativeZero =
+          signA == signB ? signA
+                         : environment.rounding == RoundingMode::Downward;
+      return negativeZero ? signMask : 0;
+    }
+
+    // Leading ones at bit 125 leave a bit of headroom for the carry
+    int exponentA;
+    int exponentB;
+    UInt128 sigA = UInt128{unpack(a, exponentA)} << (125 - FractionBits);
+    UInt128 sigB = UInt128{unpack(b, exponentB)} << (125 - FractionBits);
+    bool sign = signA;
+    if (exponentA < exponentB or (exponentA == exponentB and sigA < sigB)) {
+      std::swap(exponentA, exponentB);
+      std::swap(sigA, sigB);
+      sign = signB;
+    }
+    sigB = shiftRightJam(sigB, exponentA - exponentB);
+    const UInt128 result = signA == signB ? sigA + sigB : sigA - sigB;
+    if (result == 0) {
+      return environment.rounding == RoundingMode::Downward ? signMask : 0;
+    }
+
+    const int shift = countLeadingZeros(result) - 1;
+    return roundAndPack(sign, exponentA + 1 - shift, result << shift,
+                        environment);
+  }
+};
+
+using Binary16 = SoftFloat<5, 10>;
+using BFloat16 = SoftFloat<8, 7>;
+using Binary32 = SoftFloat<8, 23>;
+using Binary64 = SoftFloat<11, 52>;
+using Float8E5M2 = SoftFloat<5, 2>;
+using Float8E4M3 = SoftFloat<4, 3, FloatEncoding::FiniteOnly>;
+
+// Converts between formats, rounding when narrowing. NaN payloads keep
+// their top fraction bits like x86 conversions; NaNs from or to a
+// FiniteOnly format are the canonical NaN, and infinity converts to it with
+// FloatInvalid.
+template <typename To, typename From>
+typename To::Bits convertFloat(typename From::Bits a,
+                               FloatEnvironment &environment) {
+  using ToBits = typename To::Bits;
+  constexpr int fractionShift = To::fractionBits - From::fractionBits;
+  const ToBits signBit = (a & From::signMask) ? To::signMask : 0;
+
+  // Normal values convert exactly into a format at least as wide in both
+  // fields: rebias the exponent, widen the fraction
+  if constexpr (fractionShift >= 0 and To::bias >= From::bias and
+                To::maxExponentField - To::bias >=
+                    From::maxExponentField - From::bias) {
+    const auto field = (a & From::exponentMask) >> From::fractionBits;
+    if (field != 0 and field != From::maxExponentField) {
+      const auto fraction =
+          static_cast<ToBits>(a & From::fractionMask) << fractionShift;
+      return signBit |
+             static_cast<ToBits>(
+                 (static_cast<ToBits>(field + To::bias - From::bias)
+                  << To::fractionBits) |
+                 fraction);
+    }
+  }
+
+  if (From::isNaN(a)) {
+    if (From::isSignalingNaN(a)) {
+      environment.flags |= FloatInvalid;
+    }
+    if constexpr (From::encoding == FloatEncoding::IEEE and
+                  To::encoding == FloatEncoding::IEEE) {
+      const std::uint64_t fraction = a & From::fractionMask;
+      const std::uint64_t payload = fractionShift >= 0
+                                        ? fraction << fractionShift
+                                        : fraction >> -fractionShift;
+      return signBit | To::quietNaN |
+             static_cast<ToBits>(payload & To::fractionMask);
+    } else {
+      return signBit | To::quietNaN;
+    }
+  }
+  if (From::isInfinity(a)) {
+    if constexpr (To::encoding != FloatEncoding::IEEE) {
+      environment.flags |= FloatInvalid;
+    }
+    return signBit | To::infinity;
+  }
+  if (From::isZero(a)) {
+    return signBit;
+  }
+
+  int exponent;
+  const std::uint64_t significand = From::unpack(a, exponent);
+  return To::roundAndPack(
+      signBit != 0, exponent,
+      typename To::UInt128{significand} << (126 - From::fractionBits),
+      environment);
+}
+
+// Element-wise convertFloat; false if the spans differ in size
+template <typename To, typename From>
+bool convertFloats(std::span<const typename From::Bits> in,
+                   std::span<typename To::Bits> out,
+                   FloatEnvironment &environment) {
+  if (in.size() != out.size()) {
+    std::print("Converting {} values into space for {}\n", in.size(),
+               out.size());
+    return false;
+  }
+  for (std::size_t i = 0; i < in.size(); i++) {
+    out[i] = convertFloat<To, From>(in[i], environment);
+  }
+  return true;
+}
+} // namespace SCO
@@ -0,0 +1,364 @@
+#include <bit>
+#include <cfenv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <print>
+#include <random>
+#include <vector>
+
+#include "appendixB_problem9_format.hpp"
+#include "gtest/gtest.h"
+
+namespace SCO {
+namespace {
+constexpr std::pair<RoundingMode, int> hardwareRoundingModes[] = {
+    {RoundingMode::NearestEven, FE_TONEAREST},
+    {RoundingMode::TowardZero, FE_TOWARDZERO},
+    {RoundingMode::Upward, FE_UPWARD},
+    {RoundingMode::Downward, FE_DOWNWARD},
+};
+
+enum class Operation { Add, Subtract, Multiply, Divide, SquareRoot };
+
+constexpr Operation operations[] = {Operation::Add, Operation::Subtract,
+                                    Operation::Multiply, Operation::Divide,
+                                    Operation::SquareRoot};
+
+template <typename Format>
+typename Format::Bits soft(Operation operation, typename Format::Bits a,
+                           typename Format::Bits b,
+                           FloatEnvironment &environment) {
+  switch (operation) {
+  case Operation::Add:
+    return Format::add(a, b, environment);
+  case Operation::Subtract:
+    return Format::subtract(a, b, environment);
+  case Operation::Multiply:
+    return Format::multiply(a, b, environment);
+  case Operation::Divide:
+    return Format::divide(a, b, environment);
+  case Operation::SquareRoot:
+    return Format::squareRoot(a, environment);
+  }
+  return 0;
+}
+
+// Out of line and through volatile so the compiler neither folds the
+// operation nor moves it across fesetround
+template <typename T>
+[[gnu::noinline]] T hardware(Operation operation, T a, T b) {
+  volatile T x = a;
+  volatile T y = b;
+  volatile T result;
+  switch (operation) {
+  case Operation::Add:
+    result = x + y;
+    break;
+  case Operation::Subtract:
+    result = x - y;
+    break;
+  case Operation::Multiply:
+    result = x * y;
+    break;
+  case Operation::Divide:
+    result = x / y;
+    break;
+  case Operation::SquareRoot:
+    result = std::sqrt(static_cast<T>(x));
+    break;
+  }
+  return result;
+}
+
+std::uint8_t hardwareFlags() {
+  const int raised = std::fetestexcept(FE_ALL_EXCEPT);
+  return ((raised & FE_INVALID) ? FloatInvalid : 0) |
+         ((raised & FE_DIVBYZERO) ? FloatDivideByZero : 0) |
+         ((raised & FE_OVERFLOW) ? FloatOverflow : 0) |
+         ((raised & FE_UNDERFLOW) ? FloatUnderflow : 0) |
+         ((raised & FE_INEXACT) ? FloatInexact : 0);
+}
+
+// Random bit patterns with a bias towards specials and subnormals
+template <typename Format>
+typename Format::Bits randomOperand(std::mt19937_64 &generator) {
+  using Bits = typename Format::Bits;
+  const auto bits = static_cast<Bits>(generator());
+  switch (generator() % 8) {
+  case 0:
+    return bits & (Format::signMask | Format::exponentMask);
+  case 1:
+    return bits & (Format::signMask | Format::fractionMask);
+  case 2:
+    return bits | Format::exponentMask;
+  default:
+    return bits;
+  }
+}
+
+// Small formats against binary32 hardware: the float result has more than
+// twice their precision plus two bits, so rounding it again to the small
+// format gives the correctly rounded result in every mode
+template <typename Format>
+void expectMatchesFloatHardware(std::size_t samples) {
+  using Bits = typename Format::Bits;
+  std::mt19937_64 generator(46);
+  const int savedRounding = std::fegetround();
+  for (Operation operation : operations) {
+    for (auto [rounding, hardwareRounding] : hardwareRoundingModes) {
+      ASSERT_EQ(std::fesetround(hardwareRounding), 0);
+      std::size_t mismatches = 0;
+      for (std::size_t sample = 0; sample < samples and mismatches < 10;
+           sample++) {
+        // Exhaustive over pairs when the format is small enough
+        const Bits a = samples == 65536 ? static_cast<Bits>(sample >> 8)
+                                        : randomOperand<Format>(generator);
+        const Bits b = samples == 65536 ? static_cast<Bits>(sample)
+                                        : randomOperand<Format>(generator);
+
+        FloatEnvironment environment{rounding, 0};
+        const Bits result = soft<Format>(operation, a, b, environment);
+
+        FloatEnvironment conversion{rounding, 0};
+        const float x =
+            std::bit_cast<float>(convertFloat<Binary32, Format>(a, conversion));
+        const float y =
+            std::bit_cast<float>(convertFloat<Binary32, Format>(b, conversion));
+        const Bits expected = convertFloat<Format, Binary32>(
+            std::bit_cast<std::uint32_t>(hardware(operation, x, y)),
+            conversion);
+
+        const bool matches = Format::isNaN(expected)
+                                 ? Format::isNaN(result)
+                                 : result == expected;
+        if (not matches) {
+          mismatches++;
+          ADD_FAILURE() << std::hex << "operation "
+                        << static_cast<int>(operation) << " on " << +a
+                        << ", " << +b << " rounding "
+                        << static_cast<int>(rounding) << ": got " << +result
+                        << ", expected " << +expected;
+        }
+      }
+    }
+  }
+  std::fesetround(savedRounding);
+}
+} // namespace
+
+TEST(SoftFloatFormatTest, Masks) {
+  EXPECT_EQ(Binary16::exponentMask, 0x7C00);
+  EXPECT_EQ(Binary16::bias, 15);
+  EXPECT_EQ(BFloat16::fractionMask, 0x7F);
+  EXPECT_EQ(Binary32::exponentMask, 0x7F800000u);
+  EXPECT_EQ(Binary64::signMask, std::uint64_t{1} << 63);
+  EXPECT_EQ(Binary64::defaultNaN, 0xFFF8000000000000);
+  EXPECT_EQ(Float8E5M2::maxFinite, 0x7B);
+  EXPECT_EQ(Float8E4M3::maxFinite, 0x7E);
+  EXPECT_EQ(sizeof(Float8E4M3::Bits), 1u);
+  EXPECT_EQ(sizeof(BFloat16::Bits), 2u);
+
+  // E4M3 tops out at 448 and has no infinity
+  FloatEnvironment environment;
+  EXPECT_EQ((convertFloat<Binary32, Float8E4M3>(0x7E, environment)),
+            std::bit_cast<std::uint32_t>(448.0f));
+  EXPECT_FALSE(Float8E4M3::isInfinity(0x78));
+  EXPECT_TRUE(Float8E4M3::isNaN(0xFF));
+  EXPECT_EQ((convertFloat<Float8E4M3, Binary32>(
+                std::bit_cast<std::uint32_t>(480.0f), environment)),
+            0x7F);
+  EXPECT_EQ(environment.flags, FloatOverflow | FloatInexact);
+  environment = {RoundingMode::TowardZero, 0};
+  EXPECT_EQ((convertFloat<Float8E4M3, Binary32>(
+                std::bit_cast<std::uint32_t>(1e6f), environment)),
+            0x7E);
+  environment = {};
+  EXPECT_EQ((convertFloat<Float8E4M3, Binary32>(0x7F800000, environment)),
+            0x7F);
+  EXPECT_EQ(environment.flags, FloatInvalid);
+}
+
+TEST(SoftFloatFormatTest, Binary32MatchesSoftFloat) {
+  std::mt19937_64 generator(47);
+  for (auto [rounding, hardwareRounding] : hardwareRoundingModes) {
+    for (int sample = 0; sample < 100'000; sample++) {
+      const std::uint32_t a = randomOperand<Binary32>(generator);
+      const std::uint32_t b = randomOperand<Binary32>(generator);
+      FloatEnvironment expected{rounding, 0};
+      FloatEnvironment environment{rounding, 0};
+      ASSERT_EQ(Binary32::add(a, b, environment),
+                softFloatAdd(a, b, expected));
+      ASSERT_EQ(Binary32::subtract(a, b, environment),
+                softFloatSubtract(a, b, expected));
+      ASSERT_EQ(Binary32::multiply(a, b, environment),
+                softFloatMultiply(a, b, expected));
+      ASSERT_EQ(Binary32::divide(a, b, environment),
+                softFloatDivide(a, b, expected));
+      ASSERT_EQ(Binary32::squareRoot(a, environment),
+                softFloatSquareRoot(a, expected));
+      ASSERT_EQ(environment.flags, expected.flags) << std::hex << a << b;
+    }
+  }
+}
+
+TEST(SoftFloatFormatTest, Binary64MatchesHardware) {
+#if not(defined(__x86_64__) or defined(__i386__))
+  GTEST_SKIP() << "NaN results and tininess detection follow x86";
+#endif
+  std::mt19937_64 generator(48);
+  const int savedRounding = std::fegetround();
+  for (Operation operation : operations) {
+    for (auto [rounding, hardwareRounding] : hardwareRoundingModes) {
+      ASSERT_EQ(std::fesetround(hardwareRounding), 0);
+      std::size_t mismatches = 0;
+      for (int sample = 0; sample < 50'000 and mismatches < 10; sample++) {
+        const std::uint64_t a = randomOperand<Binary64>(generator);
+        const std::uint64_t b = randomOperand<Binary64>(generator);
+
+        std::feclearexcept(FE_ALL_EXCEPT);
+        const auto expected = std::bit_cast<std::uint64_t>(
+            hardware(operation, std::bit_cast<double>(a),
+                     std::bit_cast<double>(b)));
+        const std::uint8_t expectedFlags = hardwareFlags();
+
+        FloatEnvironment environment{rounding, 0};
+        const std::uint64_t result =
+            soft<Binary64>(operation, a, b, environment);
+        if (result != expected or environment.flags != expectedFlags) {
+          mismatches++;
+          ADD_FAILURE() << std::hex << "operation "
+                        << static_cast<int>(operation) << " on " << a << ", "
+                        << b << " rounding " << static_cast<int>(rounding)
+                        << ": got " << result << " flags "
+                        << int(environment.flags) << ", expected " << expected
+                        << " flags " << int(expectedFlags);
+        }
+      }
+    }
+  }
+  std::fesetround(savedRounding);
+}
+
+TEST(SoftFloatFormatTest, SmallFormatsMatchHardware) {
+  expectMatchesFloatHardware<Float8E4M3>(65536);
+  expectMatchesFloatHardware<Float8E5M2>(65536);
+  expectMatchesFloatHardware<Binary16>(100'000);
+  expectMatchesFloatHardware<BFloat16>(100'000);
+}
+
+TEST(SoftFloatFormatTest, Conversions) {
+#if not(defined(__x86_64__) or defined(__i386__))
+  GTEST_SKIP() << "NaN payloads and tininess detection follow x86";
+#endif
+  // Every binary16 and FP8 value widens exactly and converts back
+  FloatEnvironment environment;
+  for (std::uint32_t a = 0; a < 65536; a++) {
+    const auto half = static_cast<std::uint16_t>(a);
+    const auto wide = convertFloat<Binary64, Binary16>(half, environment);
+    EXPECT_EQ((convertFloat<Binary16, Binary64>(wide, environment)),
+              Binary16::isSignalingNaN(half) ? half | Binary16::quietBit
+                                             : half);
+    if (a < 256) {
+      const auto e4m3 = static_cast<std::uint8_t>(a);
+      EXPECT_EQ((convertFloat<Float8E4M3, Binary16>(
+                    convertFloat<Binary16, Float8E4M3>(e4m3, environment),
+                    environment)),
+                e4m3);
+    }
+  }
+
+  // Narrowing binary64 to binary32 against cvtsd2ss in every mode
+  std::mt19937_64 generator(49);
+  const int savedRounding = std::fegetround();
+  for (auto [rounding, hardwareRounding] : hardwareRoundingModes) {
+    ASSERT_EQ(std::fesetround(hardwareRounding), 0);
+    std::size_t mismatches = 0;
+    for (int sample = 0; sample < 100'000 and mismatches < 10; sample++) {
+      // Exponents near binary32's range
+      std::uint64_t a = generator();
+      if (sample % 2 == 0) {
+        a = (a & 0x800FFFFFFFFFFFFF) |
+            ((std::uint64_t{1023 - 160} + generator() % 320) << 52);
+      }
+
+      std::feclearexcept(FE_ALL_EXCEPT);
+      volatile double x = std::bit_cast<double>(a);
+      volatile float narrowed = static_cast<float>(x);
+      const auto expected =
+          std::bit_cast<std::uint32_t>(static_cast<float>(narrowed));
+      const std::uint8_t expectedFlags = hardwareFlags();
+
+      FloatEnvironment narrowing{rounding, 0};
+      const auto result = convertFloat<Binary32, Binary64>(a, narrowing);
+      if (result != expected or narrowing.flags != expectedFlags) {
+        mismatches++;
+        ADD_FAILURE() << std::hex << a << " rounding "
+                      << static_cast<int>(rounding) << ": got " << result
+                      << " flags " << int(narrowing.flags) << ", expected "
+                      << expected << " flags " << int(expectedFlags);
+      }
+    }
+  }
+  std::fesetround(savedRounding);
+
+  std::vector<std::uint16_t> halves = {0x3C00, 0xFC00, 0x0001};
+  std::vector<std::uint32_t> floats(3);
+  ASSERT_TRUE((convertFloats<Binary32, Binary16>(halves, floats, environment)));
+  EXPECT_EQ(floats, (std::vector<std::uint32_t>{0x3F800000, 0xFF800000,
+                                                0x33800000}));
+  EXPECT_FALSE((convertFloats<Binary32, Binary16>(
+      halves, std::span(floats).first(2), environment)));
+}
+
+namespace {
+template <typename Format>
+void benchmarkFormat(const char *name, std::mt19937_64 &generator) {
+  using Clock = std::chrono::steady_clock;
+  using Bits = typename Format::Bits;
+  constexpr std::size_t size = 1 << 20;
+  std::vector<Bits> a(size);
+  std::vector<Bits> b(size);
+  std::vector<Bits> out(size);
+  std::vector<std::uint32_t> widened(size);
+  for (std::size_t i = 0; i < size; i++) {
+    a[i] = static_cast<Bits>(generator());
+    b[i] = static_cast<Bits>(generator());
+  }
+
+  FloatEnvironment environment;
+  std::print("{:>10}", name);
+  for (Operation operation : operations) {
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < size; i++) {
+      out[i] = soft<Format>(operation, a[i], b[i], environment);
+    }
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    std::print(" {:>9.1f}", size / elapsed.count());
+  }
+
+  auto start = Clock::now();
+  convertFloats<Binary32, Format>(a, widened, environment);
+  std::chrono::duration<double, std::micro> widen = Clock::now() - start;
+  start = Clock::now();
+  convertFloats<Format, Binary32>(widened, out, environment);
+  std::chrono::duration<double, std::micro> narrow = Clock::now() - start;
+  std::print(" {:>9.1f} {:>9.1f}\n", size / widen.count(),
+             size / narrow.count());
+}
+} // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SoftFloatFormatTest, DISABLED_Benchmark) {
+  std::mt19937_64 generator(50);
+  std::print("{:>10} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9}\n", "Mops/s",
+             "add", "subtract", "multiply", "divide", "sqrt", "to f32",
+             "from f32");
+  benchmarkFormat<Float8E4M3>("E4M3", generator);
+  benchmarkFormat<Float8E5M2>("E5M2", generator);
+  benchmarkFormat<Binary16>("binary16", generator);
+  benchmarkFormat<BFloat16>("bfloat16", generator);
+  benchmarkFormat<Binary32>("binary32", generator);
+  benchmarkFormat<Binary64>("binary64", generator);
+}
+} // namespace SCO
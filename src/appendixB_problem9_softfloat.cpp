@@ -0,0 +1,1242 @@
+#include "appendixB_problem9_softfloat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <print>
+#include <tuple>
+#include <utility>
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace SCO {
+namespace {
+constexpr std::uint32_t signMask = 0x80000000;
+constexpr std::uint32_t exponentMask = 0x7F800000;
+constexpr std::uint32_t fractionMask = 0x007FFFFF;
+constexpr std::uint32_t quietBit = 0x00400000;
+constexpr std::uint32_t defaultNaN = 0xFFC00000;
+constexpr int maxExponent = 0xFF;
+
+// Rounding works on a 64-bit significand with its leading one at bit 62,
+// so value = significand / 2^62 * 2^(exponent - 127). The 24 kept bits are
+// 62..39 and the 39 bits below them decide the rounding.
+constexpr int roundingBits = 39;
+constexpr std::uint64_t roundingMask = (std::uint64_t{1} << roundingBits) - 1;
+constexpr std::uint64_t halfway = std::uint64_t{1} << (roundingBits - 1);
+
+bool isNaN(std::uint32_t a) {
+  return (a & exponentMask) == exponentMask and (a & fractionMask) != 0;
+}
+
+bool isSignalingNaN(std::uint32_t a) {
+  return isNaN(a) and (a & quietBit) == 0;
+}
+
+bool isInfinity(std::uint32_t a) {
+  return (a & ~signMask) == exponentMask;
+}
+
+bool isZero(std::uint32_t a) { return (a & ~signMask) == 0; }
+
+// Significand of a finite nonzero value with its leading one at bit 23;
+// subnormals are shifted up and get an exponent below 1 instead
+std::uint64_t unpackNormalized(std::uint32_t a, int &exponent) {
+  exponent = static_cast<int>((a & exponentMask) >> 23);
+  std::uint64_t significand = a & fractionMask;
+  if (exponent == 0) {
+    const int shift = std::countl_zero(significand) - 40;
+    significand <<= shift;
+    exponent = 1 - shift;
+    return significand;
+  }
+  return significand | (std::uint64_t{1} << 23);
+}
+
+// Shifts right, ORing every bit shifted out into bit 0 so rounding still
+// sees that the value was inexact
+std::uint64_t shiftRightJam(std::uint64_t x, unsigned shift) {
+  if (shift >= 63) {
+    return x != 0;
+  }
+  return (x >> shift) | ((x & ((std::uint64_t{1} << shift) - 1)) != 0);
+}
+
+bool roundsUp(bool sign, std::uint64_t kept, std::uint64_t rest,
+              RoundingMode rounding) {
+  switch (rounding) {
+  case RoundingMode::NearestEven:
+    return rest > halfway or (rest == halfway and (kept & 1));
+  case RoundingMode::NearestAway:
+    return rest >= halfway;
+  case RoundingMode::TowardZero:
+    return false;
+  case RoundingMode::Upward:
+    return rest != 0 and not sign;
+  case RoundingMode::Downward:
+    return rest != 0 and sign;
+  }
+  return false;
+}
+
+std::uint32_t roundAndPack(bool sign, int exponent, std::uint64_t significand,
+                           FloatEnvironment &environment) {
+  const std::uint32_t signBit = sign ? signMask : 0;
+
+  bool tiny = false;
+  if (exponent < 1) {
+    // Tiny if even rounding with an unbounded exponent stays below 2^-126
+    const std::uint64_t kept = significand >> roundingBits;
+    tiny = exponent < 0 or
+           not(roundsUp(sign, kept, significand & roundingMask,
+                        environment.rounding) and
+               kept + 1 == std::uint64_t{1} << 24);
+    significand = shiftRightJam(significand, 1 - exponent);
+    exponent = 1;
+  }
+
+  std::uint64_t kept = significand >> roundingBits;
+  const std::uint64_t rest = significand & roundingMask;
+  if (rest != 0) {
+    environment.flags |= FloatInexact;
+    if (tiny) {
+      environment.flags |= FloatUnderflow;
+    }
+  }
+  if (roundsUp(sign, kept, rest, environment.rounding)) {
+    kept++;
+    if (kept == std::uint64_t{1} << 24) {
+      kept >>= 1;
+      exponent++;
+    }
+  }
+
+  if (exponent >= maxExponent) {
+    environment.flags |= FloatOverflow | FloatInexact;
+    const bool toInfinity =
+        environment.rounding == RoundingMode::NearestEven or
+        environment.rounding == RoundingMode::NearestAway or
+        (environment.rounding == RoundingMode::Upward and not sign) or
+        (environment.rounding == RoundingMode::Downward and sign);
+    return signBit | (toInfinity ? exponentMask : 0x7F7FFFFF);
+  }
+
+  // Subnormal results keep exponent 1 without the implicit bit, which
+  // encodes as exponent field 0
+  const std::uint32_t exponentField = kept >> 23 ? exponent : 0;
+  return signBit | (exponentField << 23) |
+         (static_cast<std::uint32_t>(kept) & fractionMask);
+}
+
+std::uint32_t propagateNaN(std::uint32_t a, std::uint32_t b,
+                           FloatEnvironment &environment) {
+  if (isSignalingNaN(a) or isSignalingNaN(b)) {
+    environment.flags |= FloatInvalid;
+  }
+  return (isNaN(a) ? a : b) | quietBit;
+}
+
+// Both operands finite, with b already negated for subtraction
+std::uint32_t addFinite(std::uint32_t a, std::uint32_t b,
+                        FloatEnvironment &environment) {
+  const bool signA = a & signMask;
+  const bool signB = b & signMask;
+
+  // Subnormals get exponent 1 and no implicit bit
+  auto unpack = [](std::uint32_t x, int &exponent, std::uint64_t &sig) {
+    exponent = static_cast<int>((x & exponentMask) >> 23);
+    sig = x & fractionMask;
+    if (exponent == 0) {
+      exponent = 1;
+    } else {
+      sig |= std::uint64_t{1} << 23;
+    }
+  };
+  int exponentA;
+  int exponentB;
+  std::uint64_t sigA;
+  std::uint64_t sigB;
+  unpack(a, exponentA, sigA);
+  unpack(b, exponentB, sigB);
+
+  // One bit of headroom below bit 62 for the carry of an addition
+  sigA <<= roundingBits - 1;
+  sigB <<= roundingBits - 1;
+  bool sign = signA;
+  if (exponentA < exponentB or (exponentA == exponentB and sigA < sigB)) {
+    std::swap(exponentA, exponentB);
+    std::swap(sigA, sigB);
+    sign = signB;
+  }
+
+  // Align in one shift; everything shifted out only matters as sticky bit
+  sigB = shiftRightJam(sigB, exponentA - exponentB);
+  const std::uint64_t result =
+      signA == signB ? sigA + sigB : sigA - sigB;
+
+  if (result == 0) {
+    // Exact zero: x - x is +0 except when rounding down, and -0 + -0 = -0
+    const bool negativeZero =
+        signA == signB ? signA
+                       : environment.rounding == RoundingMode::Downward;
+    return negativeZero ? signMask : 0;
+  }
+
+  // Normalize in one shift by the leading zero count. Left shifts are exact,
+  // and roundAndPack shifts back right if the exponent ends up below 1.
+  const int shift = std::countl_zero(result) - 1;
+  return roundAndPack(sign, exponentA + 1 - shift, result << shift,
+                      environment);
+}
+
+std::uint32_t addSigned(std::uint32_t a, std::uint32_t b, bool negateB,
+                        FloatEnvironment &environment) {
+  if (isNaN(a) or isNaN(b)) {
+    return propagateNaN(a, b, environment);
+  }
+  if (negateB) {
+    b ^= signMask;
+  }
+
+  const bool signA = a & signMask;
+  const bool signB = b & signMask;
+  if (isInfinity(a) or isInfinity(b)) {
+    if (isInfinity(a) and isInfinity(b) and signA != signB) {
+      environment.flags |= FloatInvalid;
+      return defaultNaN;
+    }
+    return isInfinity(a) ? a : b;
+  }
+  return addFinite(a, b, environment);
+}
+
+std::uint32_t multiplyFinite(std::uint32_t a, std::uint32_t b,
+                             FloatEnvironment &environment) {
+  int exponentA;
+  int exponentB;
+  const std::uint64_t product =
+      unpackNormalized(a, exponentA) * unpackNormalized(b, exponentB);
+
+  // The 48-bit product has its leading one at bit 46 or 47
+  const int shift = std::countl_zero(product) - 1;
+  return roundAndPack((a ^ b) & signMask,
+                      exponentA + exponentB - 127 + 16 - shift,
+                      product << shift, environment);
+}
+
+std::uint32_t divideFinite(std::uint32_t a, std::uint32_t b,
+                           FloatEnvironment &environment) {
+  int exponentA;
+  int exponentB;
+  const std::uint64_t dividend = unpackNormalized(a, exponentA) << 40;
+  const std::uint64_t divisor = unpackNormalized(b, exponentB);
+
+  // At least 40 quotient bits, with a sticky bit for a nonzero remainder
+  std::uint64_t quotient = dividend / divisor;
+  quotient |= (dividend % divisor) != 0;
+  const int shift = std::countl_zero(quotient) - 1;
+  return roundAndPack((a ^ b) & signMask,
+                      exponentA - exponentB + 127 + 22 - shift,
+                      quotient << shift, environment);
+}
+
+std::uint32_t squareRootPositive(std::uint32_t a,
+                                 FloatEnvironment &environment) {
+  int exponent;
+  std::uint64_t significand = unpackNormalized(a, exponent);
+
+  // Make the unbiased exponent even so it halves exactly
+  int unbiased = exponent - 127;
+  if (unbiased % 2 != 0) {
+    significand <<= 1;
+    unbiased--;
+  }
+
+  // Digit-by-digit integer square root of significand * 2^39, giving 32
+  // result bits with the leading one at bit 31
+  std::uint64_t remainder = significand << 39;
+  std::uint64_t root = 0;
+  for (std::uint64_t bit = std::uint64_t{1} << 62; bit != 0; bit >>= 2) {
+    if (remainder >= root + bit) {
+      remainder -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+  }
+
+  return roundAndPack(false, unbiased / 2 + 127,
+                      (root << 31) | (remainder != 0), environment);
+}
+
+using UInt128 = unsigned __int128;
+
+int countLeadingZeros(UInt128 x) {
+  const auto high = static_cast<std::uint64_t>(x >> 64);
+  return high != 0 ? std::countl_zero(high)
+                   : 64 + std::countl_zero(static_cast<std::uint64_t>(x));
+}
+
+UInt128 shiftRightJam(UInt128 x, unsigned shift) {
+  if (shift >= 127) {
+    return x != 0;
+  }
+  return (x >> shift) | ((x & ((UInt128{1} << shift) - 1)) != 0);
+}
+
+// Rounds a 128-bit significand with its leading one at bit 126 after
+// folding the low half into a sticky bit
+std::uint32_t roundAndPack(bool sign, int exponent, UInt128 significand,
+                           FloatEnvironment &environment) {
+  const auto high = static_cast<std::uint64_t>(significand >> 64);
+  return roundAndPack(sign, exponent,
+                      high | (static_cast<std::uint64_t>(significand) != 0),
+                      environment);
+}
+
+// a * b + c for finite a and b and finite nonzero c; value = s / 2^124 *
+// 2^(e - 127) for the 128-bit significands below
+std::uint32_t fusedMultiplyAddFinite(std::uint32_t a, std::uint32_t b,
+                                     std::uint32_t c,
+                                     FloatEnvironment &environment) {
+  const bool productSign = (a ^ b) & signMask;
+  const bool signC = c & signMask;
+  int exponentA;
+  int exponentB;
+  UInt128 product = UInt128{unpackNormalized(a, exponentA) *
+                            unpackNormalized(b, exponentB)}
+                    << 78;
+  int exponentProduct = exponentA + exponentB - 127;
+  if (countLeadingZeros(product) == 2) {
+    product >>= 1;
+    exponentProduct++;
+  }
+
+  int exponentC;
+  const UInt128 addend = UInt128{unpackNormalized(c, exponentC)} << 101;
+
+  bool sign = productSign;
+  int exponent = exponentProduct;
+  UInt128 larger = product;
+  UInt128 smaller = addend;
+  int difference = exponentProduct - exponentC;
+  if (exponentC > exponentProduct or
+      (exponentC == exponentProduct and addend > product)) {
+    sign = signC;
+    exponent = exponentC;
+    std::swap(larger, smaller);
+    difference = -difference;
+  }
+  smaller = shiftRightJam(smaller, difference);
+  const UInt128 result =
+      productSign == signC ? larger + smaller : larger - smaller;
+  if (result == 0) {
+    return environment.rounding == RoundingMode::Downward ? signMask : 0;
+  }
+
+  const int shift = countLeadingZeros(result) - 1;
+  return roundAndPack(sign, exponent + 2 - shift, result << shift,
+                      environment);
+}
+
+std::uint32_t multiply(std::uint32_t a, std::uint32_t b,
+                       FloatEnvironment &environment) {
+  if (isNaN(a) or isNaN(b)) {
+    return propagateNaN(a, b, environment);
+  }
+
+  const std::uint32_t signBit = (a ^ b) & signMask;
+  if (isInfinity(a) or isInfinity(b)) {
+    if (isZero(a) or isZero(b)) {
+      environment.flags |= FloatInvalid;
+      return defaultNaN;
+    }
+    return signBit | exponentMask;
+  }
+  if (isZero(a) or isZero(b)) {
+    return signBit;
+  }
+  return multiplyFinite(a, b, environment);
+}
+
+std::uint32_t divide(std::uint32_t a, std::uint32_t b,
+                     FloatEnvironment &environment) {
+  if (isNaN(a) or isNaN(b)) {
+    return propagateNaN(a, b, environment);
+  }
+
+  const std::uint32_t signBit = (a ^ b) & signMask;
+  if (isInfinity(a)) {
+    if (isInfinity(b)) {
+      environment.flags |= FloatInvalid;
+      return defaultNaN;
+    }
+    return signBit | exponentMask;
+  }
+  if (isInfinity(b)) {
+    return signBit;
+  }
+  if (isZero(b)) {
+    if (isZero(a)) {
+      environment.flags |= FloatInvalid;
+      return defaultNaN;
+    }
+    environment.flags |= FloatDivideByZero;
+    return signBit | exponentMask;
+  }
+  if (isZero(a)) {
+    return signBit;
+  }
+  return divideFinite(a, b, environment);
+}
+
+std::uint32_t squareRoot(std::uint32_t a, FloatEnvironment &environment) {
+  if (isNaN(a)) {
+    return propagateNaN(a, a, environment);
+  }
+  if (isZero(a) or a == exponentMask) {
+    return a;
+  }
+  if (a & signMask) {
+    environment.flags |= FloatInvalid;
+    return defaultNaN;
+  }
+  return squareRootPositive(a, environment);
+}
+
+std::uint32_t fusedMultiplyAdd(std::uint32_t a, std::uint32_t b,
+                               std::uint32_t c,
+                               FloatEnvironment &environment) {
+  // Like x86 FMA: the first NaN operand wins, and inf * 0 is invalid even
+  // when c is a quiet NaN
+  if (isNaN(a) or isNaN(b) or isNaN(c)) {
+    if (isSignalingNaN(a) or isSignalingNaN(b) or isSignalingNaN(c) or
+        (isInfinity(a) and isZero(b)) or (isZero(a) and isInfinity(b))) {
+      environment.flags |= FloatInvalid;
+    }
+    return (isNaN(a) ? a : isNaN(b) ? b : c) | quietBit;
+  }
+
+  const bool productSign = (a ^ b) & signMask;
+  const bool signC = c & signMask;
+  if (isInfinity(a) or isInfinity(b)) {
+    if (isZero(a) or isZero(b) or
+        (isInfinity(c) and signC != productSign)) {
+      environment.flags |= FloatInvalid;
+      return defaultNaN;
+    }
+    return (productSign ? signMask : 0) | exponentMask;
+  }
+  if (isInfinity(c)) {
+    return c;
+  }
+  if (isZero(a) or isZero(b)) {
+    if (not isZero(c)) {
+      return c;
+    }
+    // Exact zero sum, signed like an addition of zeros
+    const bool negativeZero =
+        productSign == signC ? signC
+                             : environment.rounding == RoundingMode::Downward;
+    return negativeZero ? signMask : 0;
+  }
+  if (isZero(c)) {
+    // The product alone, rounded once
+    return multiplyFinite(a, b, environment);
+  }
+  return fusedMultiplyAddFinite(a, b, c, environment);
+}
+
+bool haveSameSize(std::size_t size, std::size_t outSize) {
+  if (size != outSize) {
+    std::print("Operand spans hold {} values but the output holds {}\n",
+               size, outSize);
+    return false;
+  }
+  return true;
+}
+
+// The batch kernels work on one vector register of lanes at a time with
+// GCC and Clang vector extensions, which lower to SSE2 or NEON without
+// target flags and use wider registers when the target has them. Every
+// lane runs the same straight-line code: the finite core and each special
+// case are computed for all lanes and blended with masks, and the exception
+// flags of a block are ORed together once. Only the subnormal paths, which
+// no lane of a typical register takes, are skipped when none of it does.
+//
+// Lanes are signed 32-bit, which SSE2 compares natively: bit patterns keep
+// the sign in the sign bit, and significands stay below 2^31. Rounding
+// works like roundAndPack with the leading one at bit 30 and 7 rounding
+// bits, so value = significand / 2^30 * 2^(exponent - 127).
+#if defined(__AVX512F__)
+constexpr std::size_t vectorBytes = 64;
+#elif defined(__AVX2__)
+constexpr std::size_t vectorBytes = 32;
+#else
+constexpr std::size_t vectorBytes = 16;
+#endif
+constexpr std::size_t numLanes = vectorBytes / 4;
+using Lanes = std::int32_t __attribute__((vector_size(vectorBytes)));
+
+constexpr int laneRoundingBits = 7;
+constexpr std::int32_t laneRoundingMask = (1 << laneRoundingBits) - 1;
+constexpr std::int32_t laneHalfway = 1 << (laneRoundingBits - 1);
+constexpr std::int32_t laneSignMask = std::numeric_limits<std::int32_t>::min();
+constexpr std::int32_t laneExponentMask = exponentMask;
+constexpr std::int32_t laneFractionMask = fractionMask;
+constexpr std::int32_t laneQuietBit = quietBit;
+constexpr std::int32_t laneDefaultNaN = static_cast<std::int32_t>(defaultNaN);
+
+Lanes select(Lanes condition, Lanes a, Lanes b) {
+  return (condition & a) | (~condition & b);
+}
+
+Lanes splat(std::int32_t value) { return Lanes{} + value; }
+
+Lanes flag(std::uint8_t exceptions) { return splat(exceptions); }
+
+Lanes load(const std::uint32_t *values) {
+  Lanes lanes;
+  std::memcpy(&lanes, values, sizeof(lanes));
+  return lanes;
+}
+
+void store(Lanes lanes, std::uint32_t *out) {
+  std::memcpy(out, &lanes, sizeof(lanes));
+}
+
+// The register as 64-bit halves, for products that need more than 32 bits:
+// the even lanes go through them first and the odd ones after
+using Halves = std::uint64_t __attribute__((vector_size(vectorBytes)));
+constexpr std::uint64_t lowerHalf = 0xFFFFFFFF;
+
+Halves evenLanes(Lanes x) { return std::bit_cast<Halves>(x) & lowerHalf; }
+
+Halves oddLanes(Lanes x) { return std::bit_cast<Halves>(x) >> 32; }
+
+// Keeps the low 32 bits of each half, as lanes that have no meaningful
+// result, such as zero divisors, can leave anything in their half
+Lanes interleave(Halves even, Halves odd) {
+  return std::bit_cast<Lanes>((even & lowerHalf) | (odd << 32));
+}
+
+// The product of the low 32 bits of each half. That is one widening multiply
+// on x86, but GCC emulates a full 64-bit multiply even for masked operands,
+// so it is spelled out there.
+Halves multiplyLow(Halves a, Halves b) {
+#if defined(__AVX512F__)
+  // The unmasked form trips -Wmaybe-uninitialized in GCC 12's header
+  return std::bit_cast<Halves>(_mm512_maskz_mul_epu32(
+      0xFF, std::bit_cast<__m512i>(a), std::bit_cast<__m512i>(b)));
+#elif defined(__AVX2__)
+  return std::bit_cast<Halves>(_mm256_mul_epu32(std::bit_cast<__m256i>(a),
+                                                std::bit_cast<__m256i>(b)));
+#elif defined(__SSE2__)
+  return std::bit_cast<Halves>(
+      _mm_mul_epu32(std::bit_cast<__m128i>(a), std::bit_cast<__m128i>(b)));
+#else
+  return (a & lowerHalf) * (b & lowerHalf);
+#endif
+}
+
+Lanes isNaN(Lanes a) { return (a & ~laneSignMask) > laneExponentMask; }
+
+Lanes isSignalingNaN(Lanes a) {
+  return isNaN(a) & ((a & laneQuietBit) == 0);
+}
+
+Lanes isInfinity(Lanes a) {
+  return (a & ~laneSignMask) == laneExponentMask;
+}
+
+Lanes isZero(Lanes a) { return (a & ~laneSignMask) == 0; }
+
+Lanes isNegative(Lanes a) { return a < 0; }
+
+// Counts above 31 act as 31, which is exact below 2^31. Shifts by a count
+// per lane are one instruction from AVX2 on, and SSE2 does them lane by
+// lane.
+Lanes shiftRightJam(Lanes x, Lanes count) {
+  count = select(count > 31, splat(31), count);
+  const Lanes dropped = x & ((splat(1) << count) - 1);
+  return (x >> count) | ((dropped != 0) & 1);
+}
+
+// Moves the leading one of every nonzero lane to bit 30 and lowers the
+// exponent by the shift, like countl_zero but in five constant shifts
+void normalize(Lanes &significand, Lanes &exponent) {
+  for (int step = 16; step != 0; step >>= 1) {
+    const Lanes shift = significand < (1 << (31 - step));
+    significand = select(shift, significand << step, significand);
+    exponent -= shift & step;
+  }
+}
+
+// Whether any lane of a mask is set, to skip work that no lane of a block
+// needs. Those paths are rare, so the branch predicts well.
+bool any(Lanes mask) {
+  const auto halves = std::bit_cast<Halves>(mask);
+  std::uint64_t combined = 0;
+  for (std::size_t i = 0; i < numLanes / 2; i++) {
+    combined |= halves[i];
+  }
+  return combined != 0;
+}
+
+// Subnormals get exponent 1 and no implicit bit
+void unpack(Lanes a, Lanes &significand, Lanes &exponent) {
+  const Lanes exponentField = (a >> 23) & maxExponent;
+  const Lanes normal = exponentField != 0;
+  significand = (a & laneFractionMask) | (normal & (1 << 23));
+  exponent = select(normal, exponentField, splat(1));
+}
+
+// Like unpackNormalized: the leading one at bit 23, subnormals with an
+// exponent below 1. Zero lanes come out as garbage.
+void unpackNormalized(Lanes a, Lanes &significand, Lanes &exponent) {
+  unpack(a, significand, exponent);
+  if (any(significand < 1 << 23)) {
+    exponent += 7;
+    normalize(significand, exponent);
+    significand >>= 7;
+  }
+}
+
+Lanes roundsUp(Lanes negative, Lanes kept, Lanes rest,
+               RoundingMode rounding) {
+  switch (rounding) {
+  case RoundingMode::NearestEven:
+    return (rest > laneHalfway) |
+           ((rest == laneHalfway) & ((kept & 1) != 0));
+  case RoundingMode::NearestAway:
+    return rest >= laneHalfway;
+  case RoundingMode::TowardZero:
+    return Lanes{};
+  case RoundingMode::Upward:
+    return (rest != 0) & ~negative;
+  case RoundingMode::Downward:
+    return (rest != 0) & negative;
+  }
+  return Lanes{};
+}
+
+// roundAndPack for every lane; flags collects the exceptions per lane for
+// the caller to mask
+Lanes roundAndPack(Lanes negative, Lanes exponent, Lanes significand,
+                   RoundingMode rounding, Lanes &flags) {
+  const Lanes signBit = negative & laneSignMask;
+
+  const Lanes below = exponent < 1;
+  Lanes tiny{};
+  if (any(below)) {
+    const Lanes keptBefore = significand >> laneRoundingBits;
+    tiny = below & ((exponent < 0) |
+                    ~(roundsUp(negative, keptBefore,
+                               significand & laneRoundingMask, rounding) &
+                      (keptBefore + 1 == 1 << 24)));
+    significand =
+        select(below, shiftRightJam(significand, 1 - exponent), significand);
+    exponent = select(below, splat(1), exponent);
+  }
+
+  Lanes kept = significand >> laneRoundingBits;
+  const Lanes rest = significand & laneRoundingMask;
+  const Lanes inexact = rest != 0;
+  flags |= (inexact & flag(FloatInexact)) |
+           (inexact & tiny & flag(FloatUnderflow));
+  kept += roundsUp(negative, kept, rest, rounding) & 1;
+  const Lanes carry = kept == 1 << 24;
+  kept = select(carry, kept >> 1, kept);
+  exponent += carry & 1;
+
+  const Lanes overflow = exponent >= maxExponent;
+  flags |= overflow & flag(FloatOverflow | FloatInexact);
+  Lanes toInfinity{};
+  switch (rounding) {
+  case RoundingMode::NearestEven:
+  case RoundingMode::NearestAway:
+    toInfinity = ~Lanes{};
+    break;
+  case RoundingMode::TowardZero:
+    break;
+  case RoundingMode::Upward:
+    toInfinity = ~negative;
+    break;
+  case RoundingMode::Downward:
+    toInfinity = negative;
+    break;
+  }
+  const Lanes overflowed =
+      signBit | select(toInfinity, splat(laneExponentMask), splat(0x7F7FFFFF));
+
+  const Lanes exponentField = select((kept >> 23) != 0, exponent, Lanes{});
+  return select(overflow, overflowed,
+                signBit | (exponentField << 23) | (kept & laneFractionMask));
+}
+
+Lanes propagateNaN(Lanes a, Lanes b, Lanes &flags) {
+  flags |= (isSignalingNaN(a) | isSignalingNaN(b)) & flag(FloatInvalid);
+  return select(isNaN(a), a, b) | laneQuietBit;
+}
+
+Lanes add(Lanes a, Lanes b, bool negateB, RoundingMode rounding,
+          Lanes &flags) {
+  // NaNs propagate with the sign b came with
+  Lanes nanFlags{};
+  const Lanes nan = isNaN(a) | isNaN(b);
+  const Lanes nanResult = propagateNaN(a, b, nanFlags);
+  if (negateB) {
+    b ^= laneSignMask;
+  }
+
+  const Lanes negativeA = isNegative(a);
+  const Lanes negativeB = isNegative(b);
+  const Lanes infinite = isInfinity(a) | isInfinity(b);
+  const Lanes infinityClash =
+      isInfinity(a) & isInfinity(b) & (negativeA ^ negativeB);
+  const Lanes infiniteResult = select(infinityClash, splat(laneDefaultNaN),
+                                      select(isInfinity(a), a, b));
+
+  // Six guard bits below the significands, with the leading one at bit 29
+  Lanes sigA;
+  Lanes sigB;
+  Lanes exponentA;
+  Lanes exponentB;
+  unpack(a, sigA, exponentA);
+  unpack(b, sigB, exponentB);
+  sigA <<= laneRoundingBits - 1;
+  sigB <<= laneRoundingBits - 1;
+  const Lanes swap = (exponentA < exponentB) |
+                     ((exponentA == exponentB) & (sigA < sigB));
+  const Lanes larger = select(swap, sigB, sigA);
+  const Lanes exponent = select(swap, exponentB, exponentA);
+  const Lanes smaller =
+      shiftRightJam(select(swap, sigA, sigB),
+                    exponent - select(swap, exponentA, exponentB));
+  const Lanes sameSign = ~(negativeA ^ negativeB);
+  Lanes sum = select(sameSign, larger + smaller, larger - smaller);
+
+  // Exact zero: x - x is +0 except when rounding down, and -0 + -0 = -0
+  const Lanes zero = sum == 0;
+  const Lanes zeroNegative =
+      select(sameSign, negativeA,
+             rounding == RoundingMode::Downward ? ~Lanes{} : Lanes{});
+  Lanes normalizedExponent = exponent + 1;
+  normalize(sum, normalizedExponent);
+  Lanes finiteFlags{};
+  const Lanes finiteResult =
+      select(zero, zeroNegative & laneSignMask,
+             roundAndPack(select(swap, negativeB, negativeA),
+                          normalizedExponent, sum, rounding, finiteFlags));
+
+  flags |= select(nan, nanFlags,
+                  select(infinite, infinityClash & flag(FloatInvalid),
+                         finiteFlags & ~zero));
+  return select(nan, nanResult,
+                select(infinite, infiniteResult, finiteResult));
+}
+
+// The 48-bit product of two 24-bit significands as high * 2^24 + low with
+// low < 2^24
+void multiplySignificands(Lanes sigA, Lanes sigB, Lanes &high, Lanes &low) {
+  const Halves even = multiplyLow(evenLanes(sigA), evenLanes(sigB));
+  const Halves odd = multiplyLow(oddLanes(sigA), oddLanes(sigB));
+  high = interleave(even >> 24, odd >> 24);
+  low = interleave(even & 0xFFFFFF, odd & 0xFFFFFF);
+}
+
+// The finite core of multiply for lanes where neither operand is zero
+Lanes multiplyFinite(Lanes a, Lanes b, RoundingMode rounding,
+                     Lanes &flags) {
+  Lanes sigA;
+  Lanes sigB;
+  Lanes exponentA;
+  Lanes exponentB;
+  unpackNormalized(a, sigA, exponentA);
+  unpackNormalized(b, sigB, exponentB);
+
+  // The product is at least 2^46, so its top 31 bits and a sticky bit for
+  // the other 17 hold everything rounding needs
+  Lanes high;
+  Lanes low;
+  multiplySignificands(sigA, sigB, high, low);
+  Lanes product =
+      (high << 7) | (low >> 17) | (((low & 0x1FFFF) != 0) & 1);
+  const Lanes narrow = product < 1 << 30;
+  product = select(narrow, product << 1, product);
+  return roundAndPack(isNegative(a ^ b), exponentA + exponentB - 126 + narrow,
+                      product, rounding, flags);
+}
+
+Lanes multiply(Lanes a, Lanes b, RoundingMode rounding, Lanes &flags) {
+  Lanes nanFlags{};
+  const Lanes nan = isNaN(a) | isNaN(b);
+  const Lanes nanResult = propagateNaN(a, b, nanFlags);
+
+  const Lanes signBit = (a ^ b) & laneSignMask;
+  const Lanes infinite = isInfinity(a) | isInfinity(b);
+  const Lanes zero = isZero(a) | isZero(b);
+  Lanes finiteFlags{};
+  const Lanes finiteResult = multiplyFinite(a, b, rounding, finiteFlags);
+
+  flags |= select(nan, nanFlags,
+                  select(infinite, zero & flag(FloatInvalid),
+                         ~zero & finiteFlags));
+  return select(
+      nan, nanResult,
+      select(infinite,
+             select(zero, splat(laneDefaultNaN), signBit | laneExponentMask),
+             select(zero, signBit, finiteResult)));
+}
+
+// floor(sigA * 2^26 / sigB) and its remainder for 24-bit significands, from
+// r = 2^55 / sigB in (2^31, 2^32]. A linear estimate up to 12% below r and
+// four Newton-Raphson steps, which stay below it, get within 2 of r for
+// every sigB, so the quotient is at most 1 too low.
+void divideSignificands(Halves sigA, Halves sigB, Halves &quotient,
+                        Halves &remainder) {
+  constexpr std::uint64_t one = std::uint64_t{1} << 55;
+  Halves reciprocal = 5810845165 - multiplyLow(sigB, Halves{} + 241);
+  for (int step = 0; step < 4; step++) {
+    const Halves error = (one - 1) - multiplyLow(sigB, reciprocal);
+    reciprocal += multiplyLow(reciprocal, error >> 23) >> 32;
+  }
+  quotient = multiplyLow(sigA, reciprocal) >> 29;
+  remainder = (sigA << 26) - multiplyLow(quotient, sigB);
+}
+
+Lanes divide(Lanes a, Lanes b, RoundingMode rounding, Lanes &flags) {
+  Lanes nanFlags{};
+  const Lanes nan = isNaN(a) | isNaN(b);
+  const Lanes nanResult = propagateNaN(a, b, nanFlags);
+
+  const Lanes signBit = (a ^ b) & laneSignMask;
+  const Lanes infiniteA = isInfinity(a);
+  const Lanes infiniteB = isInfinity(b);
+  const Lanes zeroA = isZero(a);
+  const Lanes zeroB = isZero(b);
+
+  // 27 quotient bits with the leading one at bit 25 or 26, and a sticky bit
+  // for the remainder
+  Lanes sigA;
+  Lanes sigB;
+  Lanes exponentA;
+  Lanes exponentB;
+  unpackNormalized(a, sigA, exponentA);
+  unpackNormalized(b, sigB, exponentB);
+  Halves quotientEven;
+  Halves quotientOdd;
+  Halves remainderEven;
+  Halves remainderOdd;
+  divideSignificands(evenLanes(sigA), evenLanes(sigB), quotientEven,
+                     remainderEven);
+  divideSignificands(oddLanes(sigA), oddLanes(sigB), quotientOdd,
+                     remainderOdd);
+  Lanes quotient = interleave(quotientEven, quotientOdd);
+  Lanes remainder = interleave(remainderEven, remainderOdd);
+  const Lanes fits = remainder > sigB - 1;
+  quotient -= fits;
+  remainder -= fits & sigB;
+  quotient |= (remainder != 0) & 1;
+  const Lanes narrow = quotient < 1 << 26;
+  quotient = select(narrow, quotient << 5, quotient << 4);
+  Lanes finiteFlags{};
+  const Lanes finiteResult =
+      roundAndPack(isNegative(a ^ b), exponentA - exponentB + 127 + narrow,
+                   quotient, rounding, finiteFlags);
+
+  // In the order of the scalar divide
+  const Lanes invalid = (infiniteA & infiniteB) | (zeroA & zeroB);
+  const Lanes toInfinity = (infiniteA | zeroB) & ~invalid;
+  const Lanes toZero = ~infiniteA & (infiniteB | (zeroA & ~zeroB));
+  const Lanes special = invalid | toInfinity | toZero;
+  flags |= select(nan, nanFlags,
+                  (invalid & flag(FloatInvalid)) |
+                      (zeroB & ~zeroA & ~infiniteA & flag(FloatDivideByZero)) |
+                      (~special & finiteFlags));
+  return select(
+      nan, nanResult,
+      select(invalid, splat(laneDefaultNaN),
+             select(toInfinity, signBit | laneExponentMask,
+                    select(toZero, signBit, finiteResult))));
+}
+
+Lanes squareRoot(Lanes a, RoundingMode rounding, Lanes &flags) {
+  Lanes nanFlags{};
+  const Lanes nan = isNaN(a);
+  const Lanes nanResult = propagateNaN(a, a, nanFlags);
+  const Lanes unchanged = isZero(a) | (a == laneExponentMask);
+  const Lanes invalid = ~unchanged & isNegative(a);
+
+  Lanes significand;
+  Lanes exponent;
+  unpackNormalized(a, significand, exponent);
+  Lanes unbiased = exponent - 127;
+  const Lanes odd = (unbiased & 1) != 0;
+  significand = select(odd, significand << 1, significand);
+  unbiased -= odd & 1;
+
+  // Digit by digit, one step per pair of bits of significand * 2^29: the
+  // 27-bit root has its leading one at bit 26, and the remainder never
+  // exceeds twice the root, so everything fits in a lane
+  Lanes remainder{};
+  Lanes root{};
+  for (int bit = 52; bit >= 0; bit -= 2) {
+    const Lanes pair = bit >= 29   ? (significand >> (bit - 29)) & 3
+                       : bit == 28 ? (significand << 1) & 3
+                                   : Lanes{};
+    remainder = (remainder << 2) | pair;
+    const Lanes trial = (root << 2) | 1;
+    const Lanes fits = remainder >= trial;
+    remainder -= fits & trial;
+    root = (root << 1) | (fits & 1);
+  }
+  Lanes finiteFlags{};
+  const Lanes finiteResult =
+      roundAndPack(Lanes{}, (unbiased >> 1) + 127,
+                   (root << 4) | ((remainder != 0) & 1), rounding,
+                   finiteFlags);
+
+  flags |= select(nan, nanFlags,
+                  (invalid & flag(FloatInvalid)) |
+                      (~unchanged & ~invalid & finiteFlags));
+  return select(nan, nanResult,
+                select(unchanged, a,
+                       select(invalid, splat(laneDefaultNaN), finiteResult)));
+}
+
+// A 60-bit fixed-point value in two 30-bit limbs, so sums and differences
+// of limbs stay positive within a lane
+struct WideLanes {
+  Lanes high;
+  Lanes low;
+};
+
+constexpr std::int32_t limbMask = (1 << 30) - 1;
+
+WideLanes select(Lanes condition, WideLanes a, WideLanes b) {
+  return {select(condition, a.high, b.high), select(condition, a.low, b.low)};
+}
+
+// shiftRightJam on the 60 bits, a whole limb at a time first
+WideLanes shiftRightJam(WideLanes x, Lanes count) {
+  const Lanes gone = count >= 60;
+  Lanes dropped = gone & (x.high | x.low);
+  x.high &= ~gone;
+  x.low &= ~gone;
+  const Lanes limb = count >= 30;
+  dropped |= limb & x.low;
+  x.low = select(limb, x.high, x.low);
+  x.high &= ~limb;
+  count = ~gone & select(limb, count - 30, count);
+  dropped |= x.low & ((splat(1) << count) - 1);
+  x.low = (x.low >> count) | ((x.high << (30 - count)) & limbMask);
+  x.high >>= count;
+  x.low |= (dropped != 0) & 1;
+  return x;
+}
+
+// a * b + c for finite operands and a nonzero product, in a 60-bit window.
+// The product and c both have their leading one at bit 57, and whichever
+// is smaller is shifted right with a sticky bit. Bits only get lost when
+// the two are at least 11 bits apart, so the sum never cancels more than a
+// bit and the sticky bit stays far below the 27 bits dropped at the end.
+Lanes fusedMultiplyAddFinite(Lanes a, Lanes b, Lanes c,
+                             RoundingMode rounding, Lanes &flags) {
+  Lanes sigA;
+  Lanes sigB;
+  Lanes sigC;
+  Lanes exponentA;
+  Lanes exponentB;
+  Lanes exponentC;
+  unpackNormalized(a, sigA, exponentA);
+  unpackNormalized(b, sigB, exponentB);
+  unpackNormalized(c, sigC, exponentC);
+
+  // value = window * 2^exponent for both, so the exponents order the
+  // magnitudes
+  Lanes productHigh;
+  Lanes productLow;
+  multiplySignificands(sigA, sigB, productHigh, productLow);
+  WideLanes product{(productHigh << 4) | (productLow >> 20),
+                    (productLow & 0xFFFFF) << 10};
+  Lanes exponentProduct = exponentA + exponentB - 310;
+  const Lanes narrow = product.high < 1 << 27;
+  product = select(narrow,
+                   WideLanes{(product.high << 1) | (product.low >> 29),
+                             (product.low << 1) & limbMask},
+                   product);
+  exponentProduct += narrow;
+  // A zero c adds nothing at the product's exponent, which leaves the
+  // product to be rounded alone
+  const Lanes zeroC = isZero(c);
+  const WideLanes addend{~zeroC & (sigC << 4), Lanes{}};
+  const Lanes exponentAddend =
+      select(zeroC, exponentProduct, exponentC - 184);
+
+  // The addend's low limb is zero, so its high limb decides a tie
+  const Lanes productNegative = isNegative(a ^ b);
+  const Lanes negativeC = isNegative(c);
+  const Lanes swap = (exponentAddend > exponentProduct) |
+                     ((exponentAddend == exponentProduct) &
+                      (addend.high > product.high));
+  Lanes exponent = select(swap, exponentAddend, exponentProduct);
+  const WideLanes larger = select(swap, addend, product);
+  const WideLanes smaller = shiftRightJam(
+      select(swap, product, addend),
+      exponent - select(swap, exponentProduct, exponentAddend));
+  const Lanes sameSign = ~(productNegative ^ negativeC);
+  WideLanes sum;
+  sum.low = select(sameSign, larger.low + smaller.low,
+                   larger.low - smaller.low);
+  // The carry out of the low limb, or -1 for a borrow
+  sum.high = select(sameSign, larger.high + smaller.high,
+                    larger.high - smaller.high) +
+             (sum.low >> 30);
+  sum.low &= limbMask;
+  const Lanes zero = (sum.high | sum.low) == 0;
+
+  // Back to the leading one at bit 57: one right shift after a carry,
+  // otherwise a whole limb if that does not overshoot, and five constant
+  // left shifts
+  const Lanes carry = sum.high >= 1 << 28;
+  sum = select(carry,
+               WideLanes{sum.high >> 1, (sum.low >> 1) |
+                                            ((sum.high & 1) << 29) |
+                                            (sum.low & 1)},
+               sum);
+  exponent -= carry;
+  const Lanes limb = (sum.high == 0) & (sum.low < 1 << 28);
+  sum = select(limb, WideLanes{sum.low, Lanes{}}, sum);
+  exponent -= limb & 30;
+  for (int step = 16; step != 0; step >>= 1) {
+    const Lanes shift = sum.high < (1 << (28 - step));
+    sum = select(shift,
+                 WideLanes{(sum.high << step) | (sum.low >> (30 - step)),
+                           (sum.low << step) & limbMask},
+                 sum);
+    exponent -= shift & step;
+  }
+
+  const Lanes significand = (sum.high << 3) | (sum.low >> 27) |
+                            (((sum.low & ((1 << 27) - 1)) != 0) & 1);
+  Lanes finiteFlags{};
+  const Lanes finiteResult =
+      roundAndPack(select(swap, negativeC, productNegative), exponent + 184,
+                   significand, rounding, finiteFlags);
+  flags |= ~zero & finiteFlags;
+  return select(
+      zero, splat(rounding == RoundingMode::Downward ? laneSignMask : 0),
+      finiteResult);
+}
+
+Lanes fusedMultiplyAdd(Lanes a, Lanes b, Lanes c, RoundingMode rounding,
+                       Lanes &flags) {
+  // Like x86 FMA: the first NaN operand wins, and inf * 0 is invalid even
+  // when c is a quiet NaN
+  const Lanes infinityTimesZero =
+      (isInfinity(a) & isZero(b)) | (isZero(a) & isInfinity(b));
+  const Lanes nan = isNaN(a) | isNaN(b) | isNaN(c);
+  const Lanes nanFlags =
+      (isSignalingNaN(a) | isSignalingNaN(b) | isSignalingNaN(c) |
+       infinityTimesZero) &
+      flag(FloatInvalid);
+  const Lanes nanResult =
+      select(isNaN(a), a, select(isNaN(b), b, c)) | laneQuietBit;
+
+  const Lanes productNegative = isNegative(a ^ b);
+  const Lanes negativeC = isNegative(c);
+  const Lanes infiniteProduct = isInfinity(a) | isInfinity(b);
+  const Lanes zeroProduct = isZero(a) | isZero(b);
+  const Lanes infiniteInvalid =
+      zeroProduct | (isInfinity(c) & (negativeC ^ productNegative));
+  const Lanes infiniteResult =
+      select(infiniteInvalid, splat(laneDefaultNaN),
+             (productNegative & laneSignMask) | laneExponentMask);
+
+  // Exact zero sum, signed like an addition of zeros
+  const Lanes zeroNegative =
+      select(~(productNegative ^ negativeC), negativeC,
+             rounding == RoundingMode::Downward ? ~Lanes{} : Lanes{});
+  const Lanes zeroProductResult =
+      select(isZero(c), zeroNegative & laneSignMask, c);
+
+  Lanes finiteFlags{};
+  const Lanes finiteResult =
+      fusedMultiplyAddFinite(a, b, c, rounding, finiteFlags);
+
+  const Lanes special = nan | infiniteProduct | isInfinity(c) | zeroProduct;
+  flags |= select(nan, nanFlags,
+                  (infiniteProduct & infiniteInvalid & flag(FloatInvalid)) |
+                      (~special & finiteFlags));
+  return select(
+      nan, nanResult,
+      select(infiniteProduct, infiniteResult,
+             select(isInfinity(c), c,
+                    select(zeroProduct, zeroProductResult, finiteResult))));
+}
+
+// Batches run in blocks of whole vectors, with the flags of each block
+// reduced into the environment once. The few values past the last whole
+// vector take the scalar path.
+constexpr std::size_t batchBlock = 256;
+
+template <std::size_t NumOperands, typename Kernel, typename Scalar>
+bool applyBatch(std::array<std::span<const std::uint32_t>, NumOperands> in,
+                std::span<std::uint32_t> out, FloatEnvironment &environment,
+                Kernel kernel, Scalar scalar) {
+  for (const auto &operand : in) {
+    if (not haveSameSize(operand.size(), out.size())) {
+      return false;
+    }
+  }
+
+  const std::size_t vectorSize = out.size() - out.size() % numLanes;
+  for (std::size_t begin = 0; begin < vectorSize; begin += batchBlock) {
+    const std::size_t end = std::min(vectorSize, begin + batchBlock);
+    Lanes flags{};
+    for (std::size_t i = begin; i < end; i += numLanes) {
+      std::array<Lanes, NumOperands> operands;
+      for (std::size_t o = 0; o < NumOperands; o++) {
+        operands[o] = load(in[o].data() + i);
+      }
+      store(kernel(operands, environment.rounding, flags), out.data() + i);
+    }
+    for (std::size_t lane = 0; lane < numLanes; lane++) {
+      environment.flags |= static_cast<std::uint8_t>(flags[lane]);
+    }
+  }
+
+  for (std::size_t i = vectorSize; i < out.size(); i++) {
+    std::array<std::uint32_t, NumOperands> operands;
+    for (std::size_t o = 0; o < NumOperands; o++) {
+      operands[o] = in[o][i];
+    }
+    out[i] = std::apply(
+        [&](auto... operand) { return scalar(operand..., environment); },
+        operands);
+  }
+  return true;
+}
+} // namespace
+
+std::uint32_t softFloatAdd(std::uint32_t a, std::uint32_t b,
+                           FloatEnvironment &environment) {
+  return addSigned(a, b, false, environment);
+}
+
+std::uint32_t softFloatSubtract(std::uint32_t a, std::uint32_t b,
+                                FloatEnvironment &environment) {
+  return addSigned(a, b, true, environment);
+}
+
+std::uint32_t softFloatMultiply(std::uint32_t a, std::uint32_t b,
+                                FloatEnvironment &environment) {
+  return multiply(a, b, environment);
+}
+
+std::uint32_t softFloatDivide(std::uint32_t a, std::uint32_t b,
+                              FloatEnvironment &environment) {
+  return divide(a, b, environment);
+}
+
+std::uint32_t softFloatSquareRoot(std::uint32_t a,
+                                  FloatEnvironment &environment) {
+  return squareRoot(a, environment);
+}
+
+std::uint32_t softFloatFusedMultiplyAdd(std::uint32_t a, std::uint32_t b,
+                                        std::uint32_t c,
+                                        FloatEnvironment &environment) {
+  return fusedMultiplyAdd(a, b, c, environment);
+}
+
+bool softFloatAdd(std::span<const std::uint32_t> a,
+                  std::span<const std::uint32_t> b,
+                  std::span<std::uint32_t> out,
+                  FloatEnvironment &environment) {
+  return applyBatch<2>(
+      {a, b}, out, environment,
+      [](const auto &x, RoundingMode rounding, Lanes &flags) {
+        return add(x[0], x[1], false, rounding, flags);
+      },
+      [](std::uint32_t x, std::uint32_t y, FloatEnvironment &environment) {
+        return addSigned(x, y, false, environment);
+      });
+}
+
+bool softFloatSubtract(std::span<const std::uint32_t> a,
+                       std::span<const std::uint32_t> b,
+                       std::span<std::uint32_t> out,
+                       FloatEnvironment &environment) {
+  return applyBatch<2>(
+      {a, b}, out, environment,
+      [](const auto &x, RoundingMode rounding, Lanes &flags) {
+        return add(x[0], x[1], true, rounding, flags);
+      },
+      [](std::uint32_t x, std::uint32_t y, FloatEnvironment &environment) {
+        return addSigned(x, y, true, environment);
+      });
+}
+
+bool softFloatMultiply(std::span<const std::uint32_t> a,
+                       std::span<const std::uint32_t> b,
+                       std::span<std::uint32_t> out,
+                       FloatEnvironment &environment) {
+  return applyBatch<2>(
+      {a, b}, out, environment,
+      [](const auto &x, RoundingMode rounding, Lanes &flags) {
+        return multiply(x[0], x[1], rounding, flags);
+      },
+      [](std::uint32_t x, std::uint32_t y, FloatEnvironment &environment) {
+        return multiply(x, y, environment);
+      });
+}
+
+bool softFloatDivide(std::span<const std::uint32_t> a,
+                     std::span<const std::uint32_t> b,
+                     std::span<std::uint32_t> out,
+                     FloatEnvironment &environment) {
+  return applyBatch<2>(
+      {a, b}, out, environment,
+      [](const auto &x, RoundingMode rounding, Lanes &flags) {
+        return divide(x[0], x[1], rounding, flags);
+      },
+      [](std::uint32_t x, std::uint32_t y, FloatEnvironment &environment) {
+        return divide(x, y, environment);
+      });
+}
+
+bool softFloatSquareRoot(std::span<const std::uint32_t> a,
+                         std::span<std::uint32_t> out,
+                         FloatEnvironment &environment) {
+  return applyBatch<1>(
+      {a}, out, environment,
+      [](const auto &x, RoundingMode rounding, Lanes &flags) {
+        return squareRoot(x[0], rounding, flags);
+      },
+      [](std::uint32_t x, FloatEnvironment &environment) {
+        return squareRoot(x, environment);
+      });
+}
+
+bool softFloatFusedMultiplyAdd(std::span<const std::uint32_t> a,
+                               std::span<const std::uint32_t> b,
+                               std::span<const std::uint32_t> c,
+                               std::span<std::uint32_t> out,
+                               FloatEnvironment &environment) {
+  return applyBatch<3>(
+      {a, b, c}, out, environment,
+      [](const auto &x, RoundingMode rounding, Lanes &flags) {
+        return fusedMultiplyAdd(x[0], x[1], x[2], rounding, flags);
+      },
+      [](std::uint32_t x, std::uint32_t y, std::uint32_t z,
+         FloatEnvironment &environment) {
+        return fusedMultiplyAdd(x, y, z, environment);
+      });
+}
+} // namespace SCO
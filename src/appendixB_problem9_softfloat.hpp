@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace SCO {
+enum class RoundingMode : std::uint8_t {
+  NearestEven = 0,
+  NearestAway,
+  TowardZero,
+  Upward,
+  Downward,
+};
+
+// IEEE-754 exception flags, accumulated in FloatEnvironment::flags
+enum FloatException : std::uint8_t {
+  FloatInvalid = 1 << 0,
+  FloatDivideByZero = 1 << 1,
+  FloatOverflow = 1 << 2,
+  FloatUnderflow = 1 << 3,
+  FloatInexact = 1 << 4,
+};
+
+struct FloatEnvironment {
+  RoundingMode rounding = RoundingMode::NearestEven;
+  std::uint8_t flags = 0;
+};
+
+// Correctly rounded binary32 addition and subtraction on bit patterns.
+// NaN results follow x86 SSE: the first NaN operand, quieted, or the
+// default NaN 0xFFC00000 for invalid operations. Tininess is detected after
+// rounding, also like x86.
+std::uint32_t softFloatAdd(std::uint32_t a, std::uint32_t b,
+                           FloatEnvironment &environment);
+std::uint32_t softFloatSubtract(std::uint32_t a, std::uint32_t b,
+                                FloatEnvironment &environment);
+std::uint32_t softFloatMultiply(std::uint32_t a, std::uint32_t b,
+                                FloatEnvironment &environment);
+// Division by zero raises FloatDivideByZero, 0 / 0 and inf / inf are invalid
+std::uint32_t softFloatDivide(std::uint32_t a, std::uint32_t b,
+                              FloatEnvironment &environment);
+// sqrt(-0) is -0; other negative operands are invalid
+std::uint32_t softFloatSquareRoot(std::uint32_t a,
+                                  FloatEnvironment &environment);
+// a * b + c with a single rounding
+std::uint32_t softFloatFusedMultiplyAdd(std::uint32_t a, std::uint32_t b,
+                                        std::uint32_t c,
+                                        FloatEnvironment &environment);
+
+// Element-wise kernels over arrays of bit patterns, bit for bit equal to
+// the scalar functions above. Flags accumulate over the whole batch. false
+// if the spans differ in size.
+bool softFloatAdd(std::span<const std::uint32_t> a,
+                  std::span<const std::uint32_t> b,
+                  std::span<std::uint32_t> out, FloatEnvironment &environment);
+bool softFloatSubtract(std::span<const std::uint32_t> a,
+                       std::span<const std::uint32_t> b,
+                       std::span<std::uint32_t> out,
+                       FloatEnvironment &environment);
+bool softFloatMultiply(std::span<const std::uint32_t> a,
+                       std::span<const std::uint32_t> b,
+                       std::span<std::uint32_t> out,
+                       FloatEnvironment &environment);
+bool softFloatDivide(std::span<const std::uint32_t> a,
+                     std::span<const std::uint32_t> b,
+                     std::span<std::uint32_t> out,
+                     FloatEnvironment &environment);
+bool softFloatSquareRoot(std::span<const std::uint32_t> a,
+                         std::span<std::uint32_t> out,
+                         FloatEnvironment &environment);
+bool softFloatFusedMultiplyAdd(std::span<const std::uint32_t> a,
+                               std::span<const std::uint32_t> b,
+                               std::span<const std::uint32_t> c,
+                               std::span<std::uint32_t> out,
+                               FloatEnvironment &environment);
+} // namespace SCO
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <bit>
+#include <cfenv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <print>
+#include <random>
+#include <vector>
+
+#include "appendixB_problem9_softfloat.hpp"
+#include "gtest/gtest.h"
+
+namespace SCO {
+namespace {
+constexpr std::pair<RoundingMode, int> hardwareRoundingModes[] = {
+    {RoundingMode::NearestEven, FE_TONEAREST},
+    {RoundingMode::TowardZero, FE_TOWARDZERO},
+    {RoundingMode::Upward, FE_UPWARD},
+    {RoundingMode::Downward, FE_DOWNWARD},
+};
+
+enum class Operation { Add, Subtract, Multiply, Divide, SquareRoot, Fma };
+
+constexpr Operation operations[] = {
+    Operation::Add,    Operation::Subtract,   Operation::Multiply,
+    Operation::Divide, Operation::SquareRoot, Operation::Fma};
+
+// Out of line and through volatile so the compiler neither folds the
+// operation nor moves it across fesetround
+[[gnu::noinline]] std::uint32_t hardware(Operation operation,
+                                         std::uint32_t a, std::uint32_t b,
+                                         std::uint32_t c) {
+  volatile float x = std::bit_cast<float>(a);
+  volatile float y = std::bit_cast<float>(b);
+  volatile float z = std::bit_cast<float>(c);
+  volatile float result;
+  switch (operation) {
+  case Operation::Add:
+    result = x + y;
+    break;
+  case Operation::Subtract:
+    result = x - y;
+    break;
+  case Operation::Multiply:
+    result = x * y;
+    break;
+  case Operation::Divide:
+    result = x / y;
+    break;
+  case Operation::SquareRoot:
+    result = std::sqrt(static_cast<float>(x));
+    break;
+  case Operation::Fma:
+    result = std::fma(static_cast<float>(x), static_cast<float>(y),
+                      static_cast<float>(z));
+    break;
+  }
+  return std::bit_cast<std::uint32_t>(static_cast<float>(result));
+}
+
+std::uint32_t soft(Operation operation, std::uint32_t a, std::uint32_t b,
+                   std::uint32_t c, FloatEnvironment &environment) {
+  switch (operation) {
+  case Operation::Add:
+    return softFloatAdd(a, b, environment);
+  case Operation::Subtract:
+    return softFloatSubtract(a, b, environment);
+  case Operation::Multiply:
+    return softFloatMultiply(a, b, environment);
+  case Operation::Divide:
+    return softFloatDivide(a, b, environment);
+  case Operation::SquareRoot:
+    return softFloatSquareRoot(a, environment);
+  case Operation::Fma:
+    return softFloatFusedMultiplyAdd(a, b, c, environment);
+  }
+  return 0;
+}
+
+bool softBatch(Operation operation, std::span<const std::uint32_t> a,
+               std::span<const std::uint32_t> b,
+               std::span<const std::uint32_t> c, std::span<std::uint32_t> out,
+               FloatEnvironment &environment) {
+  switch (operation) {
+  case Operation::Add:
+    return softFloatAdd(a, b, out, environment);
+  case Operation::Subtract:
+    return softFloatSubtract(a, b, out, environment);
+  case Operation::Multiply:
+    return softFloatMultiply(a, b, out, environment);
+  case Operation::Divide:
+    return softFloatDivide(a, b, out, environment);
+  case Operation::SquareRoot:
+    return softFloatSquareRoot(a, out, environment);
+  case Operation::Fma:
+    return softFloatFusedMultiplyAdd(a, b, c, out, environment);
+  }
+  return false;
+}
+
+bool isNaN(std::uint32_t a) { return (a & 0x7FFFFFFF) > 0x7F800000; }
+
+std::uint8_t hardwareFlags() {
+  const int raised = std::fetestexcept(FE_ALL_EXCEPT);
+  return ((raised & FE_INVALID) ? FloatInvalid : 0) |
+         ((raised & FE_DIVBYZERO) ? FloatDivideByZero : 0) |
+         ((raised & FE_OVERFLOW) ? FloatOverflow : 0) |
+         ((raised & FE_UNDERFLOW) ? FloatUnderflow : 0) |
+         ((raised & FE_INEXACT) ? FloatInexact : 0);
+}
+
+// Operands biased towards the interesting cases: specials, subnormals,
+// equal and nearby exponents for cancellation
+std::uint32_t randomOperand(std::mt19937 &generator, std::uint32_t other) {
+  static constexpr std::uint32_t specials[] = {
+      0x00000000, 0x80000000, 0x7F800000, 0xFF800000, 0x7FC00000,
+      0x7FA00000, 0xFFC12345, 0x00000001, 0x007FFFFF, 0x00800000,
+      0x7F7FFFFF, 0xFF7FFFFF, 0x3F800000, 0x33800000, 0x4B000000};
+  const std::uint32_t bits = generator();
+  switch (generator() % 6) {
+  case 0:
+    return specials[generator() % std::size(specials)];
+  case 1:
+    return bits & 0x807FFFFF; // Subnormal
+  case 2:
+    return (bits & 0x807FFFFF) | (other & 0x7F800000); // Same exponent
+  case 3: {
+    // Exponent within 26 of the other operand's
+    const int exponent = static_cast<int>((other >> 23) & 0xFF) +
+                         static_cast<int>(generator() % 53) - 26;
+    return (bits & 0x807FFFFF) |
+           (static_cast<std::uint32_t>(std::clamp(exponent, 0, 254)) << 23);
+  }
+  default:
+    return bits;
+  }
+}
+} // namespace
+
+TEST(SoftFloatTest, SpecialCases) {
+  FloatEnvironment environment;
+  EXPECT_EQ(softFloatAdd(0x7F800000, 0xFF800000, environment), 0xFFC00000);
+  EXPECT_EQ(environment.flags, FloatInvalid);
+
+  environment.flags = 0;
+  EXPECT_EQ(softFloatAdd(0x7FA00000, 0x3F800000, environment), 0x7FE00000);
+  EXPECT_EQ(environment.flags, FloatInvalid);
+
+  environment.flags = 0;
+  EXPECT_EQ(softFloatSubtract(0x3F800000, 0x7FC00001, environment),
+            0x7FC00001);
+  EXPECT_EQ(environment.flags, 0);
+
+  EXPECT_EQ(softFloatSubtract(0x3F800000, 0x3F800000, environment), 0);
+  EXPECT_EQ(softFloatAdd(0x80000000, 0x80000000, environment), 0x80000000);
+  environment.rounding = RoundingMode::Downward;
+  EXPECT_EQ(softFloatSubtract(0x3F800000, 0x3F800000, environment),
+            0x80000000);
+
+  // Largest finite plus half an ulp overflows only when rounding up
+  environment = {};
+  EXPECT_EQ(softFloatAdd(0x7F7FFFFF, 0x73000000, environment), 0x7F800000);
+  EXPECT_EQ(environment.flags, FloatOverflow | FloatInexact);
+  environment = {RoundingMode::TowardZero, 0};
+  EXPECT_EQ(softFloatAdd(0x7F7FFFFF, 0x73000000, environment), 0x7F7FFFFF);
+
+  // 1 + 2^-24 is a tie: even goes down, away goes up
+  environment = {};
+  EXPECT_EQ(softFloatAdd(0x3F800000, 0x33800000, environment), 0x3F800000);
+  environment = {RoundingMode::NearestAway, 0};
+  EXPECT_EQ(softFloatAdd(0x3F800000, 0x33800000, environment), 0x3F800001);
+}
+
+TEST(SoftFloatTest, MatchesHardware) {
+#if not(defined(__x86_64__) or defined(__i386__))
+  GTEST_SKIP() << "NaN results and tininess detection follow x86";
+#endif
+  std::mt19937 generator(43);
+  const int savedRounding = std::fegetround();
+  for (Operation operation : operations) {
+    for (auto [rounding, hardwareRounding] : hardwareRoundingModes) {
+      ASSERT_EQ(std::fesetround(hardwareRounding), 0);
+      std::size_t mismatches = 0;
+      for (int sample = 0; sample < 200'000 and mismatches < 10; sample++) {
+        const std::uint32_t a = generator();
+        const std::uint32_t b = randomOperand(generator, a);
+        // The addend near the product's magnitude makes fma cancel
+        const std::uint32_t c = randomOperand(
+            generator, std::bit_cast<std::uint32_t>(
+                           std::bit_cast<float>(a) * std::bit_cast<float>(b)));
+
+        std::feclearexcept(FE_ALL_EXCEPT);
+        const std::uint32_t expected = hardware(operation, a, b, c);
+        const std::uint8_t expectedFlags = hardwareFlags();
+
+        FloatEnvironment environment{rounding, 0};
+        const std::uint32_t result = soft(operation, a, b, c, environment);
+
+        // Which NaN an fma returns depends on the instruction form the
+        // compiler picked, and so does invalid for inf * 0 + NaN
+        const bool anyNaN = isNaN(a) or isNaN(b) or isNaN(c);
+        const bool matches =
+            operation == Operation::Fma and anyNaN
+                ? isNaN(result) and isNaN(expected)
+                : result == expected and environment.flags == expectedFlags;
+        if (not matches) {
+          mismatches++;
+          ADD_FAILURE() << std::hex << "operation "
+                        << static_cast<int>(operation) << " on " << a << ", "
+                        << b << ", " << c << " rounding "
+                        << static_cast<int>(rounding) << ": got " << result
+                        << " flags " << int(environment.flags)
+                        << ", expected " << expected << " flags "
+                        << int(expectedFlags);
+        }
+      }
+    }
+  }
+  std::fesetround(savedRounding);
+}
+
+TEST(SoftFloatTest, BatchMatchesScalar) {
+  std::mt19937 generator(44);
+  // Not a multiple of the vector width, so the scalar tail runs too
+  constexpr std::size_t size = 10'003;
+  std::vector<std::uint32_t> a(size);
+  std::vector<std::uint32_t> b(size);
+  std::vector<std::uint32_t> c(size);
+  for (std::size_t i = 0; i < size; i++) {
+    a[i] = generator();
+    b[i] = randomOperand(generator, a[i]);
+    c[i] = randomOperand(generator, a[i]);
+    if (i % 8 == 0) {
+      // fma cancels down to the rounding error of the product
+      FloatEnvironment scratch;
+      c[i] = softFloatMultiply(a[i], b[i], scratch) ^ 0x80000000;
+    }
+  }
+
+  std::vector<std::uint32_t> out(size);
+  for (Operation operation : operations) {
+    for (auto [rounding, hardwareRounding] : hardwareRoundingModes) {
+      FloatEnvironment batchEnvironment{rounding, 0};
+      ASSERT_TRUE(softBatch(operation, a, b, c, out, batchEnvironment));
+
+      FloatEnvironment environment{rounding, 0};
+      for (std::size_t i = 0; i < size; i++) {
+        ASSERT_EQ(out[i], soft(operation, a[i], b[i], c[i], environment))
+            << "operation " << static_cast<int>(operation) << " lane " << i;
+      }
+      EXPECT_EQ(batchEnvironment.flags, environment.flags);
+    }
+  }
+
+  FloatEnvironment environment;
+  EXPECT_FALSE(softFloatAdd(a, std::span(b).first(10), out, environment));
+  EXPECT_FALSE(softFloatSquareRoot(a, std::span(out).first(10), environment));
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SoftFloatTest, DISABLED_BatchBenchmark) {
+  std::mt19937 generator(45);
+  using Clock = std::chrono::steady_clock;
+  constexpr std::size_t size = 1 << 20;
+
+  // Normal operands that stay normal, and random bit patterns that mix in
+  // the specials and subnormals
+  std::vector<std::uint32_t> normal(3 * size);
+  std::vector<std::uint32_t> mixed(3 * size);
+  for (std::size_t i = 0; i < 3 * size; i++) {
+    normal[i] = (generator() & 0x807FFFFF) | ((100 + generator() % 56) << 23);
+    mixed[i] = generator();
+  }
+
+  constexpr const char *names[] = {"add", "subtract", "multiply",
+                                   "divide", "sqrt", "fma"};
+  std::vector<std::uint32_t> out(size);
+  std::print("{:>10} {:>14} {:>14} {:>14} {:>14} {:>8}\n", "Mops/s",
+             "scalar normal", "batch normal", "scalar mixed", "batch mixed",
+             "speedup");
+  for (Operation operation : operations) {
+    std::print("{:>10}", names[static_cast<int>(operation)]);
+    double mops[4];
+    for (int run = 0; run < 4; run++) {
+      std::span<const std::uint32_t> operands = run >= 2 ? mixed : normal;
+      auto a = operands.first(size);
+      auto b = operands.subspan(size, size);
+      auto c = operands.subspan(2 * size, size);
+      FloatEnvironment environment;
+      auto start = Clock::now();
+      if (run % 2 == 0) {
+        for (std::size_t i = 0; i < size; i++) {
+          out[i] = soft(operation, a[i], b[i], c[i], environment);
+        }
+      } else {
+        softBatch(operation, a, b, c, out, environment);
+      }
+      std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+      mops[run] = size / elapsed.count();
+      std::print(" {:>14.1f}", mops[run]);
+    }
+    std::print(" {:>7.1f}x\n", mops[1] / mops[0]);
+  }
+}
+} // namespace SCO
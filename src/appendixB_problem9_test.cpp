@@ -13,4 +13,17 @@ TEST(AppendixBProblem9, TestSum) {
   EXPECT_FLOAT_EQ(sum(-1.0f, 0.0f), -1.0f);
   EXPECT_FLOAT_EQ(sum(0.0f, -1.0f), -1.0f);
 }
-} // namespace SCO
\ No newline at end of file
+
+TEST(AppendixBProblem9, BitStrings) {
+  EXPECT_EQ(toBitString(1.5f), "00111111110000000000000000000000");
+  EXPECT_EQ(toBitString(-0.0f), "10000000000000000000000000000000");
+  EXPECT_EQ(fromBitString("01000000001000000000000000000000"), 2.5f);
+
+  for (float num : {0.1f, -3.75e-20f, 1e30f}) {
+    EXPECT_EQ(fromBitString(toBitString(num)), num);
+  }
+
+  EXPECT_FALSE(fromBitString("0100000000100000000000000000000").has_value());
+  EXPECT_FALSE(fromBitString("0100000000100000000000000000000x").has_value());
+}
+} // namespace SCO
@@ -0,0 +1,180 @@
+#include "appendixB_problem9_verify.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace SCO {
+namespace {
+constexpr std::uint32_t magnitudeMask = 0x7FFFFFFF;
+constexpr std::uint32_t infinity = 0x7F800000;
+constexpr std::uint32_t maxFinite = 0x7F7FFFFF;
+constexpr std::uint32_t minNormal = 0x00800000;
+
+// First operands per chunk of the exhaustive sweep, and pairs per chunk of
+// the random one: small enough to balance, large enough that the shared
+// counter is rarely touched
+constexpr std::uint64_t exhaustiveChunk = 1 << 16;
+constexpr std::uint64_t randomChunk = 1 << 20;
+
+std::uint64_t splitMix64(std::uint64_t &state) {
+  std::uint64_t z = (state += 0x9E3779B97F4A7C15);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+  return z ^ (z >> 31);
+}
+
+void check(FloatAdder adder, std::uint32_t a, std::uint32_t b,
+           AdderVerification &verification) {
+  const float x = std::bit_cast<float>(a);
+  const float y = std::bit_cast<float>(b);
+  const auto expected = std::bit_cast<std::uint32_t>(x + y);
+  const auto actual = std::bit_cast<std::uint32_t>(adder(x, y));
+  if (expected == actual) {
+    return;
+  }
+
+  const AdderMismatch mismatch{a, b, expected, actual};
+  const auto category =
+      static_cast<std::size_t>(categorizeMismatch(mismatch));
+  verification.numMismatches[category]++;
+  if (verification.examples[category].size() < maxAdderMismatchExamples) {
+    verification.examples[category].push_back(mismatch);
+  }
+}
+
+void merge(AdderVerification &into, const AdderVerification &from) {
+  into.numPairs += from.numPairs;
+  for (std::size_t c = 0; c < numAdderMismatchCategories; c++) {
+    into.numMismatches[c] += from.numMismatches[c];
+    for (const auto &example : from.examples[c]) {
+      if (into.examples[c].size() < maxAdderMismatchExamples) {
+        into.examples[c].push_back(example);
+      }
+    }
+  }
+}
+
+// Hands out chunks from a shared counter and merges each thread's results
+// once at the end. Counts do not depend on scheduling, but which mismatches
+// make it into the examples can.
+template <typename CheckChunk>
+AdderVerification runChunks(std::uint64_t numChunks, unsigned numThreads,
+                            CheckChunk checkChunk) {
+  if (numThreads == 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  numThreads = static_cast<unsigned>(std::min<std::uint64_t>(
+      numThreads, std::max<std::uint64_t>(1, numChunks)));
+
+  std::atomic<std::uint64_t> nextChunk = 0;
+  std::mutex resultMutex;
+  AdderVerification result;
+  auto worker = [&] {
+    AdderVerification local;
+    for (std::uint64_t chunk = nextChunk++; chunk < numChunks;
+         chunk = nextChunk++) {
+      checkChunk(chunk, local);
+    }
+    std::lock_guard lock(resultMutex);
+    merge(result, local);
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < numThreads; t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (auto &examples : result.examples) {
+    std::ranges::sort(examples, {}, [](const AdderMismatch &mismatch) {
+      return std::pair{mismatch.a, mismatch.b};
+    });
+  }
+  return result;
+}
+} // namespace
+
+std::uint64_t AdderVerification::totalMismatches() const {
+  std::uint64_t total = 0;
+  for (std::uint64_t count : numMismatches) {
+    total += count;
+  }
+  return total;
+}
+
+AdderMismatchCategory categorizeMismatch(const AdderMismatch &mismatch) {
+  const std::uint32_t magnitudes[] = {
+      mismatch.a & magnitudeMask, mismatch.b & magnitudeMask,
+      mismatch.expected & magnitudeMask, mismatch.actual & magnitudeMask};
+  const std::uint32_t expected = magnitudes[2];
+  const std::uint32_t actual = magnitudes[3];
+
+  if (expected > infinity or actual > infinity) {
+    return AdderMismatchCategory::NaN;
+  }
+  if (std::ranges::any_of(magnitudes,
+                          [](std::uint32_t m) { return m >= maxFinite; })) {
+    return AdderMismatchCategory::Overflow;
+  }
+  if (expected == 0 and actual == 0) {
+    return AdderMismatchCategory::SignedZero;
+  }
+  // Zero is not subnormal, so a normal sum with a zero operand is not one
+  if (std::ranges::any_of(magnitudes, [](std::uint32_t m) {
+        return m != 0 and m < minNormal;
+      })) {
+    return AdderMismatchCategory::Subnormal;
+  }
+  const bool sameSign = ((mismatch.expected ^ mismatch.actual) >> 31) == 0;
+  const std::uint32_t ulps =
+      std::max(expected, actual) - std::min(expected, actual);
+  if (sameSign and ulps == 1) {
+    return AdderMismatchCategory::Rounding;
+  }
+  return AdderMismatchCategory::Other;
+}
+
+AdderVerification verifyAdderExhaustive(FloatAdder adder,
+                                        std::span<const float> bValues,
+                                        unsigned numThreads) {
+  constexpr std::uint64_t numValues = std::uint64_t{1} << 32;
+  return runChunks(
+      numValues / exhaustiveChunk, numThreads,
+      [&](std::uint64_t chunk, AdderVerification &verification) {
+        const std::uint64_t begin = chunk * exhaustiveChunk;
+        for (std::uint64_t a = begin; a < begin + exhaustiveChunk; a++) {
+          for (float b : bValues) {
+            check(adder, static_cast<std::uint32_t>(a),
+                  std::bit_cast<std::uint32_t>(b), verification);
+          }
+        }
+        verification.numPairs += exhaustiveChunk * bValues.size();
+      });
+}
+
+AdderVerification verifyAdderRandom(FloatAdder adder, std::uint64_t numPairs,
+                                    std::uint64_t seed, unsigned numThreads) {
+  return runChunks(
+      (numPairs + randomChunk - 1) / randomChunk, numThreads,
+      [&](std::uint64_t chunk, AdderVerification &verification) {
+        // Each chunk has its own stream, so the pairs are the same however
+        // the chunks are spread over threads
+        std::uint64_t state = seed ^ (chunk * 0xD1B54A32D192ED03);
+        const std::uint64_t size =
+            std::min(randomChunk, numPairs - chunk * randomChunk);
+        for (std::uint64_t i = 0; i < size; i++) {
+          const std::uint64_t bits = splitMix64(state);
+          check(adder, static_cast<std::uint32_t>(bits),
+                static_cast<std::uint32_t>(bits >> 32), verification);
+        }
+        verification.numPairs += size;
+      });
+}
+} // namespace SCO
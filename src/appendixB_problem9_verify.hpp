@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SCO {
+enum class AdderMismatchCategory : std::uint8_t {
+  // Off by one unit in the last place between normal results
+  Rounding = 0,
+  // A subnormal operand or result, or an underflow to zero
+  Subnormal,
+  // An infinite operand or result, or the largest finite value
+  Overflow,
+  // A NaN on one side but not the other, or a different NaN
+  NaN,
+  // +0 against -0
+  SignedZero,
+  Other,
+};
+
+inline constexpr std::size_t numAdderMismatchCategories = 6;
+// Mismatches kept per category as examples; all of them are counted
+inline constexpr std::size_t maxAdderMismatchExamples = 8;
+
+struct AdderMismatch {
+  std::uint32_t a;
+  std::uint32_t b;
+  std::uint32_t expected;
+  std::uint32_t actual;
+};
+
+struct AdderVerification {
+  std::uint64_t numPairs = 0;
+  std::array<std::uint64_t, numAdderMismatchCategories> numMismatches{};
+  std::array<std::vector<AdderMismatch>, numAdderMismatchCategories>
+      examples;
+
+  std::uint64_t totalMismatches() const;
+};
+
+using FloatAdder = float (*)(float, float);
+
+AdderMismatchCategory categorizeMismatch(const AdderMismatch &mismatch);
+
+// Compares adder against native float addition bit for bit, with every
+// one of the 2^32 bit patterns as the first operand against each of
+// bValues. Work is spread over numThreads threads, or all cores for 0.
+AdderVerification verifyAdderExhaustive(FloatAdder adder,
+                                        std::span<const float> bValues,
+                                        unsigned numThreads = 0);
+
+// numPairs uniformly random pairs of bit patterns. The pairs depend only on
+// seed, not on the number of threads.
+AdderVerification verifyAdderRandom(FloatAdder adder, std::uint64_t numPairs,
+                                    std::uint64_t seed,
+                                    unsigned numThreads = 0);
+} // namespace SCO
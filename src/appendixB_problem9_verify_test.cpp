@@ -0,0 +1,144 @@
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <print>
+#include <vector>
+
+#include "appendixB_problem9.hpp"
+#include "appendixB_problem9_softfloat.hpp"
+#include "appendixB_problem9_verify.hpp"
+#include "gtest/gtest.h"
+
+namespace SCO {
+namespace {
+float softAdd(float a, float b) {
+  FloatEnvironment environment;
+  return std::bit_cast<float>(softFloatAdd(std::bit_cast<std::uint32_t>(a),
+                                           std::bit_cast<std::uint32_t>(b),
+                                           environment));
+}
+
+// Adders with deliberate bugs the harness has to find and file correctly
+float truncatingAdd(float a, float b) {
+  FloatEnvironment environment{RoundingMode::TowardZero, 0};
+  return std::bit_cast<float>(softFloatAdd(std::bit_cast<std::uint32_t>(a),
+                                           std::bit_cast<std::uint32_t>(b),
+                                           environment));
+}
+
+float flushingAdd(float a, float b) {
+  const float result = a + b;
+  return std::fpclassify(result) == FP_SUBNORMAL ? 0.0f : result;
+}
+
+std::uint64_t mismatches(const AdderVerification &verification,
+                         AdderMismatchCategory category) {
+  return verification.numMismatches[static_cast<std::size_t>(category)];
+}
+
+// Every fifth exponent with both signs and a few fractions, including the
+// zeros, subnormals, infinities and NaNs: the second operands of the
+// exhaustive sweep
+std::vector<float> sampledOperands() {
+  std::vector<float> values;
+  for (std::uint32_t exponent = 0; exponent < 256; exponent += 5) {
+    for (std::uint32_t fraction : {0u, 1u, 0x400000u, 0x7FFFFFu}) {
+      const std::uint32_t bits = (exponent << 23) | fraction;
+      values.push_back(std::bit_cast<float>(bits));
+      values.push_back(std::bit_cast<float>(bits | 0x80000000));
+    }
+  }
+  return values;
+}
+} // namespace
+
+TEST(AdderVerificationTest, CategorizesMismatches) {
+  auto category = [](std::uint32_t a, std::uint32_t b, std::uint32_t expected,
+                     std::uint32_t actual) {
+    return categorizeMismatch({a, b, expected, actual});
+  };
+  EXPECT_EQ(category(0x3F800000, 0x33800001, 0x3F800001, 0x3F800000),
+            AdderMismatchCategory::Rounding);
+  // A zero operand does not make a normal mismatch subnormal
+  EXPECT_EQ(category(0x3F800000, 0x00000000, 0x3F800000, 0x3F800001),
+            AdderMismatchCategory::Rounding);
+  EXPECT_EQ(category(0x3F800000, 0x80000000, 0x3F800000, 0x40000000),
+            AdderMismatchCategory::Other);
+  EXPECT_EQ(category(0x00000001, 0x00000001, 0x00000002, 0x00000000),
+            AdderMismatchCategory::Subnormal);
+  EXPECT_EQ(category(0x7F7FFFFF, 0x73800000, 0x7F800000, 0x7F7FFFFF),
+            AdderMismatchCategory::Overflow);
+  EXPECT_EQ(category(0x7FC00000, 0x3F800000, 0x7FC00000, 0x3F800000),
+            AdderMismatchCategory::NaN);
+  EXPECT_EQ(category(0x3F800000, 0xBF800000, 0x00000000, 0x80000000),
+            AdderMismatchCategory::SignedZero);
+  EXPECT_EQ(category(0x3F800000, 0x3F800000, 0x40000000, 0x3F800000),
+            AdderMismatchCategory::Other);
+}
+
+TEST(AdderVerificationTest, FindsInjectedBugs) {
+  const AdderVerification correct = verifyAdderRandom(softAdd, 3'000'000, 1, 2);
+  EXPECT_EQ(correct.numPairs, 3'000'000u);
+  EXPECT_EQ(correct.totalMismatches(), 0u);
+
+  const AdderVerification truncating =
+      verifyAdderRandom(truncatingAdd, 1'000'000, 1, 3);
+  EXPECT_GT(mismatches(truncating, AdderMismatchCategory::Rounding), 10'000u);
+  EXPECT_EQ(mismatches(truncating, AdderMismatchCategory::Other), 0u);
+  EXPECT_LE(truncating.examples[0].size(), maxAdderMismatchExamples);
+
+  const AdderVerification flushing =
+      verifyAdderRandom(flushingAdd, 3'000'000, 2);
+  EXPECT_GT(mismatches(flushing, AdderMismatchCategory::Subnormal), 0u);
+  EXPECT_EQ(flushing.totalMismatches(),
+            mismatches(flushing, AdderMismatchCategory::Subnormal) +
+                mismatches(flushing, AdderMismatchCategory::SignedZero));
+
+  // Same pairs however they are split over threads
+  const AdderVerification oneThread =
+      verifyAdderRandom(truncatingAdd, 1'000'000, 1, 1);
+  EXPECT_EQ(oneThread.numMismatches, truncating.numMismatches);
+}
+
+TEST(AdderVerificationTest, SumMatchesNativeAddition) {
+#if SCO_TRACE_SUM
+  GTEST_SKIP() << "sum() prints every step; build with SCO_TRACE_SUM=0";
+#endif
+  const AdderVerification verification =
+      verifyAdderRandom(sum, 10'000'000, 42);
+  EXPECT_EQ(verification.totalMismatches(), 0u);
+}
+
+// Run with --gtest_also_run_disabled_tests and SCO_TRACE_SUM=0. All 2^32
+// first operands against a few hundred second operands, then 2^32 random
+// pairs, on every core.
+TEST(AdderVerificationTest, DISABLED_ExhaustiveBenchmark) {
+#if SCO_TRACE_SUM
+  GTEST_SKIP() << "sum() prints every step; build with SCO_TRACE_SUM=0";
+#endif
+  using Clock = std::chrono::steady_clock;
+  const std::vector<float> operands = sampledOperands();
+  constexpr const char *names[] = {"rounding", "subnormal",   "overflow",
+                                   "NaN",      "signed zero", "other"};
+
+  for (int run = 0; run < 2; run++) {
+    auto start = Clock::now();
+    const AdderVerification verification =
+        run == 0 ? verifyAdderExhaustive(sum, operands)
+                 : verifyAdderRandom(sum, std::uint64_t{1} << 32, 42);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    std::print("{}: {} pairs in {:.1f} s, {:.1f} M pairs/s, {} mismatches\n",
+               run == 0 ? "exhaustive" : "random", verification.numPairs,
+               elapsed.count(), verification.numPairs / elapsed.count() / 1e6,
+               verification.totalMismatches());
+    for (std::size_t c = 0; c < numAdderMismatchCategories; c++) {
+      for (const AdderMismatch &mismatch : verification.examples[c]) {
+        std::print("  {}: {:08x} + {:08x} = {:08x}, got {:08x}\n", names[c],
+                   mismatch.a, mismatch.b, mismatch.expected,
+                   mismatch.actual);
+      }
+    }
+    EXPECT_EQ(verification.totalMismatches(), 0u);
+  }
+}
+} // namespace SCO
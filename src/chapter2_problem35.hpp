@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <print>
+#include <span>
+#include <vector>
 
 namespace SCO {
 template <typename T> T getBit(T num, std::size_t pos) {
@@ -10,4 +12,40 @@ template <typename T> T getBit(T num, std::size_t pos) {
 
 // Chapter 2 - Problem 35
 std::int16_t hamming(char ascii);
+
+// Batch form of hamming(): output[i] is the codeword of input[i], whose high
+// bit is ignored like hamming() does. Returns false if output is smaller
+// than input.
+bool hammingEncode(std::span<const std::uint8_t> input,
+                   std::span<std::uint16_t> output);
+std::vector<std::uint16_t> hammingEncode(std::span<const std::uint8_t> input);
+
+enum class HammingDecodeStatus : std::uint8_t {
+  NoError = 0,
+  Corrected,
+  // For hamming() codewords: the syndrome names no bit of the codeword, or
+  // bits above the 11-bit codeword are set. Two flipped bits usually look
+  // like a correctable single error instead and are miscorrected, which
+  // SECDEDCodec detects.
+  Uncorrectable,
+};
+
+struct HammingDecodeResult {
+  std::uint8_t ascii = 0;
+  HammingDecodeStatus status = HammingDecodeStatus::NoError;
+};
+
+struct HammingDecodeStatistics {
+  std::size_t corrected = 0;
+  std::size_t uncorrectable = 0;
+};
+
+// Inverse of hamming(), correcting a single flipped bit. Uncorrectable
+// codewords decode to their data bits as received.
+HammingDecodeResult hammingDecode(std::uint16_t codeword);
+// Batch form of hammingDecode(). Returns false if output is smaller than
+// input.
+bool hammingDecode(std::span<const std::uint16_t> input,
+                   std::span<std::uint8_t> output,
+                   HammingDecodeStatistics *statistics = nullptr);
 } // namespace SCO
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "chapter2_problem35.hpp"
+
+namespace SCO {
+// Hamming code extended with an overall parity bit (SECDED) for DataBits-bit
+// words. Like ECC memory, the data bits are stored as is and the check bits
+// next to them: check bit j is the parity of the data bits whose Hamming
+// position has bit j set, and the last check bit the parity of everything.
+// The masks are computed at compile time, so encoding is one popcount per
+// check bit and data word.
+template <std::size_t DataBits> struct SECDEDCodec {
+  static constexpr std::size_t dataBits = DataBits;
+  static constexpr std::size_t numWords = (DataBits + 63) / 64;
+  // Smallest r with 2^r >= DataBits + r + 1
+  static constexpr std::size_t numHammingBits = [] {
+    std::size_t r = 1;
+    while ((std::size_t{1} << r) < DataBits + r + 1) {
+      r++;
+    }
+    return r;
+  }();
+  static constexpr std::size_t numCheckBits = numHammingBits + 1;
+  static constexpr std::size_t codewordBits = DataBits + numCheckBits;
+
+  static_assert(DataBits > 0);
+  static_assert(numCheckBits <= 16);
+
+  // Bits past DataBits must be clear
+  using Data = std::array<std::uint64_t, numWords>;
+
+  struct Codeword {
+    Data data{};
+    std::uint16_t check = 0;
+
+    bool operator==(const Codeword &) const = default;
+  };
+
+  struct DecodeResult {
+    Data data{};
+    HammingDecodeStatus status = HammingDecodeStatus::NoError;
+  };
+
+  // Hamming position (counting from 1, skipping powers of two) of each data
+  // bit, and the data bit at each position or -1 for check positions
+  static constexpr std::array<std::uint16_t, DataBits> positions = [] {
+    std::array<std::uint16_t, DataBits> result{};
+    std::uint16_t position = 1;
+    for (auto &dataPosition : result) {
+      position++;
+      while (std::has_single_bit(position)) {
+        position++;
+      }
+      dataPosition = position;
+    }
+    return result;
+  }();
+  static constexpr std::array<std::int32_t, std::size_t{1} << numHammingBits>
+      dataBitByPosition = [] {
+        std::array<std::int32_t, std::size_t{1} << numHammingBits> result{};
+        result.fill(-1);
+        for (std::size_t i = 0; i < DataBits; i++) {
+          result[positions[i]] = static_cast<std::int32_t>(i);
+        }
+        return result;
+      }();
+  static constexpr std::array<Data, numHammingBits> parityMasks = [] {
+    std::array<Data, numHammingBits> result{};
+    for (std::size_t j = 0; j < numHammingBits; j++) {
+      for (std::size_t i = 0; i < DataBits; i++) {
+        if ((positions[i] >> j) & 1) {
+          result[j][i / 64] |= std::uint64_t{1} << (i % 64);
+        }
+      }
+    }
+    return result;
+  }();
+
+  static constexpr std::uint16_t hammingCheckBits(const Data &data);
+  static constexpr Codeword encode(const Data &data);
+  // Corrects any single flipped bit, including check bits, and reports two
+  // flipped bits as uncorrectable
+  static constexpr DecodeResult decode(const Codeword &codeword);
+};
+
+using SECDED39_32 = SECDEDCodec<32>;
+using SECDED72_64 = SECDEDCodec<64>;
+using SECDED137_128 = SECDEDCodec<128>;
+
+template <std::size_t DataBits>
+constexpr std::uint16_t
+SECDEDCodec<DataBits>::hammingCheckBits(const Data &data) {
+  std::uint16_t check = 0;
+  for (std::size_t j = 0; j < numHammingBits; j++) {
+    int bitsSet = 0;
+    for (std::size_t w = 0; w < numWords; w++) {
+      bitsSet += std::popcount(data[w] & parityMasks[j][w]);
+    }
+    check |= static_cast<std::uint16_t>((bitsSet & 1) << j);
+  }
+  return check;
+}
+
+template <std::size_t DataBits>
+constexpr auto SECDEDCodec<DataBits>::encode(const Data &data) -> Codeword {
+  std::uint16_t check = hammingCheckBits(data);
+
+  int bitsSet = std::popcount(check);
+  for (std::size_t w = 0; w < numWords; w++) {
+    bitsSet += std::popcount(data[w]);
+  }
+  check |= static_cast<std::uint16_t>((bitsSet & 1) << numHammingBits);
+
+  return {data, check};
+}
+
+template <std::size_t DataBits>
+constexpr auto SECDEDCodec<DataBits>::decode(const Codeword &codeword)
+    -> DecodeResult {
+  const std::uint16_t hammingMask = (1u << numHammingBits) - 1;
+  const std::uint16_t syndrome =
+      (codeword.check ^ hammingCheckBits(codeword.data)) & hammingMask;
+
+  int bitsSet = std::popcount(codeword.check);
+  for (std::size_t w = 0; w < numWords; w++) {
+    bitsSet += std::popcount(codeword.data[w]);
+  }
+  const bool parityError = bitsSet & 1;
+
+  if (syndrome == 0 and not parityError) {
+    return {codeword.data, HammingDecodeStatus::NoError};
+  }
+  // An even number of flips with a non-zero syndrome
+  if (not parityError) {
+    return {codeword.data, HammingDecodeStatus::Uncorrectable};
+  }
+  // A single flip of the overall parity bit or of a Hamming check bit
+  if (syndrome == 0 or std::has_single_bit(syndrome)) {
+    return {codeword.data, HammingDecodeStatus::Corrected};
+  }
+
+  const std::int32_t dataBit = dataBitByPosition[syndrome];
+  if (dataBit < 0) {
+    // Position past the last data bit, so at least three bits flipped
+    return {codeword.data, HammingDecodeStatus::Uncorrectable};
+  }
+  DecodeResult result{codeword.data, HammingDecodeStatus::Corrected};
+  result.data[dataBit / 64] ^= std::uint64_t{1} << (dataBit % 64);
+  return result;
+}
+} // namespace SCO
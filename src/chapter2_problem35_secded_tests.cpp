@@ -0,0 +1,133 @@
+#include <chrono>
+#include <print>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "chapter2_problem35_secded.hpp"
+
+namespace SCO {
+static_assert(SECDED39_32::codewordBits == 39);
+static_assert(SECDED72_64::codewordBits == 72);
+static_assert(SECDED137_128::codewordBits == 137);
+static_assert(SECDED72_64::decode(SECDED72_64::encode({0x0123456789ABCDEF}))
+                  .data[0] == 0x0123456789ABCDEF);
+
+namespace {
+template <typename Codec>
+typename Codec::Data randomData(std::mt19937_64 &generator) {
+  typename Codec::Data data{};
+  for (std::size_t i = 0; i < Codec::numWords; i++) {
+    data[i] = generator();
+  }
+  if (Codec::dataBits % 64 != 0) {
+    data.back() &= (std::uint64_t{1} << (Codec::dataBits % 64)) - 1;
+  }
+  return data;
+}
+
+// Bits 0..DataBits-1 are data bits, the rest check bits
+template <typename Codec>
+void flipBit(typename Codec::Codeword &codeword, std::size_t bit) {
+  if (bit < Codec::dataBits) {
+    codeword.data[bit / 64] ^= std::uint64_t{1} << (bit % 64);
+  } else {
+    codeword.check ^=
+        static_cast<std::uint16_t>(1u << (bit - Codec::dataBits));
+  }
+}
+
+template <typename Codec> void checkSECDED() {
+  std::mt19937_64 generator(37);
+  for (int sample = 0; sample < 20; sample++) {
+    const auto data = randomData<Codec>(generator);
+    const auto codeword = Codec::encode(data);
+
+    auto result = Codec::decode(codeword);
+    EXPECT_EQ(result.data, data);
+    EXPECT_EQ(result.status, HammingDecodeStatus::NoError);
+
+    for (std::size_t i = 0; i < Codec::codewordBits; i++) {
+      auto corrupted = codeword;
+      flipBit<Codec>(corrupted, i);
+      result = Codec::decode(corrupted);
+      EXPECT_EQ(result.data, data) << "bit " << i;
+      EXPECT_EQ(result.status, HammingDecodeStatus::Corrected)
+          << "bit " << i;
+
+      for (std::size_t j = i + 1; j < Codec::codewordBits; j++) {
+        auto doubleCorrupted = corrupted;
+        flipBit<Codec>(doubleCorrupted, j);
+        EXPECT_EQ(Codec::decode(doubleCorrupted).status,
+                  HammingDecodeStatus::Uncorrectable)
+            << "bits " << i << " and " << j;
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(SECDEDTest, SECDED39_32) { checkSECDED<SECDED39_32>(); }
+TEST(SECDEDTest, SECDED72_64) { checkSECDED<SECDED72_64>(); }
+TEST(SECDEDTest, SECDED137_128) { checkSECDED<SECDED137_128>(); }
+
+TEST(SECDEDTest, SevenBitCodeMatchesHammingPositions) {
+  // With 7 data bits the Hamming part uses the same positions as hamming()
+  using Codec = SECDEDCodec<7>;
+  static_assert(Codec::numHammingBits == 4);
+  for (int ascii = 0; ascii < 128; ascii++) {
+    auto codeword =
+        static_cast<std::uint16_t>(hamming(static_cast<char>(ascii)));
+    std::uint16_t expectedCheck = ((codeword >> 0) & 1) |
+                                  (((codeword >> 1) & 1) << 1) |
+                                  (((codeword >> 3) & 1) << 2) |
+                                  (((codeword >> 7) & 1) << 3);
+    EXPECT_EQ(Codec::hammingCheckBits({std::uint64_t(ascii)}), expectedCheck);
+  }
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SECDEDTest, DISABLED_Benchmark) {
+  std::mt19937_64 generator(37);
+  constexpr std::size_t numWords = std::size_t{1} << 22;
+
+  auto benchmark = [&]<typename Codec>(const char *name) {
+    std::vector<typename Codec::Data> data(numWords);
+    for (auto &word : data) {
+      word = randomData<Codec>(generator);
+    }
+    std::vector<typename Codec::Codeword> codewords(numWords);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < numWords; i++) {
+      codewords[i] = Codec::encode(data[i]);
+    }
+    std::chrono::duration<double> encodeElapsed =
+        std::chrono::steady_clock::now() - start;
+
+    // One flipped bit in every 16th word
+    for (std::size_t i = 0; i < numWords; i += 16) {
+      flipBit<Codec>(codewords[i], generator() % Codec::codewordBits);
+    }
+
+    std::size_t corrected = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < numWords; i++) {
+      auto result = Codec::decode(codewords[i]);
+      data[i] = result.data;
+      corrected += result.status == HammingDecodeStatus::Corrected;
+    }
+    std::chrono::duration<double> decodeElapsed =
+        std::chrono::steady_clock::now() - start;
+
+    const double bytes = numWords * Codec::dataBits / 8.0;
+    std::print("{}: encode {:.2f} GB/s, decode {:.2f} GB/s, {} corrected\n",
+               name, bytes / encodeElapsed.count() / 1e9,
+               bytes / decodeElapsed.count() / 1e9, corrected);
+  };
+
+  benchmark.operator()<SECDED39_32>("(39,32)");
+  benchmark.operator()<SECDED72_64>("(72,64)");
+  benchmark.operator()<SECDED137_128>("(137,128)");
+}
+} // namespace SCO
@@ -1,4 +1,7 @@
+#include <chrono>
 #include <print>
+#include <random>
+#include <string_view>
 
 #include "gtest/gtest.h"
 
@@ -28,4 +31,156 @@ TEST(SCOTests, Hamming) {
         << "Failed for input: " << testCase.input;
   }
 }
-} // namespace SCO
\ No newline at end of file
+
+TEST(SCOTests, HammingEncodeMatchesHamming) {
+  std::vector<std::uint8_t> input;
+  for (int i = 0; i < 256; i++) {
+    input.push_back(static_cast<std::uint8_t>(i));
+  }
+  // Sixteen-character blocks, then eight, then a tail of three
+  for (char c : std::string_view("Hamming(11)")) {
+    input.push_back(static_cast<std::uint8_t>(c));
+  }
+
+  auto output = hammingEncode(input);
+  ASSERT_EQ(output.size(), input.size());
+  for (std::size_t i = 0; i < input.size(); i++) {
+    EXPECT_EQ(output[i], static_cast<std::uint16_t>(
+                             hamming(static_cast<char>(input[i]))))
+        << "Failed for byte " << int(input[i]);
+  }
+
+  std::vector<std::uint16_t> tooSmall(input.size() - 1);
+  EXPECT_FALSE(hammingEncode(input, tooSmall));
+}
+
+TEST(SCOTests, HammingDecodeCorrectsSingleErrors) {
+  for (int ascii = 0; ascii < 128; ascii++) {
+    auto codeword =
+        static_cast<std::uint16_t>(hamming(static_cast<char>(ascii)));
+
+    auto result = hammingDecode(codeword);
+    EXPECT_EQ(result.ascii, ascii);
+    EXPECT_EQ(result.status, HammingDecodeStatus::NoError);
+
+    for (std::size_t bit = 0; bit < 11; bit++) {
+      result =
+          hammingDecode(static_cast<std::uint16_t>(codeword ^ (1u << bit)));
+      EXPECT_EQ(result.ascii, ascii) << "bit " << bit;
+      EXPECT_EQ(result.status, HammingDecodeStatus::Corrected)
+          << "bit " << bit;
+    }
+
+    for (std::size_t bit = 11; bit < 16; bit++) {
+      result =
+          hammingDecode(static_cast<std::uint16_t>(codeword ^ (1u << bit)));
+      EXPECT_EQ(result.status, HammingDecodeStatus::Uncorrectable);
+    }
+  }
+
+  // Positions 1 and 2 plus 4 and 8 give syndrome 15, past position 11
+  auto codeword = static_cast<std::uint16_t>(hamming('A'));
+  EXPECT_EQ(hammingDecode(codeword ^ 0b10001011).status,
+            HammingDecodeStatus::Uncorrectable);
+}
+
+TEST(SCOTests, HammingDecodeBatchMatchesScalar) {
+  std::vector<std::uint16_t> input;
+  for (std::uint32_t codeword = 0; codeword <= UINT16_MAX; codeword++) {
+    input.push_back(static_cast<std::uint16_t>(codeword));
+  }
+
+  std::vector<std::uint8_t> output(input.size());
+  HammingDecodeStatistics statistics;
+  ASSERT_TRUE(hammingDecode(input, output, &statistics));
+
+  HammingDecodeStatistics expectedStatistics;
+  for (std::size_t i = 0; i < input.size(); i++) {
+    auto result = hammingDecode(input[i]);
+    EXPECT_EQ(output[i], result.ascii) << "codeword " << input[i];
+    expectedStatistics.corrected +=
+        result.status == HammingDecodeStatus::Corrected;
+    expectedStatistics.uncorrectable +=
+        result.status == HammingDecodeStatus::Uncorrectable;
+  }
+  EXPECT_EQ(statistics.corrected, expectedStatistics.corrected);
+  EXPECT_EQ(statistics.uncorrectable, expectedStatistics.uncorrectable);
+
+  // 128 codewords, each with 11 single-bit neighbours, out of 2^11 words
+  EXPECT_EQ(statistics.corrected, 128 * 11);
+
+  std::vector<std::uint8_t> tooSmall(input.size() - 1);
+  EXPECT_FALSE(hammingDecode(input, tooSmall));
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SCOTests, DISABLED_HammingEncodeBenchmark) {
+  std::mt19937 generator(35);
+  std::vector<std::uint8_t> input(std::size_t{1} << 26);
+  for (auto &byte : input) {
+    byte = static_cast<std::uint8_t>(generator() & 0x7F);
+  }
+  std::vector<std::uint16_t> output(input.size());
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < input.size(); i++) {
+    output[i] = hamming(static_cast<char>(input[i]));
+  }
+  std::chrono::duration<double> perCharacter =
+      std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  hammingEncode(input, output);
+  std::chrono::duration<double> batch =
+      std::chrono::steady_clock::now() - start;
+
+  std::print("hamming():       {:.2f} GB/s\n",
+             input.size() / perCharacter.count() / 1e9);
+  std::print("hammingEncode(): {:.2f} GB/s\n",
+             input.size() / batch.count() / 1e9);
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SCOTests, DISABLED_HammingDecodeBenchmark) {
+  std::mt19937_64 generator(36);
+  std::vector<std::uint8_t> input(std::size_t{1} << 24);
+  for (auto &byte : input) {
+    byte = static_cast<std::uint8_t>(generator() & 0x7F);
+  }
+  std::vector<std::uint16_t> codewords(input.size());
+  std::vector<std::uint8_t> output(input.size());
+
+  for (double bitFlipRate : {0.0, 1e-4, 1e-2, 1e-1}) {
+    auto start = std::chrono::steady_clock::now();
+    hammingEncode(input, codewords);
+    std::chrono::duration<double> encodeElapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::bernoulli_distribution flip(bitFlipRate);
+    for (auto &codeword : codewords) {
+      for (std::size_t bit = 0; bit < 11; bit++) {
+        if (flip(generator)) {
+          codeword ^= static_cast<std::uint16_t>(1u << bit);
+        }
+      }
+    }
+
+    HammingDecodeStatistics statistics;
+    start = std::chrono::steady_clock::now();
+    hammingDecode(codewords, output, &statistics);
+    std::chrono::duration<double> decodeElapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < input.size(); i++) {
+      mismatches += output[i] != input[i];
+    }
+
+    std::print("bit flip rate {:<6}: encode+decode {:.2f} GB/s, {} corrected, "
+               "{} uncorrectable, {} characters wrong\n",
+               bitFlipRate,
+               input.size() / (encodeElapsed + decodeElapsed).count() / 1e9,
+               statistics.corrected, statistics.uncorrectable, mismatches);
+  }
+}
+} // namespace SCO
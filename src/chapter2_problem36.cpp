@@ -0,0 +1,168 @@
+#include "chapter2_problem36.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace SCO {
+namespace {
+std::size_t rowDistancePortable(std::uint64_t row,
+                                std::span<const std::uint64_t> words,
+                                std::size_t minDistance) {
+  for (std::uint64_t word : words) {
+    minDistance =
+        std::min<std::size_t>(minDistance, std::popcount(row ^ word));
+  }
+  return minDistance;
+}
+
+#if defined(__x86_64__)
+// Without the target std::popcount is a call into libgcc for every pair
+[[gnu::target("popcnt")]] std::size_t
+rowDistancePopcnt(std::uint64_t row, std::span<const std::uint64_t> words,
+                  std::size_t minDistance) {
+  for (std::uint64_t word : words) {
+    minDistance = std::min<std::size_t>(
+        minDistance, static_cast<std::size_t>(_mm_popcnt_u64(row ^ word)));
+  }
+  return minDistance;
+}
+
+// AVX2 has no vector popcount. Harley-Seal only pays off when the counts
+// are summed, and every pair needs its own, so this looks up the bits of
+// each nibble with VPSHUFB and adds the bytes of each word with VPSADBW.
+// The sums stay below 2^32, so an unsigned 32-bit min keeps the smallest.
+[[gnu::target("avx2,popcnt")]] std::size_t
+rowDistanceAvx2(std::uint64_t row, std::span<const std::uint64_t> words,
+                std::size_t minDistance) {
+  // The lanes start at 64, which no distance exceeds once a word is seen
+  if (words.empty()) {
+    return minDistance;
+  }
+  const __m256i nibbleCounts =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                       1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+  const __m256i rows = _mm256_set1_epi64x(static_cast<long long>(row));
+  __m256i best = _mm256_set1_epi64x(64);
+  std::size_t j = 0;
+  for (; j + 4 <= words.size(); j += 4) {
+    const __m256i x = _mm256_xor_si256(
+        rows, _mm256_loadu_si256(
+                  reinterpret_cast<const __m256i *>(words.data() + j)));
+    const __m256i bytes = _mm256_add_epi8(
+        _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(x, lowNibbles)),
+        _mm256_shuffle_epi8(nibbleCounts,
+                            _mm256_and_si256(_mm256_srli_epi16(x, 4),
+                                             lowNibbles)));
+    best = _mm256_min_epu32(best,
+                            _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+  }
+
+  alignas(32) std::uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), best);
+  for (std::uint64_t lane : lanes) {
+    minDistance = std::min<std::size_t>(minDistance, lane);
+  }
+  return rowDistancePopcnt(row, words.subspan(j), minDistance);
+}
+
+// Eight pairs per VPOPCNTQ, with the tail masked off
+[[gnu::target("avx512f,avx512vpopcntdq")]] std::size_t
+rowDistanceAvx512(std::uint64_t row, std::span<const std::uint64_t> words,
+                  std::size_t minDistance) {
+  // The lanes start at 64, which no distance exceeds once a word is seen
+  if (words.empty()) {
+    return minDistance;
+  }
+  const __m512i rows = _mm512_set1_epi64(static_cast<long long>(row));
+  __m512i best = _mm512_set1_epi64(64);
+  for (std::size_t j = 0; j < words.size(); j += 8) {
+    const std::size_t left = words.size() - j;
+    const __mmask8 valid = left >= 8 ? 0xFF : (1u << left) - 1;
+    const __m512i x = _mm512_xor_si512(
+        rows, _mm512_maskz_loadu_epi64(valid, words.data() + j));
+    best = _mm512_mask_min_epu64(best, valid, best, _mm512_popcnt_epi64(x));
+  }
+
+  alignas(64) std::uint64_t lanes[8];
+  _mm512_store_si512(lanes, best);
+  for (std::uint64_t lane : lanes) {
+    minDistance = std::min<std::size_t>(minDistance, lane);
+  }
+  return minDistance;
+}
+#endif
+} // namespace
+
+bool hasPopcountKernel(PopcountKernel kernel) {
+  switch (kernel) {
+  case PopcountKernel::Portable:
+    return true;
+#if defined(__x86_64__)
+  case PopcountKernel::Popcnt:
+    return __builtin_cpu_supports("popcnt");
+  case PopcountKernel::Avx2:
+    return __builtin_cpu_supports("avx2") and
+           __builtin_cpu_supports("popcnt");
+  case PopcountKernel::Avx512:
+    return __builtin_cpu_supports("avx512f") and
+           __builtin_cpu_supports("avx512vpopcntdq");
+#endif
+  default:
+    return false;
+  }
+}
+
+PopcountKernel bestPopcountKernel() {
+  for (PopcountKernel kernel : {PopcountKernel::Avx512, PopcountKernel::Avx2,
+                                PopcountKernel::Popcnt}) {
+    if (hasPopcountKernel(kernel)) {
+      return kernel;
+    }
+  }
+  return PopcountKernel::Portable;
+}
+
+std::size_t rowDistance(PopcountKernel kernel, std::uint64_t row,
+                        std::span<const std::uint64_t> words,
+                        std::size_t minDistance) {
+  switch (kernel) {
+#if defined(__x86_64__)
+  case PopcountKernel::Popcnt:
+    return rowDistancePopcnt(row, words, minDistance);
+  case PopcountKernel::Avx2:
+    return rowDistanceAvx2(row, words, minDistance);
+  case PopcountKernel::Avx512:
+    return rowDistanceAvx512(row, words, minDistance);
+#endif
+  default:
+    return rowDistancePortable(row, words, minDistance);
+  }
+}
+
+std::size_t distanceRows(PopcountKernel kernel,
+                         std::span<const std::uint64_t> words,
+                         std::size_t rowBegin, std::size_t rowEnd,
+                         std::size_t minDistance) {
+  for (std::size_t columnBegin = rowBegin + 1; columnBegin < words.size();
+       columnBegin += distanceColumnBlock) {
+    const std::size_t columnEnd =
+        std::min(words.size(), columnBegin + distanceColumnBlock);
+    for (std::size_t i = rowBegin; i < rowEnd; i++) {
+      const std::size_t first = std::max(columnBegin, i + 1);
+      if (first < columnEnd) {
+        minDistance = rowDistance(kernel, words[i],
+                                  words.subspan(first, columnEnd - first),
+                                  minDistance);
+      }
+    }
+
+    if (minDistance <= 1) {
+      return minDistance;
+    }
+  }
+
+  return minDistance;
+}
+} // namespace SCO
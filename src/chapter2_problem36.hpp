@@ -1,39 +1,322 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <optional>
 #include <print>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace SCO {
 template <typename T> std::size_t hammingWeight(T val) {
-  std::size_t bitsSet = 0;
-  while (val) {
-    bitsSet += val & 1;
-    val >>= 1;
-  }
-  return bitsSet;
+  return std::popcount(static_cast<std::make_unsigned_t<T>>(val));
 }
 
+// Codewords per tile edge of the pair space. A column tile of 2048 64-bit
+// words stays in L1 while a tile of rows is compared against it.
+inline constexpr std::size_t distanceRowBlock = 64;
+inline constexpr std::size_t distanceColumnBlock = 2048;
+// Below this many codewords the pair space is too small to be worth threads
+inline constexpr std::size_t minParallelDistanceCodewords = 4096;
+
+// The pair kernels: the popcount of row ^ words[j] for a run of words, as
+// the portable loop, with the popcnt instruction, with an AVX2 nibble
+// lookup, or with AVX-512 VPOPCNTQ. Each is compiled for its own target
+// and picked for the CPU at run time.
+enum class PopcountKernel { Portable, Popcnt, Avx2, Avx512 };
+
+bool hasPopcountKernel(PopcountKernel kernel);
+
+// The widest kernel this CPU runs
+PopcountKernel bestPopcountKernel();
+
+// min(minDistance, popcount(row ^ words[j]) over all j)
+std::size_t rowDistance(PopcountKernel kernel, std::uint64_t row,
+                        std::span<const std::uint64_t> words,
+                        std::size_t minDistance);
+
+// Smallest distance between words[i] and words[j] over rows
+// [rowBegin, rowEnd) and j > i, or minDistance if none is smaller. Stops
+// early at 1.
+std::size_t distanceRows(PopcountKernel kernel,
+                         std::span<const std::uint64_t> words,
+                         std::size_t rowBegin, std::size_t rowEnd,
+                         std::size_t minDistance);
+
 template <typename T>
 std::size_t distance(const std::vector<T> &code, std::size_t codewordLength) {
   if (code.size() < 2) {
     return codewordLength;
   }
 
-  std::size_t minDistance = codewordLength;
-  for (std::size_t i = 0; i < code.size(); i++) {
-    for (std::size_t j = i + 1; j < code.size(); j++) {
-      T diff = code[i] ^ code[j];
-      std::size_t bitsSet = hammingWeight(diff);
-      if (bitsSet < minDistance) {
-        minDistance = bitsSet;
+  // Zero-extended through the unsigned type, which keeps the distances
+  using U = std::make_unsigned_t<T>;
+  std::vector<std::uint64_t> words;
+  words.reserve(code.size());
+  for (T codeword : code) {
+    words.push_back(static_cast<U>(codeword));
+  }
+  const PopcountKernel kernel = bestPopcountKernel();
+
+  const std::size_t numRowBlocks =
+      (words.size() + distanceRowBlock - 1) / distanceRowBlock;
+  const std::size_t numThreads =
+      words.size() < minParallelDistanceCodewords
+          ? 1
+          : std::min<std::size_t>(
+                std::max(1u, std::thread::hardware_concurrency()),
+                numRowBlocks);
+
+  // Row blocks are handed out dynamically because the upper triangle gives
+  // early blocks far more pairs than late ones
+  std::atomic<std::size_t> nextRowBlock = 0;
+  std::atomic<std::size_t> minDistance = codewordLength;
+  auto worker = [&] {
+    std::size_t localMin = minDistance.load(std::memory_order_relaxed);
+    for (std::size_t block = nextRowBlock++; block < numRowBlocks;
+         block = nextRowBlock++) {
+      localMin =
+          std::min(localMin, minDistance.load(std::memory_order_relaxed));
+      if (localMin <= 1) {
+        break;
+      }
+
+      const std::size_t rowBegin = block * distanceRowBlock;
+      const std::size_t rowEnd =
+          std::min(words.size(), rowBegin + distanceRowBlock);
+      localMin = distanceRows(kernel, words, rowBegin, rowEnd, localMin);
+
+      std::size_t current = minDistance.load(std::memory_order_relaxed);
+      while (localMin < current and
+             not minDistance.compare_exchange_weak(current, localMin)) {
+      }
+    }
+  };
+
+  if (numThreads == 1) {
+    worker();
+  } else {
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < numThreads; t++) {
+      threads.emplace_back(worker);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  return minDistance;
+}
+
+// Minimum distance of a linear code, which is the smallest weight of a
+// nonzero codeword, in O(n). nullopt if the codewords are not exactly the
+// span of some basis, i.e. not closed under XOR.
+template <typename T>
+std::optional<std::size_t> linearCodeDistance(const std::vector<T> &code,
+                                              std::size_t codewordLength) {
+  using U = std::make_unsigned_t<T>;
+
+  // Gaussian elimination with one basis vector per leading bit
+  std::array<U, sizeof(U) * 8> basis{};
+  std::size_t rank = 0;
+  for (T codeword : code) {
+    U reduced = static_cast<U>(codeword);
+    while (reduced != 0) {
+      const std::size_t leadingBit = std::bit_width(reduced) - 1;
+      if (basis[leadingBit] == 0) {
+        basis[leadingBit] = reduced;
+        rank++;
+        break;
       }
+      reduced ^= basis[leadingBit];
+    }
+  }
 
+  // Every codeword lies in the span, so n distinct codewords fill it exactly
+  // when n == 2^rank
+  if (rank >= 64 or code.size() != std::size_t{1} << rank) {
+    return std::nullopt;
+  }
+  std::vector<U> sorted(code.begin(), code.end());
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+    return std::nullopt;
+  }
+
+  std::size_t minDistance = codewordLength;
+  for (U codeword : sorted) {
+    if (codeword != 0) {
+      minDistance = std::min(minDistance, hammingWeight(codeword));
       if (minDistance == 1) {
         return 1;
       }
     }
   }
-
   return minDistance;
 }
+
+// Splits the codeword bits into maxDistance + 1 slices; by pigeonhole, two
+// codewords within maxDistance agree exactly on at least one slice. Slice
+// ranges are [first, second).
+inline std::vector<std::pair<std::size_t, std::size_t>>
+getCodewordSlices(std::size_t codewordLength, std::size_t maxDistance) {
+  const std::size_t numSlices = maxDistance + 1;
+  std::vector<std::pair<std::size_t, std::size_t>> slices;
+  for (std::size_t s = 0; s < numSlices; s++) {
+    slices.emplace_back(s * codewordLength / numSlices,
+                        (s + 1) * codewordLength / numSlices);
+  }
+  return slices;
+}
+
+template <typename U>
+U getCodewordSlice(U codeword, std::pair<std::size_t, std::size_t> slice) {
+  const std::size_t width = slice.second - slice.first;
+  if (width == 0) {
+    return 0;
+  }
+  const U shifted = static_cast<U>(codeword >> slice.first);
+  return width >= sizeof(U) * 8
+             ? shifted
+             : static_cast<U>(shifted & ((U{1} << width) - 1));
+}
+
+// Codewords sorted by one slice, so codewords agreeing on it are adjacent
+template <typename U>
+std::vector<std::pair<U, std::uint32_t>>
+sortBySlice(const std::vector<U> &words,
+            std::pair<std::size_t, std::size_t> slice) {
+  std::vector<std::pair<U, std::uint32_t>> keys(words.size());
+  for (std::size_t i = 0; i < words.size(); i++) {
+    keys[i] = {getCodewordSlice(words[i], slice),
+               static_cast<std::uint32_t>(i)};
+  }
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+// Number of pairs findCloseCodewordPairs will compare
+template <typename T>
+std::size_t countCandidatePairs(const std::vector<T> &code,
+                                std::size_t codewordLength,
+                                std::size_t maxDistance) {
+  using U = std::make_unsigned_t<T>;
+  std::vector<U> words(code.begin(), code.end());
+
+  std::size_t candidates = 0;
+  for (auto slice : getCodewordSlices(codewordLength, maxDistance)) {
+    auto keys = sortBySlice(words, slice);
+    for (std::size_t begin = 0, end = 0; begin < keys.size(); begin = end) {
+      while (end < keys.size() and keys[end].first == keys[begin].first) {
+        end++;
+      }
+      candidates += (end - begin) * (end - begin - 1) / 2;
+    }
+  }
+  return candidates;
+}
+
+// All pairs (i < j) of codewords within maxDistance of each other, comparing
+// only codewords that agree on a slice rather than every pair. Codewords
+// must fit in codewordLength bits. Stops once maxPairs pairs are found.
+template <typename T>
+std::vector<std::pair<std::size_t, std::size_t>>
+findCloseCodewordPairs(const std::vector<T> &code, std::size_t codewordLength,
+                       std::size_t maxDistance,
+                       std::size_t maxPairs = SIZE_MAX) {
+  using U = std::make_unsigned_t<T>;
+  std::vector<U> words(code.begin(), code.end());
+  const auto slices = getCodewordSlices(codewordLength, maxDistance);
+
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  for (std::size_t s = 0; s < slices.size(); s++) {
+    auto keys = sortBySlice(words, slices[s]);
+    for (std::size_t begin = 0, end = 0; begin < keys.size(); begin = end) {
+      while (end < keys.size() and keys[end].first == keys[begin].first) {
+        end++;
+      }
+
+      for (std::size_t a = begin; a < end; a++) {
+        for (std::size_t b = a + 1; b < end; b++) {
+          const U x = words[keys[a].second];
+          const U y = words[keys[b].second];
+          if (hammingWeight(U(x ^ y)) > maxDistance) {
+            continue;
+          }
+          // Report each pair only for the first slice it agrees on
+          bool agreesEarlier = false;
+          for (std::size_t t = 0; t < s and not agreesEarlier; t++) {
+            agreesEarlier = getCodewordSlice(x, slices[t]) ==
+                            getCodewordSlice(y, slices[t]);
+          }
+          if (not agreesEarlier) {
+            pairs.emplace_back(std::min(keys[a].second, keys[b].second),
+                               std::max(keys[a].second, keys[b].second));
+            if (pairs.size() >= maxPairs) {
+              return pairs;
+            }
+          }
+        }
+      }
+    }
+  }
+  return pairs;
+}
+
+// Same result as distance(), but sub-quadratic when the structure allows:
+// linear codes take the minimum nonzero weight, and other codes search for
+// a close pair with findCloseCodewordPairs at growing distances. Duplicates
+// are ruled out first and nothing was found one distance lower, so the
+// first pair settles the answer. Unlike distance(), which may stop at 1,
+// this is exact: 0 for a code with duplicates. Once the slices get too
+// narrow to prune, it falls back to distance().
+template <typename T>
+std::size_t minimumDistance(const std::vector<T> &code,
+                            std::size_t codewordLength) {
+  if (code.size() < 2) {
+    return codewordLength;
+  }
+
+  if (auto linearDistance = linearCodeDistance(code, codewordLength)) {
+    return *linearDistance;
+  }
+
+  // Duplicates first, so that a first pair within distance 1 is exactly 1
+  using U = std::make_unsigned_t<T>;
+  std::vector<U> sorted(code.begin(), code.end());
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+    return 0;
+  }
+
+  // Slices must cover every bit that is set anywhere
+  U allBits = 0;
+  for (T codeword : code) {
+    allBits |= static_cast<U>(codeword);
+  }
+  const std::size_t numBits =
+      std::max<std::size_t>(codewordLength, std::bit_width(allBits));
+
+  const std::size_t maxCandidates = code.size() * (code.size() - 1) / 8;
+  for (std::size_t maxDistance = 1; maxDistance < codewordLength;
+       maxDistance++) {
+    if (countCandidatePairs(code, numBits, maxDistance) > maxCandidates) {
+      break;
+    }
+
+    auto pairs = findCloseCodewordPairs(code, numBits, maxDistance, 1);
+    if (not pairs.empty()) {
+      auto [i, j] = pairs.front();
+      return hammingWeight(static_cast<U>(code[i] ^ code[j]));
+    }
+  }
+
+  return distance(code, codewordLength);
+}
 } // namespace SCO
@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <print>
+#include <random>
 
 #include "gtest/gtest.h"
 
@@ -17,4 +21,179 @@ TEST(SCOTests, Distance) {
   result = SCO::distance(code, codewordLength);
   EXPECT_EQ(result, 3);
 }
-} // namespace SCO
\ No newline at end of file
+
+namespace {
+template <typename T>
+std::size_t bruteForceDistance(const std::vector<T> &code,
+                               std::size_t codewordLength) {
+  std::size_t minDistance = codewordLength;
+  for (std::size_t i = 0; i < code.size(); i++) {
+    for (std::size_t j = i + 1; j < code.size(); j++) {
+      std::size_t bitsSet = 0;
+      for (std::size_t bit = 0; bit < codewordLength; bit++) {
+        bitsSet += ((code[i] ^ code[j]) >> bit) & 1;
+      }
+      minDistance = std::min(minDistance, bitsSet);
+    }
+  }
+  return minDistance;
+}
+} // namespace
+
+TEST(SCOTests, HammingWeight) {
+  EXPECT_EQ(SCO::hammingWeight(0), 0);
+  EXPECT_EQ(SCO::hammingWeight(0b1011), 3);
+  EXPECT_EQ(SCO::hammingWeight(-1), 32);
+  EXPECT_EQ(SCO::hammingWeight(std::uint64_t{UINT64_MAX}), 64);
+}
+
+TEST(SCOTests, PopcountKernelsAgree) {
+  std::mt19937_64 generator(36);
+  std::vector<std::uint64_t> words(40);
+  for (auto kernel :
+       {SCO::PopcountKernel::Portable, SCO::PopcountKernel::Popcnt,
+        SCO::PopcountKernel::Avx2, SCO::PopcountKernel::Avx512}) {
+    if (not SCO::hasPopcountKernel(kernel)) {
+      continue;
+    }
+    // Lengths around the vector widths, so every tail path runs
+    for (std::size_t length = 0; length <= words.size(); length++) {
+      const std::uint64_t row = generator();
+      for (auto &word : words) {
+        // Close to row for some words, so the minimum sits anywhere
+        word = generator() % 4 ? generator() : row ^ (generator() & 0xF0F);
+      }
+      auto run = std::span(words).first(length);
+      for (std::size_t minDistance : {64, 100, 5}) {
+        EXPECT_EQ(SCO::rowDistance(kernel, row, run, minDistance),
+                  SCO::rowDistance(SCO::PopcountKernel::Portable, row, run,
+                                   minDistance))
+            << "kernel " << static_cast<int>(kernel) << " length " << length;
+      }
+    }
+  }
+}
+
+TEST(SCOTests, DistanceMatchesBruteForce) {
+  std::mt19937_64 generator(38);
+  // Sizes on both sides of the row and column blocks and the threading
+  // threshold
+  for (std::size_t size : {2, 3, 65, 2049, 5000}) {
+    std::vector<std::uint64_t> code(size);
+    for (auto &codeword : code) {
+      // Sparse words keep distances low but above 1 so no early exit hides
+      // bugs; distinct words because a 0 found after a 1 is never reached
+      codeword = generator() & generator() & generator();
+    }
+    std::sort(code.begin(), code.end());
+    code.erase(std::unique(code.begin(), code.end()), code.end());
+    std::shuffle(code.begin(), code.end(), generator);
+
+    EXPECT_EQ(SCO::distance(code, 64), bruteForceDistance(code, 64))
+        << size << " codewords";
+  }
+}
+
+TEST(SCOTests, LinearCodeDistance) {
+  // Span of the (7,4) Hamming code's generator rows
+  std::vector<std::uint8_t> generatorRows = {0b1110000, 0b1001100, 0b0101010,
+                                             0b1101001};
+  std::vector<std::uint8_t> code;
+  for (std::uint32_t message = 0; message < 16; message++) {
+    std::uint8_t codeword = 0;
+    for (std::size_t row = 0; row < 4; row++) {
+      if ((message >> row) & 1) {
+        codeword ^= generatorRows[row];
+      }
+    }
+    code.push_back(codeword);
+  }
+
+  EXPECT_EQ(SCO::linearCodeDistance(code, 7), 3);
+  EXPECT_EQ(SCO::minimumDistance(code, 7), 3);
+  EXPECT_EQ(SCO::distance(code, 7), 3);
+
+  code.back() ^= 1;
+  EXPECT_FALSE(SCO::linearCodeDistance(code, 7).has_value());
+  EXPECT_EQ(SCO::minimumDistance(code, 7), SCO::distance(code, 7));
+}
+
+TEST(SCOTests, FindCloseCodewordPairs) {
+  std::mt19937_64 generator(39);
+  std::vector<std::uint32_t> code(500);
+  for (auto &codeword : code) {
+    codeword = static_cast<std::uint32_t>(generator());
+  }
+
+  for (std::size_t maxDistance : {1, 4, 8}) {
+    auto pairs = SCO::findCloseCodewordPairs(code, 32, maxDistance);
+    std::sort(pairs.begin(), pairs.end());
+
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    for (std::size_t i = 0; i < code.size(); i++) {
+      for (std::size_t j = i + 1; j < code.size(); j++) {
+        if (SCO::hammingWeight(code[i] ^ code[j]) <= maxDistance) {
+          expected.emplace_back(i, j);
+        }
+      }
+    }
+    EXPECT_EQ(pairs, expected) << "within " << maxDistance;
+    EXPECT_EQ(SCO::findCloseCodewordPairs(code, 32, maxDistance, 1).size(),
+              std::min<std::size_t>(1, expected.size()));
+    EXPECT_LT(SCO::countCandidatePairs(code, 32, maxDistance),
+              code.size() * (code.size() - 1) / 2);
+  }
+}
+
+TEST(SCOTests, MinimumDistanceMatchesBruteForce) {
+  std::mt19937_64 generator(39);
+  for (std::size_t size : {2, 10, 1000, 3000}) {
+    for (std::size_t codewordLength : {8, 24, 64}) {
+      std::vector<std::uint64_t> code(size);
+      for (auto &codeword : code) {
+        codeword = generator();
+        if (codewordLength < 64) {
+          codeword &= (std::uint64_t{1} << codewordLength) - 1;
+        }
+      }
+
+      EXPECT_EQ(SCO::minimumDistance(code, codewordLength),
+                SCO::distance(code, codewordLength))
+          << size << " codewords of " << codewordLength << " bits";
+    }
+  }
+
+  // Duplicates and signed codewords; the pair at distance 1 comes first
+  std::vector<int> code = {-1, 5, 17, 4, -1};
+  EXPECT_EQ(SCO::minimumDistance(code, 32), 0);
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SCOTests, DISABLED_DistanceBenchmark) {
+  std::mt19937_64 generator(38);
+  std::vector<std::uint64_t> code(100'000);
+  for (auto &codeword : code) {
+    codeword = generator();
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::size_t minDistance = SCO::distance(code, 64);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::print("distance(): {} codewords, distance {} in {:.2f} s\n",
+             code.size(), minDistance, elapsed.count());
+
+  // A million codewords with one planted pair at distance 3
+  code.resize(1'000'000);
+  for (auto &codeword : code) {
+    codeword = generator();
+  }
+  code[123'456] = code[654'321] ^ 0b10101;
+
+  start = std::chrono::steady_clock::now();
+  minDistance = SCO::minimumDistance(code, 64);
+  elapsed = std::chrono::steady_clock::now() - start;
+  std::print("minimumDistance(): {} codewords, distance {} in {:.2f} s\n",
+             code.size(), minDistance, elapsed.count());
+}
+} // namespace SCO
@@ -1,10 +1,33 @@
 #include "chapter3_problem46.hpp"
 
+#include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <iostream>
-#include <print>
 
 namespace SCO {
+namespace {
+bool getNetValue(const std::vector<std::uint64_t> &values, std::size_t index) {
+  return (values[index / 64] >> (index % 64)) & 1;
+}
+
+void setNetValue(std::vector<std::uint64_t> &values, std::size_t index,
+                 bool value) {
+  std::uint64_t mask = std::uint64_t{1} << (index % 64);
+  values[index / 64] = value ? (values[index / 64] | mask)
+                             : (values[index / 64] & ~mask);
+}
+
+std::uint64_t hashState(const std::vector<std::uint64_t> &values) {
+  std::uint64_t hash = 0xCBF29CE484222325;
+  for (std::uint64_t word : values) {
+    hash = (hash ^ word) * 0x9E3779B97F4A7C15;
+    hash ^= hash >> 29;
+  }
+  return hash;
+}
+} // namespace
+
 std::ostream &operator<<(std::ostream &os,
                          const std::vector<NANDGateArrayResult> &results) {
   if (results.empty())
@@ -40,7 +63,8 @@ std::ostream &operator<<(std::ostream &os,
 std::vector<NANDGateArrayResult>
 simulateGateArray(std::size_t numRows, std::size_t numCols,
                   std::size_t numInputs, std::size_t numOutputs,
-                  std::vector<WireConnection> wireConnections) {
+                  std::vector<WireConnection> wireConnections,
+                  NANDGateArrayDiagnostics *diagnostics) {
   const std::size_t valuesSize = numInputs + numRows * numCols + numOutputs + 1;
   const std::size_t unusedInputIndex = valuesSize - 1;
   std::vector<NANGGateInputMapping> nandGatesInputMapping(
@@ -74,43 +98,176 @@ simulateGateArray(std::size_t numRows, std::size_t numCols,
   }
 
   // Simulation
+  // The state of every net is packed 64 per word. Only a hash of each
+  // iteration's state is kept, in an open addressing table that grows with
+  // the iteration count, so the loop stops as soon as a state repeats: a
+  // repeat after one iteration is a fixed point, anything longer is an
+  // oscillation with that period. A matching hash is confirmed by replaying
+  // the earlier state from the input vector, which also walks the cycle
+  // once to find the nets that toggle in it.
   const std::size_t totalCombinations = 1 << numInputs;
+  const std::size_t numGates = nandGatesInputMapping.size();
+  const std::size_t numWords = (valuesSize + 63) / 64;
+  // Acyclic arrays settle within numGates iterations; a feedback loop through
+  // n gates oscillates with a period of at most 2n, so this leaves room for
+  // the transient plus a full period before giving up.
+  const std::size_t maxIterations = 4 * (numGates + 1);
   std::vector<NANDGateArrayResult> result(totalCombinations);
+  std::vector<std::uint64_t> initialValues(numWords);
+  std::vector<std::uint64_t> values(numWords);
+  std::vector<std::uint64_t> nextValues(numWords);
+  std::vector<std::uint64_t> replayValues(numWords);
+  std::vector<std::uint64_t> replayNextValues(numWords);
+  std::vector<std::uint64_t> stateHashes;
+  std::vector<std::size_t> hashTable;
+  std::vector<std::uint64_t> oscillatingNets(numWords);
+  if (diagnostics and diagnostics->collectPerVector) {
+    diagnostics->perVector.reserve(diagnostics->perVector.size() +
+                                   totalCombinations);
+  }
+
+  auto step = [&](const std::vector<std::uint64_t> &from,
+                  std::vector<std::uint64_t> &to) {
+    to = from;
+    std::size_t gatesToggled = 0;
+    for (std::size_t gatePos = 0; gatePos < numGates; gatePos++) {
+      auto inputAIndex = nandGatesInputMapping[gatePos].inputs[0];
+      auto inputBIndex = nandGatesInputMapping[gatePos].inputs[1];
+      bool inputA = getNetValue(from, inputAIndex);
+      bool inputB = getNetValue(from, inputBIndex);
+      bool output = nand(inputA, inputB);
+      gatesToggled += output != getNetValue(from, numInputs + gatePos);
+      setNetValue(to, numInputs + gatePos, output);
+    }
+    return gatesToggled;
+  };
+  // Leaves the state after the given number of iterations in replayValues
+  auto replay = [&](std::size_t iterations) {
+    replayValues = initialValues;
+    for (std::size_t k = 0; k < iterations; k++) {
+      step(replayValues, replayNextValues);
+      replayValues.swap(replayNextValues);
+    }
+  };
+  auto insertHash = [&](std::size_t iteration) {
+    if (2 * stateHashes.size() > hashTable.size()) {
+      hashTable.assign(std::max<std::size_t>(16, 2 * hashTable.size()), 0);
+      for (std::size_t seen = 0; seen < iteration; seen++) {
+        std::size_t slot = stateHashes[seen] & (hashTable.size() - 1);
+        while (hashTable[slot] != 0) {
+          slot = (slot + 1) & (hashTable.size() - 1);
+        }
+        hashTable[slot] = seen + 1;
+      }
+    }
+    std::size_t slot = stateHashes[iteration] & (hashTable.size() - 1);
+    while (hashTable[slot] != 0) {
+      slot = (slot + 1) & (hashTable.size() - 1);
+    }
+    hashTable[slot] = iteration + 1;
+  };
+
   for (std::size_t i = 0; i < totalCombinations; i++) {
-    std::vector<bool> oldValues(numInputs + numRows * numCols + numOutputs + 1,
-                                true);
-    std::vector<bool> values(numInputs + numRows * numCols + numOutputs + 1,
-                             true);
-    bool valuesChanged = true;
+    NANDGateArrayStatistics statistics;
+    std::fill(initialValues.begin(), initialValues.end(), ~std::uint64_t{0});
+    stateHashes.clear();
+    hashTable.clear();
+    result[i].inputs.reserve(numInputs);
     for (std::size_t bit = 0; bit < numInputs; bit++) {
-      oldValues[bit] = values[bit] = (i >> bit) & 1;
-      result[i].inputs.push_back(values[bit]);
+      setNetValue(initialValues, bit, (i >> bit) & 1);
+      result[i].inputs.push_back(getNetValue(initialValues, bit));
     }
+    values = initialValues;
 
     // Stabilization loop
-    std::print("Inputs #{}\n", i);
-    for (std::size_t stabilizationRetry = 0;
-         valuesChanged and
-         (stabilizationRetry < nandGatesInputMapping.size() + 1);
-         stabilizationRetry++) {
-      std::print("Retry #{}\n", stabilizationRetry);
-      for (std::size_t gatePos = 0; gatePos < nandGatesInputMapping.size();
-           gatePos++) {
-        auto inputAIndex = nandGatesInputMapping[gatePos].inputs[0];
-        auto inputBIndex = nandGatesInputMapping[gatePos].inputs[1];
-        bool inputA = oldValues[inputAIndex];
-        bool inputB = oldValues[inputBIndex];
-        bool output = nand(inputA, inputB);
-        values[numInputs + gatePos] = output;
+    std::size_t iteration = 0;
+    std::size_t repeatedIteration = 0;
+    bool repeated = false;
+    stateHashes.push_back(hashState(values));
+    insertHash(iteration);
+    while (iteration < maxIterations) {
+      statistics.gatesToggled += step(values, nextValues);
+      values.swap(nextValues);
+      iteration++;
+
+      const std::uint64_t hash = hashState(values);
+      std::size_t slot = hash & (hashTable.size() - 1);
+      while (hashTable[slot] != 0) {
+        std::size_t seenIteration = hashTable[slot] - 1;
+        if (stateHashes[seenIteration] == hash) {
+          replay(seenIteration);
+          if (replayValues == values) {
+            repeated = true;
+            repeatedIteration = seenIteration;
+            break;
+          }
+        }
+        slot = (slot + 1) & (hashTable.size() - 1);
       }
 
-      valuesChanged = values != oldValues;
-      oldValues.swap(values);
+      if (repeated) {
+        break;
+      }
+      stateHashes.push_back(hash);
+      insertHash(iteration);
     }
+    statistics.stabilizationIterations = iteration;
 
+    // A state seen exactly one iteration ago is a fixed point. Otherwise
+    // report every gate whose value changes somewhere in the cycle (or, if
+    // the budget ran out, between the last two states). replayValues holds
+    // the state that starts the cycle; nextValues the one before last.
+    std::size_t period = repeated ? iteration - repeatedIteration : 0;
+    if (period != 1) {
+      if (repeated) {
+        std::fill(oscillatingNets.begin(), oscillatingNets.end(), 0);
+        replayNextValues = replayValues;
+        for (std::size_t k = 1; k < period; k++) {
+          step(replayNextValues, nextValues);
+          replayNextValues.swap(nextValues);
+          for (std::size_t word = 0; word < numWords; word++) {
+            oscillatingNets[word] |=
+                replayValues[word] ^ replayNextValues[word];
+          }
+        }
+      } else {
+        for (std::size_t word = 0; word < numWords; word++) {
+          oscillatingNets[word] = nextValues[word] ^ values[word];
+        }
+      }
+
+      GateArrayOscillation oscillation{.period = period};
+      for (std::size_t gatePos = 0; gatePos < numGates; gatePos++) {
+        if (getNetValue(oscillatingNets, numInputs + gatePos)) {
+          oscillation.gates.push_back(
+              GatePos{gatePos / numCols, gatePos % numCols});
+        }
+      }
+      for (std::size_t j = 0; j < outputPins.size(); j++) {
+        if (getNetValue(oscillatingNets, outputPins[j])) {
+          oscillation.outputPins.push_back(j);
+        }
+      }
+      result[i].oscillation = std::move(oscillation);
+
+      statistics.oscillating = true;
+      statistics.oscillationPeriod = period;
+    }
+
+    result[i].outputs.reserve(outputPins.size());
     for (std::size_t j = 0; j < outputPins.size(); j++) {
       std::size_t outputIndex = outputPins[j];
-      result[i].outputs.push_back(values[outputIndex]);
+      result[i].outputs.push_back(getNetValue(values, outputIndex));
+    }
+
+    if (diagnostics) {
+      diagnostics->totalStabilizationIterations +=
+          statistics.stabilizationIterations;
+      diagnostics->totalGatesToggled += statistics.gatesToggled;
+      diagnostics->oscillatingVectors += statistics.oscillating;
+      if (diagnostics->collectPerVector) {
+        diagnostics->perVector.push_back(statistics);
+      }
     }
   }
 
@@ -2,8 +2,8 @@
 
 #include <array>
 #include <concepts>
+#include <optional>
 #include <ostream>
-#include <print>
 #include <variant>
 #include <vector>
 
@@ -61,9 +61,36 @@ struct NANGGateInputMapping {
   std::array<std::size_t, 2> inputs;
 };
 
+// Nets that never settled for an input vector. period is the length of the
+// repeating state cycle, or 0 when the iteration budget ran out first.
+struct GateArrayOscillation {
+  std::size_t period = 0;
+  std::vector<GatePos> gates;
+  std::vector<std::size_t> outputPins;
+};
+
 struct NANDGateArrayResult {
   std::vector<bool> inputs;
   std::vector<bool> outputs;
+  std::optional<GateArrayOscillation> oscillation;
+};
+
+// Counters collected for a single input vector
+struct NANDGateArrayStatistics {
+  std::size_t stabilizationIterations = 0;
+  std::size_t gatesToggled = 0;
+  bool oscillating = false;
+  std::size_t oscillationPeriod = 0;
+};
+
+// Optional diagnostics sink for simulateGateArray. Totals are always
+// accumulated; per-vector statistics only when collectPerVector is set.
+struct NANDGateArrayDiagnostics {
+  bool collectPerVector = false;
+  std::vector<NANDGateArrayStatistics> perVector;
+  std::size_t totalStabilizationIterations = 0;
+  std::size_t totalGatesToggled = 0;
+  std::size_t oscillatingVectors = 0;
 };
 
 std::ostream &
@@ -73,5 +100,6 @@ operator<<(std::ostream &os,
 std::vector<NANDGateArrayResult>
 simulateGateArray(std::size_t numRows, std::size_t numCols,
                   std::size_t numInputs, std::size_t numOutputs,
-                  std::vector<WireConnection> wireConnections);
+                  std::vector<WireConnection> wireConnections,
+                  NANDGateArrayDiagnostics *diagnostics = nullptr);
 } // namespace SCO
@@ -104,4 +104,85 @@ TEST_F(NANDGateArrayTest, SRLatchFeedback) {
   // S_L=1, R_L=0 (Index 2: bits 0, 1) -> Q should be 1
   EXPECT_EQ(results[2].outputs[0], true);
 }
-} // namespace SCO
\ No newline at end of file
+
+TEST_F(NANDGateArrayTest, DiagnosticsCountersForSRLatch) {
+  std::vector<WireConnection> wires = {
+      connectInputToGate(0, 0, 0, GateInputName::InputA),
+      connectInputToGate(1, 0, 1, GateInputName::InputB),
+      {{SignalSourceType::GateOutput, GateOutput{{0, 0}}},
+       {SignalDestinationType::GateInput,
+        GateInput{{0, 1}, GateInputName::InputA}}},
+      {{SignalSourceType::GateOutput, GateOutput{{0, 1}}},
+       {SignalDestinationType::GateInput,
+        GateInput{{0, 0}, GateInputName::InputB}}},
+      connectGateToOutput(0, 0, 0)};
+
+  NANDGateArrayDiagnostics diagnostics{.collectPerVector = true};
+  auto results = simulateGateArray(1, 2, 2, 1, wires, &diagnostics);
+
+  ASSERT_EQ(results.size(), 4);
+  ASSERT_EQ(diagnostics.perVector.size(), 4);
+
+  // S_L=0, R_L=0: both outputs stay high, nothing toggles
+  EXPECT_EQ(diagnostics.perVector[0].stabilizationIterations, 1);
+  EXPECT_EQ(diagnostics.perVector[0].gatesToggled, 0);
+  EXPECT_FALSE(diagnostics.perVector[0].oscillating);
+
+  // S_L=1, R_L=1 starting from Q=Q'=1 never settles
+  EXPECT_TRUE(diagnostics.perVector[3].oscillating);
+  EXPECT_EQ(diagnostics.perVector[3].oscillationPeriod, 2);
+  EXPECT_EQ(diagnostics.oscillatingVectors, 1);
+
+  std::size_t totalIterations = 0;
+  for (const auto &statistics : diagnostics.perVector) {
+    totalIterations += statistics.stabilizationIterations;
+  }
+  EXPECT_EQ(diagnostics.totalStabilizationIterations, totalIterations);
+}
+
+TEST_F(NANDGateArrayTest, OscillationDetection) {
+  // Ring of three inverters, each NAND with one unused (high) input, plus an
+  // AND gate fed by input 0 that always settles.
+  std::vector<WireConnection> wires = {
+      {{SignalSourceType::GateOutput, GateOutput{{0, 0}}},
+       {SignalDestinationType::GateInput,
+        GateInput{{0, 1}, GateInputName::InputA}}},
+      {{SignalSourceType::GateOutput, GateOutput{{0, 1}}},
+       {SignalDestinationType::GateInput,
+        GateInput{{0, 2}, GateInputName::InputA}}},
+      {{SignalSourceType::GateOutput, GateOutput{{0, 2}}},
+       {SignalDestinationType::GateInput,
+        GateInput{{0, 0}, GateInputName::InputA}}},
+      connectInputToGate(0, 1, 0, GateInputName::InputA),
+      {{SignalSourceType::GateOutput, GateOutput{{1, 0}}},
+       {SignalDestinationType::GateInput,
+        GateInput{{1, 1}, GateInputName::InputA}}},
+      connectGateToOutput(1, 1, 0),
+      connectGateToOutput(0, 2, 1)};
+
+  auto results = simulateGateArray(2, 3, 1, 2, wires);
+  ASSERT_EQ(results.size(), 2);
+  for (const auto &result : results) {
+    ASSERT_TRUE(result.oscillation.has_value());
+    EXPECT_EQ(result.oscillation->period, 2);
+    ASSERT_EQ(result.oscillation->gates.size(), 3);
+    for (std::size_t col = 0; col < 3; col++) {
+      EXPECT_EQ(result.oscillation->gates[col].row, 0);
+      EXPECT_EQ(result.oscillation->gates[col].col, col);
+    }
+    EXPECT_EQ(result.oscillation->outputPins, std::vector<std::size_t>{1});
+  }
+  EXPECT_EQ(results[0].outputs[0], false);
+  EXPECT_EQ(results[1].outputs[0], true);
+}
+
+TEST_F(NANDGateArrayTest, StableArraysReportNoOscillation) {
+  std::vector<WireConnection> wires = {
+      connectInputToGate(0, 0, 0, GateInputName::InputA),
+      connectGateToOutput(0, 0, 0)};
+
+  for (const auto &result : simulateGateArray(1, 1, 1, 1, wires)) {
+    EXPECT_FALSE(result.oscillation.has_value());
+  }
+}
+} // namespace SCO
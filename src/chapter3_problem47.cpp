@@ -1,30 +1,137 @@
 #include "chapter3_problem47.hpp"
+#include "chapter3_problem47_bdd.hpp"
+#include "chapter3_problem47_sat.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cctype>
+#include <cstring>
 #include <optional>
 #include <print>
-#include <regex>
+#include <stack>
 #include <unordered_map>
 #include <unordered_set>
 
 namespace SCO {
-auto splitBooleanExpressionIntoTokens(const std::string &expression) {
-  static const std::regex pattern(R"(\w+|[()])");
-  auto matches = std::ranges::subrange(
-      std::sregex_iterator(expression.begin(), expression.end(), pattern),
-      std::sregex_iterator());
+namespace {
+// Words of the truth table evaluated together by the bit-sliced evaluator.
+// Every stack slot holds one block, small enough to keep the stack in cache.
+constexpr std::size_t bitSlicedBlockWords = 64;
+
+// Truth table columns of the first six variables inside one 64-bit word.
+// Higher variables are constant within a word and alternate between words.
+constexpr std::array<std::uint64_t, 6> variablePatterns = {
+    0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC, 0xF0F0F0F0F0F0F0F0,
+    0xFF00FF00FF00FF00, 0xFFFF0000FFFF0000, 0xFFFFFFFF00000000};
+
+std::size_t truthTableWords(std::size_t numVariables) {
+  return numVariables <= 6 ? 1 : std::size_t{1} << (numVariables - 6);
+}
 
-  return matches;
+// Stack slots hold a block as vector registers of words, using GCC/Clang
+// vector extensions: 2 words per register on plain x86-64 (SSE2), 4 with
+// AVX2 and 8 with AVX-512. Every operation below is one vector instruction
+// per register; blocks shorter than a register leave its upper words unused.
+#if defined(__AVX512F__)
+constexpr std::size_t vectorBytes = 64;
+#elif defined(__AVX2__)
+constexpr std::size_t vectorBytes = 32;
+#else
+constexpr std::size_t vectorBytes = 16;
+#endif
+constexpr std::size_t wordsPerVector = vectorBytes / 8;
+using Words = std::uint64_t __attribute__((vector_size(vectorBytes)));
+
+std::size_t blockVectors(std::size_t numWords) {
+  return (numWords + wordsPerVector - 1) / wordsPerVector;
 }
 
+// Evaluates words [firstWord, firstWord + numWords) of the truth table into
+// output. stack must hold compiledExpression.stackDepth slots of
+// blockVectors(numWords) registers.
+void evaluateBitSlicedBlock(const CompiledBooleanExpression &compiledExpression,
+                            std::size_t firstWord, std::size_t numWords,
+                            Words *stack, std::uint64_t *output) {
+  const std::size_t numVectors = blockVectors(numWords);
+  std::size_t top = 0;
+  for (const auto &instruction : compiledExpression.code) {
+    switch (instruction.opcode) {
+    case BooleanOpcode::PushVariable: {
+      Words *destination = stack + top * numVectors;
+      if (instruction.variable < 6) {
+        std::fill(destination, destination + numVectors,
+                  Words{} + variablePatterns[instruction.variable]);
+      } else {
+        // Word indices of each register; the variable's bit of the index
+        // becomes an all-ones or all-zero word
+        Words index{};
+        for (std::size_t lane = 0; lane < wordsPerVector; lane++) {
+          index[lane] = firstWord + lane;
+        }
+        for (std::size_t k = 0; k < numVectors; k++) {
+          destination[k] = -((index >> (instruction.variable - 6)) & 1);
+          index += wordsPerVector;
+        }
+      }
+      top++;
+      break;
+    }
+    case BooleanOpcode::Not: {
+      Words *destination = stack + (top - 1) * numVectors;
+      for (std::size_t k = 0; k < numVectors; k++) {
+        destination[k] = ~destination[k];
+      }
+      break;
+    }
+    case BooleanOpcode::And: {
+      top--;
+      Words *destination = stack + (top - 1) * numVectors;
+      const Words *source = stack + top * numVectors;
+      for (std::size_t k = 0; k < numVectors; k++) {
+        destination[k] &= source[k];
+      }
+      break;
+    }
+    case BooleanOpcode::Or: {
+      top--;
+      Words *destination = stack + (top - 1) * numVectors;
+      const Words *source = stack + top * numVectors;
+      for (std::size_t k = 0; k < numVectors; k++) {
+        destination[k] |= source[k];
+      }
+      break;
+    }
+    }
+  }
+
+  std::memcpy(output, stack, numWords * sizeof(std::uint64_t));
+  const std::size_t numVariables = compiledExpression.variables.size();
+  if (numVariables < 6) {
+    output[0] &= (std::uint64_t{1} << (std::size_t{1} << numVariables)) - 1;
+  }
+}
+} // namespace
+
 bool isBooleanOperator(const std::string &token) {
   static const std::unordered_set<std::string> operators = {"AND", "OR", "NOT"};
 
   return operators.contains(token);
 }
 
+// Identifiers such as 'A', 'carry_in' or 'X12' that are not operators
 bool isBooleanVariable(const std::string &token) {
-  return token.size() == 1 and isalpha(token[0]);
+  if (token.empty() or not(isalpha(token[0]) or token[0] == '_')) {
+    return false;
+  }
+
+  for (char c : token) {
+    if (not(isalnum(c) or c == '_')) {
+      return false;
+    }
+  }
+
+  return not isBooleanOperator(token);
 }
 
 std::optional<bool>
@@ -48,73 +155,246 @@ booleanOperatorHasHigherPrecedence(const std::string &operator1,
   return operator1Val->second >= operator2Val->second;
 }
 
-std::optional<ParsedBooleanExpression>
-parseBooleanExpression(const std::string &expression) {
-  ParsedBooleanExpression result;
-  std::stack<std::string> operatorsStack;
+BooleanToken BooleanLexer::next() {
+  while (position < input.size() and
+         std::isspace(static_cast<unsigned char>(input[position]))) {
+    position++;
+  }
 
-  std::print("Parsing Expression: '{}'\n", expression);
-  for (const auto &match : splitBooleanExpressionIntoTokens(expression)) {
-    const std::string &token = match.str();
-    std::print("Original Token: '{}'\n", token);
-    if (isBooleanVariable(token)) {
-      result.variables.insert(token);
-      result.postfixExpressionList.push_back(token);
-    } else if (isBooleanOperator(token)) {
-      while (not operatorsStack.empty() and operatorsStack.top() != "(") {
-        auto hasHigherPrecedenceOpt =
-            booleanOperatorHasHigherPrecedence(operatorsStack.top(), token);
-        if (not hasHigherPrecedenceOpt) {
-          std::print("Error: failed to compare operator precedence.\n");
-          return std::nullopt;
-        }
+  if (position == input.size()) {
+    return {BooleanTokenType::End, input.substr(position)};
+  }
 
-        if (not *hasHigherPrecedenceOpt) {
-          break;
-        }
+  const std::size_t start = position;
+  const char c = input[position++];
+  if (c == '(') {
+    return {BooleanTokenType::LeftParenthesis, input.substr(start, 1)};
+  }
+  if (c == ')') {
+    return {BooleanTokenType::RightParenthesis, input.substr(start, 1)};
+  }
+  if (not(std::isalpha(static_cast<unsigned char>(c)) or c == '_')) {
+    return {BooleanTokenType::Invalid, input.substr(start, 1)};
+  }
+
+  while (position < input.size() and
+         (std::isalnum(static_cast<unsigned char>(input[position])) or
+          input[position] == '_')) {
+    position++;
+  }
+
+  std::string_view text = input.substr(start, position - start);
+  if (text == "AND") {
+    return {BooleanTokenType::And, text};
+  }
+  if (text == "OR") {
+    return {BooleanTokenType::Or, text};
+  }
+  if (text == "NOT") {
+    return {BooleanTokenType::Not, text};
+  }
+  return {BooleanTokenType::Variable, text};
+}
 
-        result.postfixExpressionList.push_back(operatorsStack.top());
-        operatorsStack.pop();
+std::uint32_t BooleanVariableTable::intern(std::string_view name) {
+  if (auto it = ids.find(name); it != ids.end()) {
+    return it->second;
+  }
+
+  auto id = static_cast<std::uint32_t>(names.size());
+  names.emplace_back(name);
+  ids.emplace(names.back(), id);
+  return id;
+}
+
+// Shunting-yard over the lexer's tokens, emitting opcodes directly. While
+// parsing, PushVariable operands hold ids from variableTable; they are
+// renumbered to the sorted per-expression order at the end.
+bool BooleanExpressionParser::parse(std::string_view expression,
+                                    CompiledBooleanExpression &result,
+                                    BooleanExpressionStatistics *statistics) {
+  static constexpr std::uint32_t unseen = UINT32_MAX;
+  BooleanLexer lexer{expression};
+  std::size_t operatorsTop = 0;
+  std::size_t depth = 0;
+  bool expectOperand = true;
+  result.code.clear();
+  result.stackDepth = 0;
+  expressionVariables.clear();
+
+  auto fail = [&](std::string_view message, std::string_view token) {
+    std::print("Error: {} '{}'.\n", message, token);
+    for (std::uint32_t id : expressionVariables) {
+      localIndex[id] = unseen;
+    }
+    return false;
+  };
+
+  auto emit = [&](BooleanTokenType type) {
+    result.code.push_back({type == BooleanTokenType::Not   ? BooleanOpcode::Not
+                           : type == BooleanTokenType::And ? BooleanOpcode::And
+                                                           : BooleanOpcode::Or});
+    depth -= type != BooleanTokenType::Not;
+  };
+
+  auto precedence = [](BooleanTokenType type) {
+    return type == BooleanTokenType::Not   ? 3
+           : type == BooleanTokenType::And ? 2
+                                           : 1;
+  };
+
+  while (true) {
+    BooleanToken token = lexer.next();
+    if (token.type == BooleanTokenType::End) {
+      break;
+    }
+    if (statistics) {
+      statistics->tokensParsed++;
+    }
+
+    switch (token.type) {
+    case BooleanTokenType::Variable: {
+      if (not expectOperand) {
+        return fail("expected an operator before", token.text);
       }
-      operatorsStack.push(token);
-    } else if (token == "(") {
-      operatorsStack.push(token);
-    } else if (token == ")") {
-      while (not operatorsStack.empty() and operatorsStack.top() != "(") {
-        result.postfixExpressionList.push_back(operatorsStack.top());
-        operatorsStack.pop();
+      std::uint32_t id = variableTable.intern(token.text);
+      if (id >= localIndex.size()) {
+        localIndex.resize(variableTable.names.size(), unseen);
       }
-
-      if (operatorsStack.empty()) {
-        std::print("Error: unmatched ')");
-        return std::nullopt;
+      if (localIndex[id] == unseen) {
+        localIndex[id] = 0;
+        expressionVariables.push_back(id);
       }
+      result.code.push_back({BooleanOpcode::PushVariable, id});
+      result.stackDepth = std::max(result.stackDepth, ++depth);
+      expectOperand = false;
+      break;
+    }
+    case BooleanTokenType::Not:
+    case BooleanTokenType::LeftParenthesis:
+      if (not expectOperand) {
+        return fail("expected an operator before", token.text);
+      }
+      if (operatorsTop == operatorsStack.size()) {
+        return fail("expression nests too deeply at", token.text);
+      }
+      operatorsStack[operatorsTop++] = token.type;
+      break;
+    case BooleanTokenType::And:
+    case BooleanTokenType::Or:
+      if (expectOperand) {
+        return fail("expected an operand before", token.text);
+      }
+      while (operatorsTop > 0 and
+             operatorsStack[operatorsTop - 1] !=
+                 BooleanTokenType::LeftParenthesis and
+             precedence(operatorsStack[operatorsTop - 1]) >=
+                 precedence(token.type)) {
+        emit(operatorsStack[--operatorsTop]);
+      }
+      if (operatorsTop == operatorsStack.size()) {
+        return fail("expression nests too deeply at", token.text);
+      }
+      operatorsStack[operatorsTop++] = token.type;
+      expectOperand = true;
+      break;
+    case BooleanTokenType::RightParenthesis:
+      if (expectOperand) {
+        return fail("expected an operand before", token.text);
+      }
+      while (operatorsTop > 0 and operatorsStack[operatorsTop - 1] !=
+                                      BooleanTokenType::LeftParenthesis) {
+        emit(operatorsStack[--operatorsTop]);
+      }
+      if (operatorsTop == 0) {
+        return fail("unmatched", token.text);
+      }
+      operatorsTop--; // Pop the '('
+      break;
+    default:
+      return fail("unknown token", token.text);
+    }
 
-      operatorsStack.pop(); // Pop the '('
-    } else {
-      std::print("Error: unknown token '{}'.", token);
-      return std::nullopt;
+    if (result.stackDepth > CompiledBooleanExpression::maxStackDepth) {
+      return fail("expression nests too deeply at", token.text);
     }
   }
 
-  while (not operatorsStack.empty()) {
-    if (operatorsStack.top() == "(") {
-      std::print("Error: unmatched '('.");
-      return std::nullopt;
+  if (expectOperand) {
+    return fail("expected an operand at the end of", expression);
+  }
+  while (operatorsTop > 0) {
+    if (operatorsStack[operatorsTop - 1] == BooleanTokenType::LeftParenthesis) {
+      return fail("unmatched", "(");
     }
+    emit(operatorsStack[--operatorsTop]);
+  }
 
-    result.postfixExpressionList.push_back(operatorsStack.top());
-    operatorsStack.pop();
+  // Renumber variables in name order, like ParsedBooleanExpression
+  std::ranges::sort(expressionVariables, [&](std::uint32_t a, std::uint32_t b) {
+    return variableTable.names[a] < variableTable.names[b];
+  });
+  result.variables.resize(expressionVariables.size());
+  for (std::size_t i = 0; i < expressionVariables.size(); i++) {
+    localIndex[expressionVariables[i]] = static_cast<std::uint32_t>(i);
+    result.variables[i] = variableTable.names[expressionVariables[i]];
+  }
+  for (auto &instruction : result.code) {
+    if (instruction.opcode == BooleanOpcode::PushVariable) {
+      instruction.variable = localIndex[instruction.variable];
+    }
+  }
+  for (std::uint32_t id : expressionVariables) {
+    localIndex[id] = unseen;
   }
 
-  std::print("Variables:\n");
-  for (const auto &var : result.variables) {
-    std::print("  {}\n", var);
+  if (statistics) {
+    statistics->expressionsParsed++;
   }
 
-  std::print("Expression Stack:\n");
-  for (const auto &token : result.postfixExpressionList) {
-    std::print("  {}\n", token);
+  return true;
+}
+
+std::optional<CompiledBooleanExpression>
+compileBooleanExpression(std::string_view expression,
+                         BooleanExpressionStatistics *statistics) {
+  BooleanExpressionParser parser;
+  CompiledBooleanExpression result;
+  if (not parser.parse(expression, result, statistics)) {
+    return std::nullopt;
+  }
+
+  return result;
+}
+
+std::optional<ParsedBooleanExpression>
+parseBooleanExpression(const std::string &expression,
+                       BooleanExpressionStatistics *statistics) {
+  auto compiledExpressionOpt = compileBooleanExpression(expression, statistics);
+  if (not compiledExpressionOpt) {
+    return std::nullopt;
+  }
+
+  ParsedBooleanExpression result;
+  result.variables.insert(compiledExpressionOpt->variables.begin(),
+                          compiledExpressionOpt->variables.end());
+  result.postfixExpressionList.reserve(compiledExpressionOpt->code.size());
+  for (const auto &instruction : compiledExpressionOpt->code) {
+    switch (instruction.opcode) {
+    case BooleanOpcode::PushVariable:
+      result.postfixExpressionList.push_back(
+          compiledExpressionOpt->variables[instruction.variable]);
+      break;
+    case BooleanOpcode::Not:
+      result.postfixExpressionList.push_back("NOT");
+      break;
+    case BooleanOpcode::And:
+      result.postfixExpressionList.push_back("AND");
+      break;
+    case BooleanOpcode::Or:
+      result.postfixExpressionList.push_back("OR");
+      break;
+    }
   }
 
   return result;
@@ -163,77 +443,267 @@ std::optional<bool> solveBooleanExpression(
   return solvingStack.top();
 }
 
-std::optional<std::vector<bool>> simulateBooleanExpression(
-    const ParsedBooleanExpression &parsedBooleanExpression) {
-  std::vector<bool> result;
-  std::size_t numVariables = parsedBooleanExpression.variables.size();
-  std::vector<std::string> variablesList(
-      parsedBooleanExpression.variables.begin(),
-      parsedBooleanExpression.variables.end());
-  const std::size_t totalCombinations = 1 << numVariables;
-  std::unordered_map<std::string, bool> variablesValue;
+std::optional<CompiledBooleanExpression>
+compileBooleanExpression(const ParsedBooleanExpression &parsedBooleanExpression) {
+  CompiledBooleanExpression result;
+  result.variables.assign(parsedBooleanExpression.variables.begin(),
+                          parsedBooleanExpression.variables.end());
+  result.code.reserve(parsedBooleanExpression.postfixExpressionList.size());
 
-  for (std::size_t i = 0; i < totalCombinations; i++) {
-    for (std::size_t bit = 0; bit < numVariables; bit++) {
-      bool value = (i >> bit) & 1;
-      variablesValue[variablesList[bit]] = value;
-    }
-    std::print("Simulating combination: ");
-    for (const auto &[var, val] : variablesValue) {
-      std::print("{}={}, ", var, val ? "1" : "0");
+  std::size_t depth = 0;
+  for (const auto &token : parsedBooleanExpression.postfixExpressionList) {
+    if (isBooleanVariable(token)) {
+      auto it = std::ranges::lower_bound(result.variables, token);
+      if (it == result.variables.end() or *it != token) {
+        std::print("Error: unknown variable '{}'.", token);
+        return std::nullopt;
+      }
+      result.code.push_back(
+          {BooleanOpcode::PushVariable,
+           static_cast<std::uint32_t>(it - result.variables.begin())});
+      depth++;
+    } else if (token == "NOT") {
+      if (depth < 1) {
+        return std::nullopt;
+      }
+      result.code.push_back({BooleanOpcode::Not});
+    } else if (token == "AND" or token == "OR") {
+      if (depth < 2) {
+        return std::nullopt;
+      }
+      result.code.push_back(
+          {token == "AND" ? BooleanOpcode::And : BooleanOpcode::Or});
+      depth--;
+    } else {
+      std::print("Error: unknown operator '{}'.", token);
+      return std::nullopt;
     }
-    std::print("\n");
 
-    auto resultOpt = solveBooleanExpression(
-        parsedBooleanExpression.postfixExpressionList, variablesValue);
-    if (resultOpt) {
-      result.push_back(*resultOpt);
-    } else {
+    result.stackDepth = std::max(result.stackDepth, depth);
+    if (result.stackDepth > CompiledBooleanExpression::maxStackDepth) {
+      std::print("Error: expression nests deeper than {} operands.",
+                 CompiledBooleanExpression::maxStackDepth);
       return std::nullopt;
     }
   }
 
+  if (depth != 1) {
+    return std::nullopt;
+  }
+
   return result;
 }
 
-bool isSameBooleanFunction(const std::string &expressionA,
-                           const std::string &expressionB) {
-  auto parsedBooleanExpressionAOpt = parseBooleanExpression(expressionA);
-  if (not parsedBooleanExpressionAOpt) {
+bool evaluateCompiledBooleanExpression(
+    const CompiledBooleanExpression &compiledExpression,
+    std::uint64_t variablesValue) {
+  std::array<bool, CompiledBooleanExpression::maxStackDepth> stack;
+  std::size_t top = 0;
+
+  for (const auto &instruction : compiledExpression.code) {
+    switch (instruction.opcode) {
+    case BooleanOpcode::PushVariable:
+      stack[top++] = (variablesValue >> instruction.variable) & 1;
+      break;
+    case BooleanOpcode::Not:
+      stack[top - 1] = not stack[top - 1];
+      break;
+    case BooleanOpcode::And:
+      top--;
+      stack[top - 1] = stack[top - 1] and stack[top];
+      break;
+    case BooleanOpcode::Or:
+      top--;
+      stack[top - 1] = stack[top - 1] or stack[top];
+      break;
+    }
+  }
+
+  return stack[0];
+}
+
+std::optional<std::vector<std::uint64_t>>
+computeTruthTable(const CompiledBooleanExpression &compiledExpression) {
+  const std::size_t numVariables = compiledExpression.variables.size();
+  if (numVariables > maxTruthTableVariables) {
+    std::print("Error: too many variables ({}) for a truth table.",
+               numVariables);
+    return std::nullopt;
+  }
+
+  const std::size_t totalWords = truthTableWords(numVariables);
+  const std::size_t blockWords = std::min(totalWords, bitSlicedBlockWords);
+  std::vector<Words> stack(compiledExpression.stackDepth *
+                           blockVectors(blockWords));
+  std::vector<std::uint64_t> result(totalWords);
+  for (std::size_t word = 0; word < totalWords; word += blockWords) {
+    evaluateBitSlicedBlock(compiledExpression, word, blockWords, stack.data(),
+                           result.data() + word);
+  }
+
+  return result;
+}
+
+std::optional<bool>
+hasSameTruthTable(const CompiledBooleanExpression &compiledExpressionA,
+                  const CompiledBooleanExpression &compiledExpressionB,
+                  std::uint64_t *firstDifference) {
+  if (compiledExpressionA.variables != compiledExpressionB.variables) {
+    return std::nullopt;
+  }
+
+  const std::size_t numVariables = compiledExpressionA.variables.size();
+  if (numVariables > maxTruthTableVariables) {
+    std::print("Error: too many variables ({}) for a truth table.",
+               numVariables);
+    return std::nullopt;
+  }
+
+  // Evaluate both expressions one block at a time and stop at the first
+  // block that differs, so unequal functions rarely cost a full table.
+  const std::size_t totalWords = truthTableWords(numVariables);
+  const std::size_t blockWords = std::min(totalWords, bitSlicedBlockWords);
+  std::vector<Words> stackA(compiledExpressionA.stackDepth *
+                            blockVectors(blockWords));
+  std::vector<Words> stackB(compiledExpressionB.stackDepth *
+                            blockVectors(blockWords));
+  std::vector<std::uint64_t> blockA(blockWords);
+  std::vector<std::uint64_t> blockB(blockWords);
+  for (std::size_t word = 0; word < totalWords; word += blockWords) {
+    evaluateBitSlicedBlock(compiledExpressionA, word, blockWords,
+                           stackA.data(), blockA.data());
+    evaluateBitSlicedBlock(compiledExpressionB, word, blockWords,
+                           stackB.data(), blockB.data());
+    if (blockA != blockB) {
+      if (firstDifference) {
+        auto mismatch = std::ranges::mismatch(blockA, blockB);
+        *firstDifference =
+            64 * (word + (mismatch.in1 - blockA.begin())) +
+            std::countr_zero(*mismatch.in1 ^ *mismatch.in2);
+      }
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::optional<std::vector<bool>>
+simulateBooleanExpression(const ParsedBooleanExpression &parsedBooleanExpression,
+                          BooleanExpressionStatistics *statistics) {
+  auto compiledExpressionOpt =
+      compileBooleanExpression(parsedBooleanExpression);
+  if (not compiledExpressionOpt) {
+    return std::nullopt;
+  }
+
+  auto truthTableOpt = computeTruthTable(*compiledExpressionOpt);
+  if (not truthTableOpt) {
+    return std::nullopt;
+  }
+
+  const std::size_t totalCombinations = std::size_t{1}
+                                        << compiledExpressionOpt->variables.size();
+  std::vector<bool> result(totalCombinations);
+  for (std::size_t i = 0; i < totalCombinations; i++) {
+    result[i] = ((*truthTableOpt)[i / 64] >> (i % 64)) & 1;
+  }
+
+  if (statistics) {
+    statistics->combinationsSimulated += totalCombinations;
+  }
+
+  return result;
+}
+
+std::optional<BooleanEquivalenceResult>
+checkBooleanEquivalence(const std::string &expressionA,
+                        const std::string &expressionB,
+                        EquivalenceCheckMethod method) {
+  auto compiledExpressionAOpt = compileBooleanExpression(expressionA);
+  if (not compiledExpressionAOpt) {
     std::print("Failed to parse expression A '{}'\n", expressionA);
-    return false;
+    return std::nullopt;
   }
 
-  auto parsedBooleanExpressionBOpt = parseBooleanExpression(expressionB);
-  if (not parsedBooleanExpressionBOpt) {
+  auto compiledExpressionBOpt = compileBooleanExpression(expressionB);
+  if (not compiledExpressionBOpt) {
     std::print("Failed to parse expression B '{}'\n", expressionB);
-    return false;
+    return std::nullopt;
   }
 
-  const ParsedBooleanExpression &parsedBooleanExpressionA =
-      *parsedBooleanExpressionAOpt;
-  const ParsedBooleanExpression &parsedBooleanExpressionB =
-      *parsedBooleanExpressionBOpt;
-  if (parsedBooleanExpressionA.variables !=
-      parsedBooleanExpressionB.variables) {
+  if (compiledExpressionAOpt->variables != compiledExpressionBOpt->variables) {
     std::print("Expressions have different variables.\n");
-    return false;
+    return BooleanEquivalenceResult{};
   }
 
-  auto expressionAResultsOpt =
-      simulateBooleanExpression(parsedBooleanExpressionA);
-  if (not expressionAResultsOpt) {
-    std::print("Failed to simulate expression A '{}'\n", expressionA);
-    return false;
+  const auto &variables = compiledExpressionAOpt->variables;
+  if (method == EquivalenceCheckMethod::TruthTable or
+      (method == EquivalenceCheckMethod::Automatic and
+       variables.size() <= maxAutomaticTruthTableVariables)) {
+    std::uint64_t firstDifference = 0;
+    auto isSameOpt = hasSameTruthTable(
+        *compiledExpressionAOpt, *compiledExpressionBOpt, &firstDifference);
+    if (not isSameOpt) {
+      std::print("Failed to simulate expressions '{}' and '{}'\n",
+                 expressionA, expressionB);
+      return std::nullopt;
+    }
+
+    BooleanEquivalenceResult result{.equivalent = *isSameOpt};
+    if (not result.equivalent) {
+      for (std::size_t bit = 0; bit < variables.size(); bit++) {
+        result.counterexample[variables[bit]] = (firstDifference >> bit) & 1;
+      }
+    }
+    return result;
   }
 
-  auto expressionBResultsOpt =
-      simulateBooleanExpression(parsedBooleanExpressionB);
-  if (not expressionBResultsOpt) {
-    std::print("Failed to simulate expression B '{}'\n", expressionB);
-    return false;
+  if (method == EquivalenceCheckMethod::BDD or
+      method == EquivalenceCheckMethod::Automatic) {
+    // In automatic mode give up on the BDD once it grows past the node limit
+    // and let the SAT solver decide instead
+    BDDManager bddManager;
+    if (method == EquivalenceCheckMethod::Automatic) {
+      bddManager.maxNodes = maxAutomaticBDDNodes;
+    }
+
+    auto bddAOpt = bddManager.build(*compiledExpressionAOpt);
+    auto bddBOpt = bddAOpt ? bddManager.build(*compiledExpressionBOpt)
+                           : std::nullopt;
+    // The difference behind a counterexample is one more apply, which can
+    // hit the limit as well
+    BDDNode difference = BDDManager::falseNode;
+    if (bddAOpt and bddBOpt and *bddAOpt != *bddBOpt) {
+      difference = bddManager.apply(BDDOperation::Xor, *bddAOpt, *bddBOpt);
+    }
+    if (bddAOpt and bddBOpt and not bddManager.nodeLimitReached) {
+      BooleanEquivalenceResult result{.equivalent = *bddAOpt == *bddBOpt};
+      if (not result.equivalent) {
+        result.counterexample = *bddManager.satisfyingAssignment(difference);
+        // Variables off the chosen path may take any value
+        for (const auto &variable : variables) {
+          result.counterexample.try_emplace(variable, false);
+        }
+      }
+      return result;
+    }
+
+    if (method == EquivalenceCheckMethod::BDD) {
+      std::print("Failed to build BDDs for '{}' and '{}'\n", expressionA,
+                 expressionB);
+      return std::nullopt;
+    }
   }
 
-  return *expressionAResultsOpt == *expressionBResultsOpt;
+  return checkEquivalenceWithSAT(*compiledExpressionAOpt,
+                                 *compiledExpressionBOpt);
+}
+
+bool isSameBooleanFunction(const std::string &expressionA,
+                           const std::string &expressionB,
+                           EquivalenceCheckMethod method) {
+  auto resultOpt = checkBooleanEquivalence(expressionA, expressionB, method);
+  return resultOpt and resultOpt->equivalent;
 }
 } // namespace SCO
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <optional>
 #include <print>
 #include <set>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -11,18 +17,140 @@ struct ParsedBooleanExpression {
   std::set<std::string> variables;
 };
 
-auto splitBooleanExpressionIntoTokens(const std::string &expression);
+// Optional counters filled in by the parser and the simulator instead of
+// printing a trace of every token and combination.
+struct BooleanExpressionStatistics {
+  std::size_t expressionsParsed = 0;
+  std::size_t tokensParsed = 0;
+  std::size_t combinationsSimulated = 0;
+};
+
+enum class BooleanOpcode : std::uint8_t { PushVariable = 0, Not, And, Or };
+
+struct BooleanInstruction {
+  BooleanOpcode opcode;
+  // Dense variable index, only meaningful for PushVariable
+  std::uint32_t variable = 0;
+};
+
+// Postfix expression with every variable resolved to its index in the sorted
+// variables list, so evaluation needs neither string compares nor lookups.
+struct CompiledBooleanExpression {
+  static constexpr std::size_t maxStackDepth = 256;
+
+  std::vector<BooleanInstruction> code;
+  std::vector<std::string> variables;
+  std::size_t stackDepth = 0;
+};
+
+// Largest variable count computeTruthTable and hasSameTruthTable accept
+inline constexpr std::size_t maxTruthTableVariables = 32;
+
+enum class BooleanTokenType : std::uint8_t {
+  Variable = 0,
+  Not,
+  And,
+  Or,
+  LeftParenthesis,
+  RightParenthesis,
+  End,
+  Invalid,
+};
+
+struct BooleanToken {
+  BooleanTokenType type;
+  std::string_view text;
+};
+
+// Single pass tokenizer, tokens are views into the input
+struct BooleanLexer {
+  std::string_view input;
+  std::size_t position = 0;
+
+  BooleanToken next();
+};
+
+// Interns variable names to dense ids. Names live in a deque so the
+// string_view keys stay valid as the table grows.
+struct BooleanVariableTable {
+  std::deque<std::string> names;
+  std::unordered_map<std::string_view, std::uint32_t> ids;
+
+  std::uint32_t intern(std::string_view name);
+};
+
+// Parses expressions straight into opcodes. Keep one parser around for a
+// batch: the variable table and scratch buffers are reused, so once warmed
+// up parsing allocates nothing beyond growing the result.
+struct BooleanExpressionParser {
+  BooleanVariableTable variableTable;
+  std::array<BooleanTokenType, CompiledBooleanExpression::maxStackDepth>
+      operatorsStack;
+  std::vector<std::uint32_t> localIndex;
+  std::vector<std::uint32_t> expressionVariables;
+
+  bool parse(std::string_view expression, CompiledBooleanExpression &result,
+             BooleanExpressionStatistics *statistics = nullptr);
+};
+
+std::optional<CompiledBooleanExpression>
+compileBooleanExpression(std::string_view expression,
+                         BooleanExpressionStatistics *statistics = nullptr);
 bool isBooleanOperator(const std::string &token);
 bool isBooleanVariable(const std::string &token);
 std::optional<bool>
 booleanOperatorHasHigherPrecedence(const std::string &operator1,
                                    const std::string &operator2);
 std::optional<ParsedBooleanExpression>
-parseBooleanExpression(const std::string &expression);
+parseBooleanExpression(const std::string &expression,
+                       BooleanExpressionStatistics *statistics = nullptr);
 std::optional<bool> solveBooleanExpression(
     const std::vector<std::string> &postfixExpressionList,
     const std::unordered_map<std::string, bool> &variablesValue);
+std::optional<CompiledBooleanExpression>
+compileBooleanExpression(const ParsedBooleanExpression &parsedBooleanExpression);
+// Bit i of variablesValue is the value of compiledExpression.variables[i]
+bool evaluateCompiledBooleanExpression(
+    const CompiledBooleanExpression &compiledExpression,
+    std::uint64_t variablesValue);
+// Bit-sliced evaluation: combination i of the truth table is bit i % 64 of
+// word i / 64, with variable k toggling every 2^k combinations.
+std::optional<std::vector<std::uint64_t>>
+computeTruthTable(const CompiledBooleanExpression &compiledExpression);
+// When the tables differ, firstDifference receives the first combination
+// on which they do
+std::optional<bool>
+hasSameTruthTable(const CompiledBooleanExpression &compiledExpressionA,
+                  const CompiledBooleanExpression &compiledExpressionB,
+                  std::uint64_t *firstDifference = nullptr);
+std::optional<std::vector<bool>>
+simulateBooleanExpression(const ParsedBooleanExpression &parsedBooleanExpression,
+                          BooleanExpressionStatistics *statistics = nullptr);
+
+enum class EquivalenceCheckMethod {
+  // Truth table for few variables, then a size-limited BDD, then SAT
+  Automatic = 0,
+  TruthTable,
+  BDD,
+  SAT,
+};
+
+// Automatic uses the truth table up to this many variables
+inline constexpr std::size_t maxAutomaticTruthTableVariables = 16;
+// and falls back from the BDD to SAT past this many nodes
+inline constexpr std::size_t maxAutomaticBDDNodes = 1 << 20;
+
+struct BooleanEquivalenceResult {
+  bool equivalent = false;
+  // An assignment on which the expressions differ, empty when they are
+  // equivalent or have different variables
+  std::unordered_map<std::string, bool> counterexample;
+};
 
-bool isSameBooleanFunction(const std::string &expressionA,
-                           const std::string &expressionB);
+std::optional<BooleanEquivalenceResult> checkBooleanEquivalence(
+    const std::string &expressionA, const std::string &expressionB,
+    EquivalenceCheckMethod method = EquivalenceCheckMethod::Automatic);
+bool isSameBooleanFunction(
+    const std::string &expressionA, const std::string &expressionB,
+    EquivalenceCheckMethod method = EquivalenceCheckMethod::Automatic);
 } // namespace SCO
@@ -0,0 +1,248 @@
+#include "chapter3_problem47_bdd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace SCO {
+namespace {
+std::uint64_t hashTriple(std::uint64_t a, std::uint64_t b, std::uint64_t c) {
+  std::uint64_t hash = a * 0x9E3779B97F4A7C15;
+  hash = (hash ^ b) * 0xC2B2AE3D27D4EB4F;
+  hash = (hash ^ c) * 0x165667B19E3779F9;
+  return hash ^ (hash >> 32);
+}
+} // namespace
+
+BDDManager::BDDManager(std::size_t computedTableSize)
+    : uniqueTable(1024, falseNode),
+      computedTable(std::bit_ceil(computedTableSize),
+                    BDDComputedEntry{BDDOperation::Not, falseNode, falseNode,
+                                     falseNode}) {
+  nodes.push_back({terminalVariable, falseNode, falseNode});
+  nodes.push_back({terminalVariable, trueNode, trueNode});
+}
+
+std::uint32_t BDDManager::internVariable(const std::string &name) {
+  auto [it, inserted] = variablesIndex.try_emplace(
+      name, static_cast<std::uint32_t>(variables.size()));
+  if (inserted) {
+    variables.push_back(name);
+  }
+  return it->second;
+}
+
+BDDNode BDDManager::variable(std::uint32_t index) {
+  return makeNode(index, falseNode, trueNode);
+}
+
+void BDDManager::growUniqueTable() {
+  std::vector<BDDNode> newTable(uniqueTable.size() * 2, falseNode);
+  const std::size_t mask = newTable.size() - 1;
+  for (BDDNode node : uniqueTable) {
+    if (node == falseNode) {
+      continue;
+    }
+    const auto &data = nodes[node];
+    std::size_t slot = hashTriple(data.variable, data.low, data.high) & mask;
+    while (newTable[slot] != falseNode) {
+      slot = (slot + 1) & mask;
+    }
+    newTable[slot] = node;
+  }
+  uniqueTable.swap(newTable);
+}
+
+BDDNode BDDManager::makeNode(std::uint32_t variable, BDDNode low,
+                             BDDNode high) {
+  if (low == high) {
+    return low;
+  }
+
+  // Keep the load factor under 1/2
+  if (2 * nodes.size() >= uniqueTable.size()) {
+    growUniqueTable();
+  }
+
+  const std::size_t mask = uniqueTable.size() - 1;
+  std::size_t slot = hashTriple(variable, low, high) & mask;
+  while (uniqueTable[slot] != falseNode) {
+    const auto &data = nodes[uniqueTable[slot]];
+    if (data.variable == variable and data.low == low and data.high == high) {
+      return uniqueTable[slot];
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  if (maxNodes != 0 and nodes.size() >= maxNodes) {
+    nodeLimitReached = true;
+    return falseNode;
+  }
+  BDDNode node = static_cast<BDDNode>(nodes.size());
+  nodes.push_back({variable, low, high});
+  uniqueTable[slot] = node;
+  return node;
+}
+
+BDDNode BDDManager::apply(BDDOperation operation, BDDNode f, BDDNode g) {
+  // Terminal cases
+  switch (operation) {
+  case BDDOperation::Not:
+    if (f == falseNode or f == trueNode) {
+      return f == falseNode ? trueNode : falseNode;
+    }
+    g = falseNode;
+    break;
+  case BDDOperation::And:
+    if (f == falseNode or g == falseNode) {
+      return falseNode;
+    }
+    if (f == trueNode or f == g) {
+      return g;
+    }
+    if (g == trueNode) {
+      return f;
+    }
+    break;
+  case BDDOperation::Or:
+    if (f == trueNode or g == trueNode) {
+      return trueNode;
+    }
+    if (f == falseNode or f == g) {
+      return g;
+    }
+    if (g == falseNode) {
+      return f;
+    }
+    break;
+  case BDDOperation::Xor:
+    if (f == g) {
+      return falseNode;
+    }
+    if (f == falseNode) {
+      return g;
+    }
+    if (g == falseNode) {
+      return f;
+    }
+    if (f == trueNode) {
+      return negate(g);
+    }
+    if (g == trueNode) {
+      return negate(f);
+    }
+    break;
+  }
+
+  // All binary operations are commutative
+  if (operation != BDDOperation::Not and f > g) {
+    std::swap(f, g);
+  }
+
+  auto &entry = computedTable[hashTriple(std::to_underlying(operation), f, g) &
+                              (computedTable.size() - 1)];
+  if (entry.operation == operation and entry.f == f and entry.g == g) {
+    return entry.result;
+  }
+
+  const std::uint32_t topVariable =
+      std::min(nodes[f].variable, nodes[g].variable);
+  auto cofactors = [&](BDDNode node) {
+    const auto &data = nodes[node];
+    return data.variable == topVariable ? std::pair{data.low, data.high}
+                                        : std::pair{node, node};
+  };
+  auto [fLow, fHigh] = cofactors(f);
+  auto [gLow, gHigh] = cofactors(g);
+
+  // Unwind as soon as the node limit is hit rather than finish, or cache, a
+  // result built from placeholder nodes
+  BDDNode low = apply(operation, fLow, gLow);
+  if (nodeLimitReached) {
+    return falseNode;
+  }
+  BDDNode high = apply(operation, fHigh, gHigh);
+  if (nodeLimitReached) {
+    return falseNode;
+  }
+  BDDNode result = makeNode(topVariable, low, high);
+  if (nodeLimitReached) {
+    return falseNode;
+  }
+
+  // The recursive calls may have overwritten the slot, which is fine for a
+  // cache
+  entry = {operation, f, g, result};
+  return result;
+}
+
+std::optional<BDDNode>
+BDDManager::build(const CompiledBooleanExpression &compiledExpression) {
+  std::vector<std::uint32_t> variablesMapping(
+      compiledExpression.variables.size(), terminalVariable);
+  std::vector<BDDNode> stack;
+  stack.reserve(compiledExpression.stackDepth);
+  nodeLimitReached = false;
+
+  for (const auto &instruction : compiledExpression.code) {
+    switch (instruction.opcode) {
+    case BooleanOpcode::PushVariable: {
+      auto &mapped = variablesMapping[instruction.variable];
+      if (mapped == terminalVariable) {
+        mapped =
+            internVariable(compiledExpression.variables[instruction.variable]);
+      }
+      stack.push_back(variable(mapped));
+      break;
+    }
+    case BooleanOpcode::Not:
+      if (stack.empty()) {
+        return std::nullopt;
+      }
+      stack.back() = negate(stack.back());
+      break;
+    case BooleanOpcode::And:
+    case BooleanOpcode::Or: {
+      if (stack.size() < 2) {
+        return std::nullopt;
+      }
+      BDDNode g = stack.back();
+      stack.pop_back();
+      stack.back() = apply(instruction.opcode == BooleanOpcode::And
+                               ? BDDOperation::And
+                               : BDDOperation::Or,
+                           stack.back(), g);
+      break;
+    }
+    }
+
+    if (nodeLimitReached) {
+      return std::nullopt;
+    }
+  }
+
+  if (stack.size() != 1) {
+    return std::nullopt;
+  }
+
+  return stack.back();
+}
+
+std::optional<std::unordered_map<std::string, bool>>
+BDDManager::satisfyingAssignment(BDDNode f) const {
+  if (f == falseNode) {
+    return std::nullopt;
+  }
+
+  // Every non-terminal node of a reduced BDD reaches the true terminal
+  std::unordered_map<std::string, bool> assignment;
+  while (f != trueNode) {
+    const auto &data = nodes[f];
+    bool takeHigh = data.low == falseNode;
+    assignment[variables[data.variable]] = takeHigh;
+    f = takeHigh ? data.high : data.low;
+  }
+
+  return assignment;
+}
+} // namespace SCO
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "chapter3_problem47.hpp"
+
+namespace SCO {
+// Reduced ordered binary decision diagrams. Nodes are hash-consed, so two
+// functions built in the same manager are equal iff their node ids are.
+using BDDNode = std::uint32_t;
+
+enum class BDDOperation : std::uint32_t { Not = 0, And, Or, Xor };
+
+struct BDDNodeData {
+  std::uint32_t variable;
+  BDDNode low;
+  BDDNode high;
+};
+
+struct BDDComputedEntry {
+  BDDOperation operation;
+  BDDNode f;
+  BDDNode g;
+  BDDNode result;
+};
+
+struct BDDManager {
+  static constexpr BDDNode falseNode = 0;
+  static constexpr BDDNode trueNode = 1;
+  static constexpr std::uint32_t terminalVariable = UINT32_MAX;
+
+  // Pooled node storage, indexed by BDDNode
+  std::vector<BDDNodeData> nodes;
+  // Open addressing table of non-terminal node ids, 0 marks an empty slot
+  std::vector<BDDNode> uniqueTable;
+  // Direct mapped cache of apply results
+  std::vector<BDDComputedEntry> computedTable;
+  // Variable order is the order in which names are first interned
+  std::vector<std::string> variables;
+  std::unordered_map<std::string, std::uint32_t> variablesIndex;
+  // makeNode refuses to grow the pool past this many nodes, 0 for no limit
+  std::size_t maxNodes = 0;
+  // Set when makeNode hit maxNodes. apply then unwinds at once and its
+  // result means nothing; build clears it on entry.
+  bool nodeLimitReached = false;
+
+  BDDManager(std::size_t computedTableSize = 1 << 16);
+
+  std::uint32_t internVariable(const std::string &name);
+  BDDNode variable(std::uint32_t index);
+  BDDNode makeNode(std::uint32_t variable, BDDNode low, BDDNode high);
+  BDDNode apply(BDDOperation operation, BDDNode f, BDDNode g = falseNode);
+  BDDNode negate(BDDNode f) { return apply(BDDOperation::Not, f); }
+
+  // Builds the BDD of a compiled expression, interning its variables in
+  // order of first use. nullopt if the expression is malformed or the node
+  // limit is exceeded.
+  std::optional<BDDNode>
+  build(const CompiledBooleanExpression &compiledExpression);
+
+  // Any assignment that makes f true, or nullopt if f is constant false.
+  // Variables not on the chosen path are left out.
+  std::optional<std::unordered_map<std::string, bool>>
+  satisfyingAssignment(BDDNode f) const;
+
+  std::size_t size() const { return nodes.size(); }
+  void growUniqueTable();
+};
+} // namespace SCO
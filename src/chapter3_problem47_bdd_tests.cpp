@@ -0,0 +1,95 @@
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "chapter3_problem47_bdd.hpp"
+
+namespace SCO {
+namespace {
+std::optional<BDDNode> buildExpression(BDDManager &bddManager,
+                                       const std::string &expression) {
+  auto parsedExpressionOpt = parseBooleanExpression(expression);
+  if (not parsedExpressionOpt) {
+    return std::nullopt;
+  }
+  auto compiledExpressionOpt = compileBooleanExpression(*parsedExpressionOpt);
+  if (not compiledExpressionOpt) {
+    return std::nullopt;
+  }
+  return bddManager.build(*compiledExpressionOpt);
+}
+} // namespace
+
+TEST(BDDTest, EquivalentExpressionsShareNode) {
+  BDDManager bddManager;
+  auto a = buildExpression(bddManager, "NOT (A AND B) OR C");
+  auto b = buildExpression(bddManager, "C OR NOT B OR NOT A");
+  auto c = buildExpression(bddManager, "A AND (B OR C)");
+  ASSERT_TRUE(a and b and c);
+  EXPECT_EQ(*a, *b);
+  EXPECT_NE(*a, *c);
+
+  auto contradiction = buildExpression(bddManager, "A AND NOT A");
+  auto tautology = buildExpression(bddManager, "A OR NOT A");
+  ASSERT_TRUE(contradiction and tautology);
+  EXPECT_EQ(*contradiction, BDDManager::falseNode);
+  EXPECT_EQ(*tautology, BDDManager::trueNode);
+}
+
+TEST(BDDTest, SatisfyingAssignmentIsCounterexample) {
+  BDDManager bddManager;
+  auto a = buildExpression(bddManager, "A AND (B OR C)");
+  auto b = buildExpression(bddManager, "(A AND B) OR C");
+  ASSERT_TRUE(a and b);
+
+  auto difference = bddManager.apply(BDDOperation::Xor, *a, *b);
+  auto assignmentOpt = bddManager.satisfyingAssignment(difference);
+  ASSERT_TRUE(assignmentOpt.has_value());
+
+  // Only C=1, A=0 tells the two apart
+  EXPECT_EQ(assignmentOpt->at("A"), false);
+  EXPECT_EQ(assignmentOpt->at("C"), true);
+  EXPECT_FALSE(bddManager.satisfyingAssignment(BDDManager::falseNode));
+}
+
+TEST(BDDTest, NodeLimitStopsInsideApply) {
+  std::string sumOfProducts;
+  for (int i = 0; i < 30; i++) {
+    sumOfProducts += (i ? " OR " : "") + ("(x" + std::to_string(i) +
+                                          " AND y" + std::to_string(i) + ")");
+  }
+
+  BDDManager bddManager;
+  bddManager.maxNodes = 16;
+  EXPECT_FALSE(buildExpression(bddManager, sumOfProducts).has_value());
+  EXPECT_TRUE(bddManager.nodeLimitReached);
+  EXPECT_LE(bddManager.size(), 16u);
+
+  // Nodes built before the limit are still sound
+  bddManager.maxNodes = 0;
+  auto a = buildExpression(bddManager, "x0 AND y0");
+  ASSERT_TRUE(a.has_value());
+  EXPECT_FALSE(bddManager.nodeLimitReached);
+  EXPECT_EQ(bddManager.satisfyingAssignment(*a)->at("x0"), true);
+}
+
+TEST(BDDTest, SixtyVariables) {
+  std::string sumOfProducts;
+  std::string negatedProductOfSums = "NOT (";
+  for (int i = 0; i < 30; i++) {
+    std::string term = "(x" + std::to_string(i) + " AND y" +
+                       std::to_string(i) + ")";
+    sumOfProducts += (i ? " OR " : "") + term;
+    negatedProductOfSums += (i ? " AND NOT " : "NOT ") + term;
+  }
+  negatedProductOfSums += ")";
+
+  EXPECT_TRUE(isSameBooleanFunction(sumOfProducts, negatedProductOfSums));
+  EXPECT_TRUE(isSameBooleanFunction(sumOfProducts, negatedProductOfSums,
+                                    EquivalenceCheckMethod::BDD));
+
+  std::string almost = sumOfProducts;
+  almost.replace(almost.find("x7 AND"), 6, "x7 OR ");
+  EXPECT_FALSE(isSameBooleanFunction(sumOfProducts, almost));
+}
+} // namespace SCO
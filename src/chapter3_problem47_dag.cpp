@@ -0,0 +1,125 @@
+#include "chapter3_problem47_dag.hpp"
+
+#include <utility>
+
+namespace SCO {
+std::optional<BooleanExpressionId>
+BooleanExpressionDAG::add(std::string_view expression) {
+  if (not parser.parse(expression, compiledExpression)) {
+    return std::nullopt;
+  }
+
+  // The parser numbers variables per expression; map them back to the
+  // batch-wide ids of its variable table
+  stack.clear();
+  for (const auto &instruction : compiledExpression.code) {
+    switch (instruction.opcode) {
+    case BooleanOpcode::PushVariable:
+      stack.push_back(makeNode(
+          BooleanOpcode::PushVariable,
+          parser.variableTable.ids.at(
+              compiledExpression.variables[instruction.variable])));
+      break;
+    case BooleanOpcode::Not:
+      stack.back() = makeNode(BooleanOpcode::Not, stack.back());
+      break;
+    case BooleanOpcode::And:
+    case BooleanOpcode::Or: {
+      BooleanExpressionId b = stack.back();
+      stack.pop_back();
+      stack.back() = makeNode(instruction.opcode, stack.back(), b);
+      break;
+    }
+    }
+  }
+
+  statistics.expressionsAdded++;
+  return stack.back();
+}
+
+BooleanExpressionId BooleanExpressionDAG::makeNode(BooleanOpcode opcode,
+                                                   std::uint32_t a,
+                                                   std::uint32_t b) {
+  if (opcode == BooleanOpcode::Not and
+      nodes[a].opcode == BooleanOpcode::Not) {
+    return nodes[a].a;
+  }
+  if (opcode == BooleanOpcode::And or opcode == BooleanOpcode::Or) {
+    if (a > b) {
+      std::swap(a, b);
+    }
+  }
+
+  const std::uint64_t key = (std::uint64_t{a} << 32) | b;
+  auto [it, inserted] = uniqueTables[std::to_underlying(opcode)].try_emplace(
+      key, static_cast<BooleanExpressionId>(nodes.size()));
+  if (inserted) {
+    nodes.push_back({opcode, a, b});
+    bdds.push_back(noBDD);
+  } else {
+    statistics.sharedNodes++;
+  }
+
+  return it->second;
+}
+
+BDDNode BooleanExpressionDAG::getBDD(BooleanExpressionId id) {
+  if (bdds[id] != noBDD) {
+    statistics.bddCacheHits++;
+    return bdds[id];
+  }
+
+  // Children always have smaller ids than their parents, so an explicit
+  // post-order walk fills the cache without deep recursion
+  std::vector<BooleanExpressionId> pending = {id};
+  while (not pending.empty()) {
+    BooleanExpressionId current = pending.back();
+    const auto node = nodes[current];
+    if (bdds[current] != noBDD) {
+      pending.pop_back();
+      continue;
+    }
+
+    if (node.opcode == BooleanOpcode::PushVariable) {
+      bdds[current] = bddManager.variable(
+          bddManager.internVariable(parser.variableTable.names[node.a]));
+      pending.pop_back();
+      continue;
+    }
+
+    const bool binary = node.opcode != BooleanOpcode::Not;
+    if (bdds[node.a] == noBDD) {
+      pending.push_back(node.a);
+      continue;
+    }
+    if (binary and bdds[node.b] == noBDD) {
+      pending.push_back(node.b);
+      continue;
+    }
+
+    switch (node.opcode) {
+    case BooleanOpcode::Not:
+      bdds[current] = bddManager.negate(bdds[node.a]);
+      break;
+    case BooleanOpcode::And:
+      bdds[current] =
+          bddManager.apply(BDDOperation::And, bdds[node.a], bdds[node.b]);
+      break;
+    case BooleanOpcode::Or:
+      bdds[current] =
+          bddManager.apply(BDDOperation::Or, bdds[node.a], bdds[node.b]);
+      break;
+    case BooleanOpcode::PushVariable:
+      break;
+    }
+    pending.pop_back();
+  }
+
+  return bdds[id];
+}
+
+bool BooleanExpressionDAG::isSameFunction(BooleanExpressionId idA,
+                                          BooleanExpressionId idB) {
+  return idA == idB or getBDD(idA) == getBDD(idB);
+}
+} // namespace SCO
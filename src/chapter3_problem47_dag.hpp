@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "chapter3_problem47.hpp"
+#include "chapter3_problem47_bdd.hpp"
+
+namespace SCO {
+using BooleanExpressionId = std::uint32_t;
+
+// PushVariable nodes keep the variable's id from the parser's variable table
+// in a; Not uses a; And and Or use a <= b.
+struct BooleanExpressionNode {
+  BooleanOpcode opcode;
+  std::uint32_t a = 0;
+  std::uint32_t b = 0;
+};
+
+struct BooleanExpressionDAGStatistics {
+  std::size_t expressionsAdded = 0;
+  std::size_t sharedNodes = 0;
+  std::size_t bddCacheHits = 0;
+};
+
+// Shared, hash-consed DAG for a batch of related expressions. Structurally
+// identical subterms, up to operand order of AND and OR, map to one node,
+// and each node's BDD is computed once and cached by node id, so repeated
+// and overlapping equivalence queries reuse earlier work.
+//
+// Unlike isSameBooleanFunction, isSameFunction compares functions over the
+// union of their variables: 'A OR NOT A' and 'B OR NOT B' are the same.
+struct BooleanExpressionDAG {
+  static constexpr BDDNode noBDD = UINT32_MAX;
+
+  BooleanExpressionParser parser;
+  std::vector<BooleanExpressionNode> nodes;
+  // One table per opcode, keyed by (a << 32) | b
+  std::array<std::unordered_map<std::uint64_t, BooleanExpressionId>, 4>
+      uniqueTables;
+  BDDManager bddManager;
+  std::vector<BDDNode> bdds;
+  BooleanExpressionDAGStatistics statistics;
+
+  // Scratch buffers reused between calls
+  CompiledBooleanExpression compiledExpression;
+  std::vector<BooleanExpressionId> stack;
+
+  std::optional<BooleanExpressionId> add(std::string_view expression);
+  BooleanExpressionId makeNode(BooleanOpcode opcode, std::uint32_t a,
+                               std::uint32_t b = 0);
+  BDDNode getBDD(BooleanExpressionId id);
+  bool isSameFunction(BooleanExpressionId idA, BooleanExpressionId idB);
+};
+} // namespace SCO
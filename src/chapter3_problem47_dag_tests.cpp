@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+
+#include "chapter3_problem47_dag.hpp"
+
+namespace SCO {
+TEST(BooleanExpressionDAGTest, IdenticalSubtermsShareNodes) {
+  BooleanExpressionDAG dag;
+  auto a = dag.add("(A AND B) OR C");
+  auto b = dag.add("C OR (B AND A)");
+  ASSERT_TRUE(a and b);
+  EXPECT_EQ(*a, *b);
+
+  // Three variables, one AND and one OR
+  EXPECT_EQ(dag.nodes.size(), 5);
+
+  auto c = dag.add("NOT NOT ((B AND A) OR C)");
+  ASSERT_TRUE(c);
+  EXPECT_EQ(*a, *c);
+  std::size_t sizeBefore = dag.nodes.size();
+  auto d = dag.add("NOT (A AND B)");
+  ASSERT_TRUE(d);
+  EXPECT_EQ(dag.nodes.size(), sizeBefore + 1);
+  EXPECT_GT(dag.statistics.sharedNodes, 0);
+}
+
+TEST(BooleanExpressionDAGTest, DistinctOperandsGetDistinctNodes) {
+  BooleanExpressionDAG dag;
+  // Operand pairs that agree once a is shifted onto b's top bit, and the
+  // same operands under different opcodes
+  BooleanExpressionId x = dag.makeNode(BooleanOpcode::And, 1, 1);
+  BooleanExpressionId y =
+      dag.makeNode(BooleanOpcode::And, 0, (std::uint32_t{1} << 31) | 1);
+  BooleanExpressionId z = dag.makeNode(BooleanOpcode::Or, 1, 1);
+  EXPECT_NE(x, y);
+  EXPECT_NE(x, z);
+  EXPECT_EQ(dag.makeNode(BooleanOpcode::And, 1, 1), x);
+  EXPECT_EQ(dag.nodes.size(), 3);
+}
+
+TEST(BooleanExpressionDAGTest, EquivalenceQueriesReuseBDDs) {
+  BooleanExpressionDAG dag;
+  auto a = dag.add("NOT (A AND B) OR C");
+  auto b = dag.add("(NOT A OR NOT B) OR C");
+  auto c = dag.add("A AND (B OR C)");
+  ASSERT_TRUE(a and b and c);
+
+  EXPECT_TRUE(dag.isSameFunction(*a, *b));
+  EXPECT_FALSE(dag.isSameFunction(*a, *c));
+  std::size_t bddNodes = dag.bddManager.size();
+  std::size_t cacheHits = dag.statistics.bddCacheHits;
+
+  EXPECT_TRUE(dag.isSameFunction(*b, *a));
+  EXPECT_EQ(dag.bddManager.size(), bddNodes);
+  EXPECT_EQ(dag.statistics.bddCacheHits, cacheHits + 2);
+
+  // Functions are compared over the union of their variables
+  auto tautologyA = dag.add("A OR NOT A");
+  auto tautologyB = dag.add("B OR NOT B");
+  ASSERT_TRUE(tautologyA and tautologyB);
+  EXPECT_TRUE(dag.isSameFunction(*tautologyA, *tautologyB));
+
+  EXPECT_FALSE(dag.add("A AND"));
+}
+} // namespace SCO
@@ -0,0 +1,591 @@
+#include "chapter3_problem47_minimize.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <print>
+#include <unordered_set>
+#include <utility>
+
+namespace SCO {
+namespace {
+std::uint64_t cubeKey(Cube cube) {
+  return (std::uint64_t{cube.care} << 32) | cube.value;
+}
+
+bool getMinterm(const std::vector<std::uint64_t> &truthTable,
+                std::uint64_t minterm) {
+  return minterm / 64 < truthTable.size() and
+         ((truthTable[minterm / 64] >> (minterm % 64)) & 1);
+}
+
+// Calls function for every minterm of cube by enumerating the subsets of
+// its free variables
+template <typename Function>
+void forEachMinterm(Cube cube, std::size_t numVariables, Function function) {
+  const std::uint32_t free =
+      ~cube.care & static_cast<std::uint32_t>((std::uint64_t{1} << numVariables) - 1);
+  std::uint32_t subset = 0;
+  do {
+    function(cube.value | subset);
+    subset = (subset - free) & free;
+  } while (subset != 0);
+}
+
+bool isCubeInside(Cube cube, const std::vector<std::uint64_t> &allowed,
+                  std::size_t numVariables) {
+  bool inside = true;
+  forEachMinterm(cube, numVariables, [&](std::uint32_t minterm) {
+    inside = inside and getMinterm(allowed, minterm);
+  });
+  return inside;
+}
+
+// a contains b
+bool cubeContains(Cube a, Cube b) {
+  return (a.care & ~b.care) == 0 and ((a.value ^ b.value) & a.care) == 0;
+}
+
+std::pair<std::size_t, std::size_t> coverCost(const std::vector<Cube> &cubes) {
+  std::size_t literals = 0;
+  for (const auto &cube : cubes) {
+    literals += std::popcount(cube.care);
+  }
+  return {cubes.size(), literals};
+}
+
+void removeContainedCubes(std::vector<Cube> &cubes) {
+  std::ranges::sort(cubes, [](Cube a, Cube b) {
+    return std::popcount(a.care) < std::popcount(b.care);
+  });
+  std::vector<Cube> kept;
+  for (const auto &cube : cubes) {
+    if (std::ranges::none_of(
+            kept, [&](Cube other) { return cubeContains(other, cube); })) {
+      kept.push_back(cube);
+    }
+  }
+  cubes.swap(kept);
+}
+
+// Quine-McCluskey: merge cubes of one level into the next by looking up, for
+// every cared variable, the cube that differs only there
+std::vector<Cube> findPrimeImplicants(const std::vector<std::uint64_t> &allowed,
+                                      std::size_t numVariables) {
+  const std::uint32_t allVariables =
+      static_cast<std::uint32_t>((std::uint64_t{1} << numVariables) - 1);
+  std::vector<Cube> current;
+  for (std::uint32_t minterm = 0; minterm < (std::uint64_t{1} << numVariables);
+       minterm++) {
+    if (getMinterm(allowed, minterm)) {
+      current.push_back({minterm, allVariables});
+    }
+  }
+
+  std::vector<Cube> primes;
+  std::unordered_set<std::uint64_t> present;
+  std::unordered_set<std::uint64_t> generated;
+  while (not current.empty()) {
+    present.clear();
+    generated.clear();
+    for (const auto &cube : current) {
+      present.insert(cubeKey(cube));
+    }
+
+    std::vector<Cube> next;
+    for (const auto &cube : current) {
+      bool merged = false;
+      for (std::uint32_t care = cube.care; care != 0; care &= care - 1) {
+        std::uint32_t bit = care & (0 - care);
+        if (not present.contains(cubeKey({cube.value ^ bit, cube.care}))) {
+          continue;
+        }
+        merged = true;
+        Cube mergedCube{cube.value & ~bit, cube.care & ~bit};
+        if (generated.insert(cubeKey(mergedCube)).second) {
+          next.push_back(mergedCube);
+        }
+      }
+      if (not merged) {
+        primes.push_back(cube);
+      }
+    }
+    current.swap(next);
+  }
+
+  return primes;
+}
+
+// Branch and bound over the minterms not covered by essential primes,
+// seeded with a greedy cover and stopped after a fixed number of nodes
+struct CoverSearch {
+  static constexpr std::size_t maxNodes = 100000;
+
+  const std::vector<Cube> &primes;
+  std::vector<std::vector<std::uint32_t>> coveringPrimes;
+  std::vector<std::vector<std::uint32_t>> coveredMinterms;
+  std::vector<std::uint32_t> chosen;
+  std::vector<std::uint32_t> best;
+  std::pair<std::size_t, std::size_t> bestCost{SIZE_MAX, SIZE_MAX};
+  std::size_t nodes = 0;
+
+  std::pair<std::size_t, std::size_t>
+  cost(const std::vector<std::uint32_t> &selection) const {
+    std::size_t literals = 0;
+    for (auto prime : selection) {
+      literals += std::popcount(primes[prime].care);
+    }
+    return {selection.size(), literals};
+  }
+
+  void greedy() {
+    std::vector<std::uint32_t> selection = chosen;
+    std::vector<bool> covered(coveringPrimes.size());
+    for (auto prime : selection) {
+      for (auto minterm : coveredMinterms[prime]) {
+        covered[minterm] = true;
+      }
+    }
+    while (std::ranges::find(covered, false) != covered.end()) {
+      std::uint32_t bestPrime = 0;
+      std::size_t bestGain = 0;
+      for (std::uint32_t prime = 0; prime < primes.size(); prime++) {
+        std::size_t gain = 0;
+        for (auto minterm : coveredMinterms[prime]) {
+          gain += not covered[minterm];
+        }
+        if (gain > bestGain or
+            (gain == bestGain and gain > 0 and
+             std::popcount(primes[prime].care) <
+                 std::popcount(primes[bestPrime].care))) {
+          bestGain = gain;
+          bestPrime = prime;
+        }
+      }
+      selection.push_back(bestPrime);
+      for (auto minterm : coveredMinterms[bestPrime]) {
+        covered[minterm] = true;
+      }
+    }
+    best = selection;
+    bestCost = cost(selection);
+  }
+
+  void search(std::vector<std::uint32_t> &coverCount) {
+    if (++nodes > maxNodes) {
+      return;
+    }
+    auto current = cost(chosen);
+    if (current.first + 1 > bestCost.first and
+        std::ranges::find(coverCount, 0u) != coverCount.end()) {
+      return;
+    }
+
+    // Branch on the uncovered minterm with the fewest covering primes
+    std::size_t pivot = SIZE_MAX;
+    for (std::size_t minterm = 0; minterm < coverCount.size(); minterm++) {
+      if (coverCount[minterm] == 0 and
+          (pivot == SIZE_MAX or coveringPrimes[minterm].size() <
+                                    coveringPrimes[pivot].size())) {
+        pivot = minterm;
+      }
+    }
+    if (pivot == SIZE_MAX) {
+      if (current < bestCost) {
+        bestCost = current;
+        best = chosen;
+      }
+      return;
+    }
+
+    for (auto prime : coveringPrimes[pivot]) {
+      chosen.push_back(prime);
+      for (auto minterm : coveredMinterms[prime]) {
+        coverCount[minterm]++;
+      }
+      search(coverCount);
+      for (auto minterm : coveredMinterms[prime]) {
+        coverCount[minterm]--;
+      }
+      chosen.pop_back();
+    }
+  }
+};
+
+std::vector<Cube> quineMcCluskey(const std::vector<std::uint64_t> &onSet,
+                                 const std::vector<std::uint64_t> &allowed,
+                                 std::size_t numVariables) {
+  std::vector<Cube> primes = findPrimeImplicants(allowed, numVariables);
+
+  std::vector<std::uint32_t> onMinterms;
+  for (std::uint32_t minterm = 0; minterm < (std::uint64_t{1} << numVariables);
+       minterm++) {
+    if (getMinterm(onSet, minterm)) {
+      onMinterms.push_back(minterm);
+    }
+  }
+
+  CoverSearch coverSearch{primes};
+  coverSearch.coveringPrimes.resize(onMinterms.size());
+  coverSearch.coveredMinterms.resize(primes.size());
+  for (std::uint32_t i = 0; i < onMinterms.size(); i++) {
+    for (std::uint32_t prime = 0; prime < primes.size(); prime++) {
+      if (cubeContains(primes[prime],
+                       {onMinterms[i], static_cast<std::uint32_t>(
+                                           (std::uint64_t{1} << numVariables) -
+                                           1)})) {
+        coverSearch.coveringPrimes[i].push_back(prime);
+        coverSearch.coveredMinterms[prime].push_back(i);
+      }
+    }
+  }
+
+  // Essential primes are the only cover of some minterm
+  std::vector<std::uint32_t> coverCount(onMinterms.size());
+  for (const auto &covering : coverSearch.coveringPrimes) {
+    if (covering.size() == 1 and
+        std::ranges::find(coverSearch.chosen, covering[0]) ==
+            coverSearch.chosen.end()) {
+      coverSearch.chosen.push_back(covering[0]);
+      for (auto minterm : coverSearch.coveredMinterms[covering[0]]) {
+        coverCount[minterm]++;
+      }
+    }
+  }
+
+  coverSearch.greedy();
+  coverSearch.search(coverCount);
+
+  std::vector<Cube> result;
+  for (auto prime : coverSearch.best) {
+    result.push_back(primes[prime]);
+  }
+  return result;
+}
+
+// Espresso-style heuristic on an explicit truth table: EXPAND every
+// uncovered minterm into a prime, drop redundant cubes, then alternate
+// REDUCE and EXPAND while the cover keeps getting cheaper.
+struct EspressoMinimizer {
+  static constexpr std::size_t maxIterations = 4;
+
+  const std::vector<std::uint64_t> &onSet;
+  const std::vector<std::uint64_t> &allowed;
+  std::size_t numVariables;
+  std::vector<std::uint32_t> coverCount;
+
+  Cube expand(Cube cube, bool reverseOrder) const {
+    for (std::size_t i = 0; i < numVariables; i++) {
+      std::uint32_t bit = std::uint32_t{1}
+                          << (reverseOrder ? numVariables - 1 - i : i);
+      if (not(cube.care & bit)) {
+        continue;
+      }
+      Cube raised{cube.value & ~bit, cube.care & ~bit};
+      if (isCubeInside(raised, allowed, numVariables)) {
+        cube = raised;
+      }
+    }
+    return cube;
+  }
+
+  void count(Cube cube, int delta) {
+    forEachMinterm(cube, numVariables, [&](std::uint32_t minterm) {
+      if (getMinterm(onSet, minterm)) {
+        coverCount[minterm] += delta;
+      }
+    });
+  }
+
+  void recount(const std::vector<Cube> &cubes) {
+    std::ranges::fill(coverCount, 0);
+    for (const auto &cube : cubes) {
+      count(cube, 1);
+    }
+  }
+
+  void irredundant(std::vector<Cube> &cubes) {
+    std::ranges::sort(cubes, [](Cube a, Cube b) {
+      return std::popcount(a.care) > std::popcount(b.care);
+    });
+    std::vector<Cube> kept;
+    for (const auto &cube : cubes) {
+      bool redundant = true;
+      forEachMinterm(cube, numVariables, [&](std::uint32_t minterm) {
+        redundant = redundant and (not getMinterm(onSet, minterm) or
+                                   coverCount[minterm] >= 2);
+      });
+      if (redundant) {
+        count(cube, -1);
+      } else {
+        kept.push_back(cube);
+      }
+    }
+    cubes.swap(kept);
+  }
+
+  // Shrinks a counted cube to the supercube of the minterms only it covers
+  std::optional<Cube> reduce(Cube cube) {
+    std::optional<std::uint32_t> first;
+    std::uint32_t differing = 0;
+    forEachMinterm(cube, numVariables, [&](std::uint32_t minterm) {
+      if (getMinterm(onSet, minterm) and coverCount[minterm] == 1) {
+        if (not first) {
+          first = minterm;
+        }
+        differing |= minterm ^ *first;
+      }
+    });
+    if (not first) {
+      return std::nullopt;
+    }
+
+    std::uint32_t care =
+        ~differing &
+        static_cast<std::uint32_t>((std::uint64_t{1} << numVariables) - 1);
+    return Cube{*first & care, care};
+  }
+
+  std::vector<Cube> minimize() {
+    coverCount.assign(std::size_t{1} << numVariables, 0);
+    std::vector<Cube> cubes;
+    for (std::uint32_t minterm = 0;
+         minterm < (std::uint64_t{1} << numVariables); minterm++) {
+      if (getMinterm(onSet, minterm) and coverCount[minterm] == 0) {
+        Cube cube = expand(
+            {minterm, static_cast<std::uint32_t>(
+                          (std::uint64_t{1} << numVariables) - 1)},
+            false);
+        cubes.push_back(cube);
+        count(cube, 1);
+      }
+    }
+    irredundant(cubes);
+
+    std::vector<Cube> best = cubes;
+    for (std::size_t iteration = 0; iteration < maxIterations; iteration++) {
+      std::vector<Cube> next;
+      for (const auto &cube : cubes) {
+        auto reduced = reduce(cube);
+        count(cube, -1);
+        if (reduced) {
+          Cube expanded = expand(*reduced, iteration % 2 == 0);
+          next.push_back(expanded);
+          count(expanded, 1);
+        }
+      }
+      // Expansion may have made some cubes contain others
+      removeContainedCubes(next);
+      recount(next);
+      irredundant(next);
+
+      cubes = next;
+      if (coverCost(cubes) < coverCost(best)) {
+        best = cubes;
+      } else {
+        break;
+      }
+    }
+
+    return best;
+  }
+};
+
+// Two-input NAND netlist builder with structural hashing. Signals are
+// indices: 0 is the constant high of an unused input, 1..numInputs the input
+// pins and the rest gate outputs in creation order.
+struct NANDNetlistBuilder {
+  static constexpr std::size_t one = 0;
+
+  std::size_t numInputs;
+  std::vector<std::pair<std::size_t, std::size_t>> gates;
+  std::map<std::pair<std::size_t, std::size_t>, std::size_t> existing;
+
+  std::size_t input(std::size_t index) const { return 1 + index; }
+
+  std::size_t nand(std::size_t a, std::size_t b) {
+    auto key = std::minmax(a, b);
+    // NOT(NOT x) is x
+    if (key.first == one and key.second > numInputs) {
+      auto [inner, innerOther] = gates[key.second - numInputs - 1];
+      if (inner == innerOther or inner == one) {
+        return innerOther;
+      }
+    }
+    if (auto it = existing.find(key); it != existing.end()) {
+      return it->second;
+    }
+    gates.push_back(key);
+    std::size_t signal = numInputs + gates.size();
+    existing.emplace(key, signal);
+    return signal;
+  }
+
+  std::size_t negate(std::size_t a) { return nand(one, a); }
+  std::size_t conjunction(std::size_t a, std::size_t b) {
+    return negate(nand(a, b));
+  }
+};
+} // namespace
+
+std::size_t SumOfProducts::numLiterals() const {
+  return coverCost(cubes).second;
+}
+
+bool SumOfProducts::evaluate(std::uint64_t variablesValue) const {
+  return std::ranges::any_of(cubes, [&](Cube cube) {
+    return ((variablesValue ^ cube.value) & cube.care) == 0;
+  });
+}
+
+std::ostream &operator<<(std::ostream &os, const SumOfProducts &sumOfProducts) {
+  if (sumOfProducts.cubes.empty()) {
+    return os << "0";
+  }
+
+  for (std::size_t i = 0; i < sumOfProducts.cubes.size(); i++) {
+    const auto &cube = sumOfProducts.cubes[i];
+    os << (i ? " OR " : "");
+    if (cube.care == 0) {
+      os << "1";
+      continue;
+    }
+    bool first = true;
+    for (std::size_t v = 0; v < sumOfProducts.variables.size(); v++) {
+      if ((cube.care >> v) & 1) {
+        os << (first ? "" : " AND ") << (((cube.value >> v) & 1) ? "" : "NOT ")
+           << sumOfProducts.variables[v];
+        first = false;
+      }
+    }
+  }
+
+  return os;
+}
+
+std::optional<std::vector<Cube>>
+minimizeTruthTable(const std::vector<std::uint64_t> &onSet,
+                   const std::vector<std::uint64_t> &dontCares,
+                   std::size_t numVariables, MinimizationMethod method) {
+  if (numVariables > maxMinimizationVariables) {
+    std::print("Error: too many variables ({}) to minimize.", numVariables);
+    return std::nullopt;
+  }
+
+  std::vector<std::uint64_t> allowed = onSet;
+  for (std::size_t word = 0; word < std::min(allowed.size(), dontCares.size());
+       word++) {
+    allowed[word] |= dontCares[word];
+  }
+
+  if (method == MinimizationMethod::QuineMcCluskey or
+      (method == MinimizationMethod::Automatic and
+       numVariables <= maxQuineMcCluskeyVariables)) {
+    return quineMcCluskey(onSet, allowed, numVariables);
+  }
+
+  return EspressoMinimizer{onSet, allowed, numVariables}.minimize();
+}
+
+std::optional<SumOfProducts>
+minimizeBooleanExpression(const CompiledBooleanExpression &compiledExpression,
+                          MinimizationMethod method) {
+  auto truthTableOpt = computeTruthTable(compiledExpression);
+  if (not truthTableOpt) {
+    return std::nullopt;
+  }
+
+  auto cubesOpt = minimizeTruthTable(*truthTableOpt, {},
+                                     compiledExpression.variables.size(),
+                                     method);
+  if (not cubesOpt) {
+    return std::nullopt;
+  }
+
+  return SumOfProducts{compiledExpression.variables, std::move(*cubesOpt)};
+}
+
+NANDGateArrayNetlist mapToNANDGateArray(const SumOfProducts &sumOfProducts,
+                                        std::size_t numCols) {
+  const std::size_t numInputs = sumOfProducts.variables.size();
+  NANDNetlistBuilder builder{numInputs};
+
+  // Constant true needs no gate: an unconnected output pin reads high
+  std::optional<std::size_t> output;
+  if (sumOfProducts.cubes.empty()) {
+    output = builder.nand(NANDNetlistBuilder::one, NANDNetlistBuilder::one);
+  } else if (std::ranges::none_of(sumOfProducts.cubes,
+                                  [](Cube cube) { return cube.care == 0; })) {
+    // F = OR(P_i) = NAND(NOT P_1, ..., NOT P_m), built as a chain of ANDs
+    // over the complemented products
+    std::optional<std::size_t> productsComplementAnd;
+    for (const auto &cube : sumOfProducts.cubes) {
+      std::vector<std::size_t> literals;
+      for (std::size_t v = 0; v < numInputs; v++) {
+        if ((cube.care >> v) & 1) {
+          literals.push_back(((cube.value >> v) & 1)
+                                 ? builder.input(v)
+                                 : builder.negate(builder.input(v)));
+        }
+      }
+
+      std::size_t product = literals[0];
+      for (std::size_t i = 1; i + 1 < literals.size(); i++) {
+        product = builder.conjunction(product, literals[i]);
+      }
+      std::size_t productComplement =
+          literals.size() == 1 ? builder.negate(product)
+                               : builder.nand(product, literals.back());
+
+      productsComplementAnd =
+          productsComplementAnd
+              ? builder.conjunction(*productsComplementAnd, productComplement)
+              : productComplement;
+    }
+    output = builder.negate(*productsComplementAnd);
+  }
+
+  NANDGateArrayNetlist netlist;
+  netlist.numInputs = numInputs;
+  netlist.numGates = builder.gates.size();
+  netlist.numCols = std::max<std::size_t>(1, std::min(numCols, netlist.numGates));
+  netlist.numRows =
+      std::max<std::size_t>(1, (netlist.numGates + netlist.numCols - 1) /
+                                   netlist.numCols);
+
+  auto gatePos = [&](std::size_t gate) {
+    return GatePos{gate / netlist.numCols, gate % netlist.numCols};
+  };
+  auto source = [&](std::size_t signal) -> std::optional<SignalSource> {
+    if (signal == NANDNetlistBuilder::one) {
+      return std::nullopt;
+    }
+    if (signal <= numInputs) {
+      return SignalSource{SignalSourceType::InputPin, InputPin{signal - 1}};
+    }
+    return SignalSource{SignalSourceType::GateOutput,
+                        GateOutput{gatePos(signal - numInputs - 1)}};
+  };
+
+  for (std::size_t gate = 0; gate < builder.gates.size(); gate++) {
+    auto [a, b] = builder.gates[gate];
+    for (auto [signal, name] :
+         {std::pair{a, GateInputName::InputA}, std::pair{b, GateInputName::InputB}}) {
+      if (auto signalSource = source(signal)) {
+        netlist.wireConnections.push_back(
+            {*signalSource,
+             {SignalDestinationType::GateInput, GateInput{gatePos(gate), name}}});
+      }
+    }
+  }
+
+  if (output) {
+    if (auto signalSource = source(*output)) {
+      netlist.wireConnections.push_back(
+          {*signalSource, {SignalDestinationType::OutputPin, OutputPin{0}}});
+    }
+  }
+
+  return netlist;
+}
+} // namespace SCO
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "chapter3_problem46.hpp"
+#include "chapter3_problem47.hpp"
+
+namespace SCO {
+// Product term over up to 32 variables: variable i appears when bit i of
+// care is set, complemented when bit i of value is clear.
+struct Cube {
+  std::uint32_t value = 0;
+  std::uint32_t care = 0;
+
+  bool operator==(const Cube &) const = default;
+};
+
+struct SumOfProducts {
+  std::vector<std::string> variables;
+  // No cubes is constant false, a cube without literals constant true
+  std::vector<Cube> cubes;
+
+  std::size_t numLiterals() const;
+  bool evaluate(std::uint64_t variablesValue) const;
+};
+
+std::ostream &operator<<(std::ostream &os, const SumOfProducts &sumOfProducts);
+
+enum class MinimizationMethod {
+  // Quine-McCluskey up to maxQuineMcCluskeyVariables, Espresso otherwise
+  Automatic = 0,
+  QuineMcCluskey,
+  Espresso,
+};
+
+inline constexpr std::size_t maxQuineMcCluskeyVariables = 10;
+inline constexpr std::size_t maxMinimizationVariables = 20;
+
+// Truth tables are packed like computeTruthTable's. dontCares may be empty.
+std::optional<std::vector<Cube>>
+minimizeTruthTable(const std::vector<std::uint64_t> &onSet,
+                   const std::vector<std::uint64_t> &dontCares,
+                   std::size_t numVariables,
+                   MinimizationMethod method = MinimizationMethod::Automatic);
+std::optional<SumOfProducts>
+minimizeBooleanExpression(const CompiledBooleanExpression &compiledExpression,
+                          MinimizationMethod method = MinimizationMethod::Automatic);
+
+// Arguments for simulateGateArray. Input pin i is variables[i] and output
+// pin 0 the function.
+struct NANDGateArrayNetlist {
+  std::size_t numRows = 0;
+  std::size_t numCols = 0;
+  std::size_t numInputs = 0;
+  std::size_t numOutputs = 1;
+  std::size_t numGates = 0;
+  std::vector<WireConnection> wireConnections;
+};
+
+// Maps a sum of products onto two-input NAND gates, sharing inverters and
+// identical gates. Gates are placed row by row in topological order.
+NANDGateArrayNetlist mapToNANDGateArray(const SumOfProducts &sumOfProducts,
+                                        std::size_t numCols = 8);
+} // namespace SCO
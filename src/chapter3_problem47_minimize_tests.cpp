@@ -0,0 +1,185 @@
+#include <chrono>
+#include <print>
+#include <random>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "chapter3_problem47_minimize.hpp"
+
+namespace SCO {
+namespace {
+std::vector<std::uint64_t> randomTruthTable(std::mt19937_64 &generator,
+                                            std::size_t numVariables) {
+  std::vector<std::uint64_t> truthTable(
+      numVariables <= 6 ? 1 : std::size_t{1} << (numVariables - 6));
+  for (auto &word : truthTable) {
+    // Sparser functions minimize into something more interesting than one
+    // cube per pair of minterms
+    word = generator() & generator();
+  }
+  if (numVariables < 6) {
+    truthTable[0] &= (std::uint64_t{1} << (std::size_t{1} << numVariables)) - 1;
+  }
+  return truthTable;
+}
+
+bool coversExactly(const SumOfProducts &sumOfProducts,
+                   const std::vector<std::uint64_t> &truthTable) {
+  for (std::uint64_t minterm = 0;
+       minterm < (std::uint64_t{1} << sumOfProducts.variables.size());
+       minterm++) {
+    if (sumOfProducts.evaluate(minterm) !=
+        bool((truthTable[minterm / 64] >> (minterm % 64)) & 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+SumOfProducts withVariables(std::size_t numVariables, std::vector<Cube> cubes) {
+  SumOfProducts sumOfProducts{{}, std::move(cubes)};
+  for (std::size_t v = 0; v < numVariables; v++) {
+    sumOfProducts.variables.push_back("x" + std::to_string(v));
+  }
+  return sumOfProducts;
+}
+} // namespace
+
+TEST(MinimizeTest, AbsorbsRedundantTerms) {
+  auto compiledExpressionOpt = compileBooleanExpression(
+      "(A AND B) OR (A AND NOT B) OR (A AND B AND C)");
+  ASSERT_TRUE(compiledExpressionOpt.has_value());
+
+  for (auto method :
+       {MinimizationMethod::QuineMcCluskey, MinimizationMethod::Espresso}) {
+    auto sumOfProductsOpt =
+        minimizeBooleanExpression(*compiledExpressionOpt, method);
+    ASSERT_TRUE(sumOfProductsOpt.has_value());
+    std::ostringstream os;
+    os << *sumOfProductsOpt;
+    EXPECT_EQ(os.str(), "A");
+  }
+}
+
+TEST(MinimizeTest, DontCaresEnlargeCubes) {
+  // Classic example: f = m(4, 8, 10, 11, 12, 15) + d(9, 14) has the
+  // minimum cover x3 NOT x0 OR x3 x1 OR x2 NOT x1 NOT x0
+  std::vector<std::uint64_t> onSet = {(1 << 4) | (1 << 8) | (1 << 10) |
+                                      (1 << 11) | (1 << 12) | (1 << 15)};
+  std::vector<std::uint64_t> dontCares = {(1 << 9) | (1 << 14)};
+
+  auto cubesOpt = minimizeTruthTable(onSet, dontCares, 4,
+                                     MinimizationMethod::QuineMcCluskey);
+  ASSERT_TRUE(cubesOpt.has_value());
+  auto sumOfProducts = withVariables(4, *cubesOpt);
+  EXPECT_EQ(sumOfProducts.cubes.size(), 3);
+  EXPECT_EQ(sumOfProducts.numLiterals(), 7);
+  for (std::uint64_t minterm : {4, 8, 10, 11, 12, 15}) {
+    EXPECT_TRUE(sumOfProducts.evaluate(minterm));
+  }
+  for (std::uint64_t minterm : {0, 1, 2, 3, 5, 6, 7, 13}) {
+    EXPECT_FALSE(sumOfProducts.evaluate(minterm));
+  }
+}
+
+TEST(MinimizeTest, RandomFunctionsAreCoveredExactly) {
+  std::mt19937_64 generator(34);
+  for (std::size_t numVariables = 0; numVariables <= 9; numVariables++) {
+    for (int sample = 0; sample < 5; sample++) {
+      auto truthTable = randomTruthTable(generator, numVariables);
+      for (auto method :
+           {MinimizationMethod::QuineMcCluskey, MinimizationMethod::Espresso}) {
+        auto cubesOpt = minimizeTruthTable(truthTable, {}, numVariables, method);
+        ASSERT_TRUE(cubesOpt.has_value());
+        EXPECT_TRUE(
+            coversExactly(withVariables(numVariables, *cubesOpt), truthTable))
+            << numVariables << " variables, sample " << sample;
+      }
+    }
+  }
+}
+
+TEST(MinimizeTest, MappedNetlistSimulatesToSameFunction) {
+  for (const char *expression :
+       {"NOT (A AND B) OR C AND NOT D", "A AND NOT A", "A OR NOT A",
+        "(A AND B) OR (B AND C) OR (A AND C)", "NOT A"}) {
+    auto compiledExpressionOpt = compileBooleanExpression(expression);
+    ASSERT_TRUE(compiledExpressionOpt.has_value());
+    auto sumOfProductsOpt = minimizeBooleanExpression(*compiledExpressionOpt);
+    ASSERT_TRUE(sumOfProductsOpt.has_value());
+
+    auto netlist = mapToNANDGateArray(*sumOfProductsOpt, 4);
+    auto results = simulateGateArray(netlist.numRows, netlist.numCols,
+                                     netlist.numInputs, netlist.numOutputs,
+                                     netlist.wireConnections);
+    ASSERT_EQ(results.size(),
+              std::size_t{1} << compiledExpressionOpt->variables.size());
+    for (std::uint64_t i = 0; i < results.size(); i++) {
+      EXPECT_FALSE(results[i].oscillation.has_value());
+      EXPECT_EQ(results[i].outputs[0],
+                evaluateCompiledBooleanExpression(*compiledExpressionOpt, i))
+          << "'" << expression << "' at combination " << i;
+    }
+  }
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(MinimizeTest, DISABLED_Benchmark) {
+  std::mt19937_64 generator(2024);
+  std::print("{:>9} {:>14} {:>10} {:>10} {:>12} {:>12} {:>10}\n", "variables",
+             "method", "cubes", "literals", "gates", "naive gates", "ms");
+  for (std::size_t numVariables : {4, 6, 8, 10, 12, 14}) {
+    std::vector<std::vector<std::uint64_t>> corpus;
+    for (int sample = 0; sample < 20; sample++) {
+      corpus.push_back(randomTruthTable(generator, numVariables));
+    }
+
+    // One full-width cube per minterm, the same for both methods
+    std::size_t naiveGates = 0;
+    for (const auto &truthTable : corpus) {
+      SumOfProducts minterms = withVariables(numVariables, {});
+      for (std::uint32_t m = 0; m < (1u << numVariables); m++) {
+        if ((truthTable[m / 64] >> (m % 64)) & 1) {
+          minterms.cubes.push_back({m, (1u << numVariables) - 1});
+        }
+      }
+      naiveGates += mapToNANDGateArray(minterms).numGates;
+    }
+
+    for (auto method :
+         {MinimizationMethod::QuineMcCluskey, MinimizationMethod::Espresso}) {
+      if (method == MinimizationMethod::QuineMcCluskey and numVariables > 10) {
+        continue;
+      }
+
+      std::size_t cubes = 0;
+      std::size_t literals = 0;
+      std::size_t gates = 0;
+      // Only the minimization is timed, not the NAND mapping of its result
+      double elapsed = 0;
+      for (const auto &truthTable : corpus) {
+        auto start = std::chrono::steady_clock::now();
+        auto cubesOpt =
+            minimizeTruthTable(truthTable, {}, numVariables, method);
+        elapsed += std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+        ASSERT_TRUE(cubesOpt.has_value());
+        auto sumOfProducts = withVariables(numVariables, *cubesOpt);
+        cubes += sumOfProducts.cubes.size();
+        literals += sumOfProducts.numLiterals();
+        gates += mapToNANDGateArray(sumOfProducts).numGates;
+      }
+
+      std::print("{:>9} {:>14} {:>10.1f} {:>10.1f} {:>12.1f} {:>12.1f} "
+                 "{:>10.2f}\n",
+                 numVariables,
+                 method == MinimizationMethod::QuineMcCluskey ? "QM"
+                                                              : "Espresso",
+                 cubes / 20.0, literals / 20.0, gates / 20.0,
+                 naiveGates / 20.0, elapsed / 20.0);
+    }
+  }
+}
+} // namespace SCO
@@ -0,0 +1,418 @@
+#include "chapter3_problem47_sat.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+namespace SCO {
+namespace {
+// Luby restart sequence 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+std::size_t luby(std::size_t index) {
+  std::size_t size = 1;
+  std::size_t sequence = 0;
+  while (size < index + 1) {
+    sequence++;
+    size = 2 * size + 1;
+  }
+  while (size - 1 != index) {
+    size = (size - 1) >> 1;
+    sequence--;
+    index = index % size;
+  }
+  return std::size_t{1} << sequence;
+}
+} // namespace
+
+std::uint32_t SATSolver::newVariable() {
+  auto variable = static_cast<std::uint32_t>(assignment.size());
+  assignment.push_back(valueUnassigned);
+  levels.push_back(0);
+  reasons.push_back(noReason);
+  polarity.push_back(false);
+  activity.push_back(0.0);
+  seen.push_back(false);
+  heapIndex.push_back(noReason);
+  watches.resize(2 * assignment.size());
+  heapInsert(variable);
+  return variable;
+}
+
+std::uint8_t SATSolver::literalValue(SATLiteral literal) const {
+  std::uint8_t value = assignment[getSATVariable(literal)];
+  return value == valueUnassigned ? value : value ^ (literal & 1);
+}
+
+void SATSolver::enqueue(SATLiteral literal, std::uint32_t reason) {
+  std::uint32_t variable = getSATVariable(literal);
+  assignment[variable] = (literal & 1) ? valueFalse : valueTrue;
+  levels[variable] = static_cast<std::uint32_t>(decisionLevel());
+  reasons[variable] = reason;
+  trail.push_back(literal);
+}
+
+bool SATSolver::addClause(std::vector<SATLiteral> clause) {
+  if (unsatisfiable) {
+    return false;
+  }
+  backtrack(0);
+
+  // Drop duplicates and literals already false, skip satisfied clauses and
+  // tautologies
+  std::ranges::sort(clause);
+  clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < clause.size(); i++) {
+    SATLiteral literal = clause[i];
+    if (literalValue(literal) == valueTrue or
+        (i + 1 < clause.size() and
+         clause[i + 1] == negateSATLiteral(literal))) {
+      return true;
+    }
+    if (literalValue(literal) != valueFalse) {
+      clause[kept++] = literal;
+    }
+  }
+  clause.resize(kept);
+
+  if (clause.empty()) {
+    unsatisfiable = true;
+    return false;
+  }
+
+  if (clause.size() == 1) {
+    enqueue(clause[0], noReason);
+    if (propagate() != noReason) {
+      unsatisfiable = true;
+      return false;
+    }
+    return true;
+  }
+
+  auto index = static_cast<std::uint32_t>(clauses.size());
+  watches[clause[0]].push_back(index);
+  watches[clause[1]].push_back(index);
+  clauses.push_back(std::move(clause));
+  return true;
+}
+
+std::uint32_t SATSolver::propagate() {
+  while (propagationHead < trail.size()) {
+    SATLiteral falseLiteral = negateSATLiteral(trail[propagationHead++]);
+    auto &watchList = watches[falseLiteral];
+    statistics.propagations++;
+
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < watchList.size()) {
+      std::uint32_t clauseIndex = watchList[i++];
+      auto &clause = clauses[clauseIndex];
+      if (clause[0] == falseLiteral) {
+        std::swap(clause[0], clause[1]);
+      }
+
+      if (literalValue(clause[0]) == valueTrue) {
+        watchList[j++] = clauseIndex;
+        continue;
+      }
+
+      // Look for a replacement watch
+      bool foundWatch = false;
+      for (std::size_t k = 2; k < clause.size(); k++) {
+        if (literalValue(clause[k]) != valueFalse) {
+          std::swap(clause[1], clause[k]);
+          watches[clause[1]].push_back(clauseIndex);
+          foundWatch = true;
+          break;
+        }
+      }
+      if (foundWatch) {
+        continue;
+      }
+
+      watchList[j++] = clauseIndex;
+      if (literalValue(clause[0]) == valueFalse) {
+        while (i < watchList.size()) {
+          watchList[j++] = watchList[i++];
+        }
+        watchList.resize(j);
+        propagationHead = trail.size();
+        return clauseIndex;
+      }
+      enqueue(clause[0], clauseIndex);
+    }
+    watchList.resize(j);
+  }
+
+  return noReason;
+}
+
+// First unique implication point learning. The asserting literal is placed
+// first and a literal of the backtrack level second, ready to be watched.
+std::vector<SATLiteral> SATSolver::analyze(std::uint32_t conflict,
+                                           std::size_t &backtrackLevel) {
+  std::vector<SATLiteral> learnt(1);
+  std::size_t pathCount = 0;
+  std::size_t trailIndex = trail.size();
+  bool first = true;
+  SATLiteral literal = 0;
+
+  do {
+    const auto &clause = clauses[conflict];
+    for (std::size_t k = first ? 0 : 1; k < clause.size(); k++) {
+      std::uint32_t variable = getSATVariable(clause[k]);
+      if (seen[variable] or levels[variable] == 0) {
+        continue;
+      }
+      seen[variable] = true;
+      bumpActivity(variable);
+      if (levels[variable] >= decisionLevel()) {
+        pathCount++;
+      } else {
+        learnt.push_back(clause[k]);
+      }
+    }
+    first = false;
+
+    while (not seen[getSATVariable(trail[--trailIndex])]) {
+    }
+    literal = trail[trailIndex];
+    conflict = reasons[getSATVariable(literal)];
+    seen[getSATVariable(literal)] = false;
+    pathCount--;
+  } while (pathCount > 0);
+  learnt[0] = negateSATLiteral(literal);
+
+  backtrackLevel = 0;
+  std::size_t maxPosition = 1;
+  for (std::size_t k = 1; k < learnt.size(); k++) {
+    std::uint32_t variable = getSATVariable(learnt[k]);
+    seen[variable] = false;
+    if (levels[variable] > backtrackLevel) {
+      backtrackLevel = levels[variable];
+      maxPosition = k;
+    }
+  }
+  if (learnt.size() > 1) {
+    std::swap(learnt[1], learnt[maxPosition]);
+  }
+
+  return learnt;
+}
+
+void SATSolver::backtrack(std::size_t level) {
+  if (decisionLevel() <= level) {
+    return;
+  }
+
+  for (std::size_t i = trail.size(); i > trailLimits[level]; i--) {
+    std::uint32_t variable = getSATVariable(trail[i - 1]);
+    polarity[variable] = assignment[variable] == valueTrue;
+    assignment[variable] = valueUnassigned;
+    reasons[variable] = noReason;
+    heapInsert(variable);
+  }
+  trail.resize(trailLimits[level]);
+  trailLimits.resize(level);
+  propagationHead = trail.size();
+}
+
+void SATSolver::bumpActivity(std::uint32_t variable) {
+  activity[variable] += activityIncrement;
+  if (activity[variable] > 1e100) {
+    for (double &value : activity) {
+      value *= 1e-100;
+    }
+    activityIncrement *= 1e-100;
+  }
+  if (heapIndex[variable] != noReason) {
+    heapSiftUp(heapIndex[variable]);
+  }
+}
+
+void SATSolver::heapInsert(std::uint32_t variable) {
+  if (heapIndex[variable] != noReason) {
+    return;
+  }
+  heapIndex[variable] = static_cast<std::uint32_t>(heap.size());
+  heap.push_back(variable);
+  heapSiftUp(heap.size() - 1);
+}
+
+void SATSolver::heapSiftUp(std::size_t position) {
+  std::uint32_t variable = heap[position];
+  while (position > 0) {
+    std::size_t parent = (position - 1) / 2;
+    if (activity[heap[parent]] >= activity[variable]) {
+      break;
+    }
+    heap[position] = heap[parent];
+    heapIndex[heap[position]] = static_cast<std::uint32_t>(position);
+    position = parent;
+  }
+  heap[position] = variable;
+  heapIndex[variable] = static_cast<std::uint32_t>(position);
+}
+
+void SATSolver::heapSiftDown(std::size_t position) {
+  std::uint32_t variable = heap[position];
+  while (true) {
+    std::size_t child = 2 * position + 1;
+    if (child >= heap.size()) {
+      break;
+    }
+    if (child + 1 < heap.size() and
+        activity[heap[child + 1]] > activity[heap[child]]) {
+      child++;
+    }
+    if (activity[heap[child]] <= activity[variable]) {
+      break;
+    }
+    heap[position] = heap[child];
+    heapIndex[heap[position]] = static_cast<std::uint32_t>(position);
+    position = child;
+  }
+  heap[position] = variable;
+  heapIndex[variable] = static_cast<std::uint32_t>(position);
+}
+
+std::optional<std::uint32_t> SATSolver::heapPopMax() {
+  if (heap.empty()) {
+    return std::nullopt;
+  }
+  std::uint32_t top = heap[0];
+  heapIndex[top] = noReason;
+  heap[0] = heap.back();
+  heap.pop_back();
+  if (not heap.empty()) {
+    heapIndex[heap[0]] = 0;
+    heapSiftDown(0);
+  }
+  return top;
+}
+
+std::optional<std::vector<bool>> SATSolver::solve() {
+  if (unsatisfiable or propagate() != noReason) {
+    unsatisfiable = true;
+    return std::nullopt;
+  }
+
+  std::size_t restartNumber = 0;
+  std::size_t conflictsUntilRestart = restartInterval * luby(restartNumber);
+  while (true) {
+    std::uint32_t conflict = propagate();
+    if (conflict != noReason) {
+      statistics.conflicts++;
+      if (decisionLevel() == 0) {
+        unsatisfiable = true;
+        return std::nullopt;
+      }
+
+      std::size_t backtrackLevel = 0;
+      auto learnt = analyze(conflict, backtrackLevel);
+      backtrack(backtrackLevel);
+      if (learnt.size() == 1) {
+        enqueue(learnt[0], noReason);
+      } else {
+        auto index = static_cast<std::uint32_t>(clauses.size());
+        watches[learnt[0]].push_back(index);
+        watches[learnt[1]].push_back(index);
+        SATLiteral assertingLiteral = learnt[0];
+        clauses.push_back(std::move(learnt));
+        enqueue(assertingLiteral, index);
+        statistics.learntClauses++;
+      }
+      activityIncrement /= 0.95;
+
+      if (--conflictsUntilRestart == 0) {
+        statistics.restarts++;
+        conflictsUntilRestart = restartInterval * luby(++restartNumber);
+        backtrack(0);
+      }
+      continue;
+    }
+
+    std::optional<std::uint32_t> decision;
+    while ((decision = heapPopMax()) and
+           assignment[*decision] != valueUnassigned) {
+    }
+    if (not decision) {
+      std::vector<bool> model(numVariables());
+      for (std::size_t variable = 0; variable < numVariables(); variable++) {
+        model[variable] = assignment[variable] == valueTrue;
+      }
+      backtrack(0);
+      return model;
+    }
+
+    statistics.decisions++;
+    trailLimits.push_back(trail.size());
+    enqueue(makeSATLiteral(*decision, not polarity[*decision]), noReason);
+  }
+}
+
+BooleanEquivalenceResult
+checkEquivalenceWithSAT(const CompiledBooleanExpression &compiledExpressionA,
+                        const CompiledBooleanExpression &compiledExpressionB) {
+  SATSolver solver;
+  std::unordered_map<std::string, std::uint32_t> inputVariables;
+
+  // Tseitin encoding: every AND/OR gets a fresh variable constrained to be
+  // equal to the gate, NOT just flips the literal
+  auto encode = [&](const CompiledBooleanExpression &compiledExpression) {
+    std::vector<SATLiteral> stack;
+    for (const auto &instruction : compiledExpression.code) {
+      switch (instruction.opcode) {
+      case BooleanOpcode::PushVariable: {
+        const auto &name = compiledExpression.variables[instruction.variable];
+        auto [it, inserted] = inputVariables.try_emplace(name, 0);
+        if (inserted) {
+          it->second = solver.newVariable();
+        }
+        stack.push_back(makeSATLiteral(it->second));
+        break;
+      }
+      case BooleanOpcode::Not:
+        stack.back() = negateSATLiteral(stack.back());
+        break;
+      case BooleanOpcode::And:
+      case BooleanOpcode::Or: {
+        SATLiteral b = stack.back();
+        stack.pop_back();
+        SATLiteral a = stack.back();
+        SATLiteral gate = makeSATLiteral(solver.newVariable());
+        if (instruction.opcode == BooleanOpcode::And) {
+          solver.addClause({negateSATLiteral(gate), a});
+          solver.addClause({negateSATLiteral(gate), b});
+          solver.addClause({gate, negateSATLiteral(a), negateSATLiteral(b)});
+        } else {
+          solver.addClause({gate, negateSATLiteral(a)});
+          solver.addClause({gate, negateSATLiteral(b)});
+          solver.addClause({negateSATLiteral(gate), a, b});
+        }
+        stack.back() = gate;
+        break;
+      }
+      }
+    }
+    return stack.back();
+  };
+
+  SATLiteral outputA = encode(compiledExpressionA);
+  SATLiteral outputB = encode(compiledExpressionB);
+
+  // Miter: the outputs differ
+  solver.addClause({outputA, outputB});
+  solver.addClause({negateSATLiteral(outputA), negateSATLiteral(outputB)});
+
+  BooleanEquivalenceResult result;
+  auto modelOpt = solver.solve();
+  result.equivalent = not modelOpt;
+  if (modelOpt) {
+    for (const auto &[name, variable] : inputVariables) {
+      result.counterexample[name] = (*modelOpt)[variable];
+    }
+  }
+
+  return result;
+}
+} // namespace SCO
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "chapter3_problem47.hpp"
+
+namespace SCO {
+// Literal of variable v is 2 * v, its negation 2 * v + 1
+using SATLiteral = std::uint32_t;
+
+constexpr SATLiteral makeSATLiteral(std::uint32_t variable,
+                                    bool negated = false) {
+  return 2 * variable + (negated ? 1 : 0);
+}
+
+constexpr SATLiteral negateSATLiteral(SATLiteral literal) {
+  return literal ^ 1;
+}
+
+constexpr std::uint32_t getSATVariable(SATLiteral literal) {
+  return literal >> 1;
+}
+
+struct SATStatistics {
+  std::size_t decisions = 0;
+  std::size_t propagations = 0;
+  std::size_t conflicts = 0;
+  std::size_t restarts = 0;
+  std::size_t learntClauses = 0;
+};
+
+// Conflict-driven clause learning solver with two watched literals per
+// clause, VSIDS decisions with phase saving and Luby restarts.
+struct SATSolver {
+  static constexpr std::uint32_t noReason = UINT32_MAX;
+  static constexpr std::uint8_t valueFalse = 0;
+  static constexpr std::uint8_t valueTrue = 1;
+  static constexpr std::uint8_t valueUnassigned = 2;
+  // Conflicts between restarts are this many times the Luby sequence
+  static constexpr std::size_t restartInterval = 64;
+
+  std::vector<std::vector<SATLiteral>> clauses;
+  // Indices of the clauses watching each literal
+  std::vector<std::vector<std::uint32_t>> watches;
+
+  // Per-variable state
+  std::vector<std::uint8_t> assignment;
+  std::vector<std::uint32_t> levels;
+  std::vector<std::uint32_t> reasons;
+  std::vector<bool> polarity;
+  std::vector<double> activity;
+  std::vector<bool> seen;
+
+  // Max-heap of variables ordered by activity
+  std::vector<std::uint32_t> heap;
+  std::vector<std::uint32_t> heapIndex;
+
+  std::vector<SATLiteral> trail;
+  std::vector<std::size_t> trailLimits;
+  std::size_t propagationHead = 0;
+  double activityIncrement = 1.0;
+  bool unsatisfiable = false;
+  SATStatistics statistics;
+
+  std::uint32_t newVariable();
+  std::size_t numVariables() const { return assignment.size(); }
+  // Returns false once the clause set is known to be unsatisfiable
+  bool addClause(std::vector<SATLiteral> clause);
+  // A model indexed by variable, or nullopt if unsatisfiable
+  std::optional<std::vector<bool>> solve();
+
+  std::uint8_t literalValue(SATLiteral literal) const;
+  std::size_t decisionLevel() const { return trailLimits.size(); }
+  void enqueue(SATLiteral literal, std::uint32_t reason);
+  std::uint32_t propagate();
+  std::vector<SATLiteral> analyze(std::uint32_t conflict,
+                                  std::size_t &backtrackLevel);
+  void backtrack(std::size_t level);
+  void bumpActivity(std::uint32_t variable);
+  void heapInsert(std::uint32_t variable);
+  void heapSiftUp(std::size_t position);
+  void heapSiftDown(std::size_t position);
+  std::optional<std::uint32_t> heapPopMax();
+};
+
+// Tseitin-encodes the miter (A XOR B) of two compiled expressions and
+// decides it with SATSolver
+BooleanEquivalenceResult
+checkEquivalenceWithSAT(const CompiledBooleanExpression &compiledExpressionA,
+                        const CompiledBooleanExpression &compiledExpressionB);
+} // namespace SCO
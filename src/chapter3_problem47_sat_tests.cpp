@@ -0,0 +1,130 @@
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "chapter3_problem47_sat.hpp"
+
+namespace SCO {
+namespace {
+bool satisfies(const std::vector<std::vector<SATLiteral>> &clauses,
+               const std::vector<bool> &model) {
+  for (const auto &clause : clauses) {
+    bool satisfied = false;
+    for (SATLiteral literal : clause) {
+      satisfied |= model[getSATVariable(literal)] != bool(literal & 1);
+    }
+    if (not satisfied) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+TEST(SATSolverTest, PigeonholeIsUnsatisfiable) {
+  // Three pigeons, two holes: variable 2 * p + h means pigeon p in hole h
+  SATSolver solver;
+  for (int i = 0; i < 6; i++) {
+    solver.newVariable();
+  }
+  for (std::uint32_t p = 0; p < 3; p++) {
+    solver.addClause({makeSATLiteral(2 * p), makeSATLiteral(2 * p + 1)});
+  }
+  for (std::uint32_t h = 0; h < 2; h++) {
+    for (std::uint32_t p = 0; p < 3; p++) {
+      for (std::uint32_t q = p + 1; q < 3; q++) {
+        solver.addClause({makeSATLiteral(2 * p + h, true),
+                          makeSATLiteral(2 * q + h, true)});
+      }
+    }
+  }
+  EXPECT_FALSE(solver.solve().has_value());
+}
+
+TEST(SATSolverTest, RandomThreeSATMatchesBruteForce) {
+  std::mt19937 generator(47);
+  constexpr std::uint32_t numVariables = 12;
+  for (int instance = 0; instance < 100; instance++) {
+    std::vector<std::vector<SATLiteral>> clauses(52);
+    for (auto &clause : clauses) {
+      for (int k = 0; k < 3; k++) {
+        clause.push_back(makeSATLiteral(generator() % numVariables,
+                                        generator() & 1));
+      }
+    }
+
+    bool bruteForceSatisfiable = false;
+    for (std::uint32_t mask = 0; mask < (1u << numVariables); mask++) {
+      std::vector<bool> model(numVariables);
+      for (std::uint32_t v = 0; v < numVariables; v++) {
+        model[v] = (mask >> v) & 1;
+      }
+      if (satisfies(clauses, model)) {
+        bruteForceSatisfiable = true;
+        break;
+      }
+    }
+
+    SATSolver solver;
+    for (std::uint32_t v = 0; v < numVariables; v++) {
+      solver.newVariable();
+    }
+    for (const auto &clause : clauses) {
+      solver.addClause(clause);
+    }
+    auto modelOpt = solver.solve();
+    ASSERT_EQ(modelOpt.has_value(), bruteForceSatisfiable)
+        << "Instance " << instance;
+    if (modelOpt) {
+      EXPECT_TRUE(satisfies(clauses, *modelOpt)) << "Instance " << instance;
+    }
+  }
+}
+
+TEST(SATSolverTest, EquivalenceCounterexample) {
+  std::string exprA = "NOT (A AND B) OR C";
+  std::string exprB = "A AND (B OR C)";
+
+  auto resultOpt =
+      checkBooleanEquivalence(exprA, exprB, EquivalenceCheckMethod::SAT);
+  ASSERT_TRUE(resultOpt.has_value());
+  EXPECT_FALSE(resultOpt->equivalent);
+  ASSERT_EQ(resultOpt->counterexample.size(), 3);
+
+  auto parsedAOpt = parseBooleanExpression(exprA);
+  auto parsedBOpt = parseBooleanExpression(exprB);
+  ASSERT_TRUE(parsedAOpt and parsedBOpt);
+  EXPECT_NE(solveBooleanExpression(parsedAOpt->postfixExpressionList,
+                                   resultOpt->counterexample),
+            solveBooleanExpression(parsedBOpt->postfixExpressionList,
+                                   resultOpt->counterexample));
+
+  EXPECT_TRUE(isSameBooleanFunction(exprA, "(NOT A OR NOT B) OR C",
+                                    EquivalenceCheckMethod::SAT));
+}
+
+TEST(SATSolverTest, SixtyVariables) {
+  std::string sumOfProducts;
+  std::string negatedProductOfSums = "NOT (";
+  for (int i = 0; i < 30; i++) {
+    std::string term = "(x" + std::to_string(i) + " AND y" +
+                       std::to_string(i) + ")";
+    sumOfProducts += (i ? " OR " : "") + term;
+    negatedProductOfSums += (i ? " AND NOT " : "NOT ") + term;
+  }
+  negatedProductOfSums += ")";
+
+  EXPECT_TRUE(isSameBooleanFunction(sumOfProducts, negatedProductOfSums,
+                                    EquivalenceCheckMethod::SAT));
+
+  std::string almost = sumOfProducts;
+  almost.replace(almost.find("x7 AND"), 6, "x7 OR ");
+  auto resultOpt = checkBooleanEquivalence(sumOfProducts, almost,
+                                           EquivalenceCheckMethod::SAT);
+  ASSERT_TRUE(resultOpt.has_value());
+  EXPECT_FALSE(resultOpt->equivalent);
+  EXPECT_NE(resultOpt->counterexample.at("x7"),
+            resultOpt->counterexample.at("y7"));
+}
+} // namespace SCO
@@ -75,4 +75,182 @@ TEST(IsSameBooleanFunction, IsSameBooleanFunction) {
   result = SCO::isSameBooleanFunction(exprA, exprB);
   EXPECT_FALSE(result);
 }
-} // namespace SCO
\ No newline at end of file
+
+TEST(IsSameBooleanFunction, Statistics) {
+  BooleanExpressionStatistics statistics;
+  auto parsedExpressionOpt =
+      SCO::parseBooleanExpression("NOT (A AND B) OR C", &statistics);
+  ASSERT_TRUE(parsedExpressionOpt.has_value());
+  EXPECT_EQ(statistics.expressionsParsed, 1);
+  EXPECT_EQ(statistics.tokensParsed, 8);
+
+  auto resultsOpt =
+      SCO::simulateBooleanExpression(*parsedExpressionOpt, &statistics);
+  ASSERT_TRUE(resultsOpt.has_value());
+  EXPECT_EQ(resultsOpt->size(), 8);
+  EXPECT_EQ(statistics.combinationsSimulated, 8);
+}
+
+TEST(IsSameBooleanFunction, CompiledExpressionMatchesInterpreter) {
+  auto parsedExpressionOpt =
+      SCO::parseBooleanExpression("NOT (A AND B) OR C AND NOT D");
+  ASSERT_TRUE(parsedExpressionOpt.has_value());
+  auto compiledExpressionOpt =
+      SCO::compileBooleanExpression(*parsedExpressionOpt);
+  ASSERT_TRUE(compiledExpressionOpt.has_value());
+  EXPECT_EQ(compiledExpressionOpt->variables,
+            (std::vector<std::string>{"A", "B", "C", "D"}));
+  EXPECT_EQ(compiledExpressionOpt->code.size(),
+            parsedExpressionOpt->postfixExpressionList.size());
+
+  for (std::uint64_t mask = 0; mask < 16; mask++) {
+    std::unordered_map<std::string, bool> variablesValue;
+    for (std::size_t bit = 0; bit < 4; bit++) {
+      variablesValue[compiledExpressionOpt->variables[bit]] = (mask >> bit) & 1;
+    }
+    auto expected = SCO::solveBooleanExpression(
+        parsedExpressionOpt->postfixExpressionList, variablesValue);
+    ASSERT_TRUE(expected.has_value());
+    EXPECT_EQ(SCO::evaluateCompiledBooleanExpression(*compiledExpressionOpt,
+                                                     mask),
+              *expected)
+        << "Failed for mask " << mask;
+  }
+}
+
+TEST(IsSameBooleanFunction, CompileRejectsMissingOperands) {
+  SCO::ParsedBooleanExpression parsedExpression{{"A", "AND"}, {"A"}};
+  EXPECT_FALSE(SCO::compileBooleanExpression(parsedExpression));
+  EXPECT_FALSE(SCO::parseBooleanExpression("A AND"));
+}
+
+TEST(IsSameBooleanFunction, BitSlicedTruthTable) {
+  auto parsedExpressionOpt = SCO::parseBooleanExpression(
+      "(A AND NOT H) OR (B AND G) OR NOT (C OR D) AND (E OR F)");
+  ASSERT_TRUE(parsedExpressionOpt.has_value());
+  auto compiledExpressionOpt =
+      SCO::compileBooleanExpression(*parsedExpressionOpt);
+  ASSERT_TRUE(compiledExpressionOpt.has_value());
+
+  auto truthTableOpt = SCO::computeTruthTable(*compiledExpressionOpt);
+  ASSERT_TRUE(truthTableOpt.has_value());
+  ASSERT_EQ(truthTableOpt->size(), 4);
+  for (std::uint64_t mask = 0; mask < 256; mask++) {
+    EXPECT_EQ(((*truthTableOpt)[mask / 64] >> (mask % 64)) & 1,
+              SCO::evaluateCompiledBooleanExpression(*compiledExpressionOpt,
+                                                     mask))
+        << "Failed for mask " << mask;
+  }
+
+  auto smallExpressionOpt = SCO::parseBooleanExpression("A OR B");
+  ASSERT_TRUE(smallExpressionOpt.has_value());
+  auto smallTruthTableOpt = SCO::computeTruthTable(
+      *SCO::compileBooleanExpression(*smallExpressionOpt));
+  ASSERT_TRUE(smallTruthTableOpt.has_value());
+  EXPECT_EQ(*smallTruthTableOpt, std::vector<std::uint64_t>{0b1110});
+
+  // 128 words, so two blocks with variables above the sixth in each
+  auto largeExpressionOpt = SCO::parseBooleanExpression(
+      "(A AND NOT M) OR (B AND L) OR NOT (C OR K) AND (D OR J) OR "
+      "(E AND I AND NOT F) OR (G AND H)");
+  ASSERT_TRUE(largeExpressionOpt.has_value());
+  auto largeCompiledOpt = SCO::compileBooleanExpression(*largeExpressionOpt);
+  ASSERT_TRUE(largeCompiledOpt.has_value());
+  auto largeTruthTableOpt = SCO::computeTruthTable(*largeCompiledOpt);
+  ASSERT_TRUE(largeTruthTableOpt.has_value());
+  ASSERT_EQ(largeTruthTableOpt->size(), 128);
+  for (std::uint64_t mask = 0; mask < 8192; mask++) {
+    EXPECT_EQ(((*largeTruthTableOpt)[mask / 64] >> (mask % 64)) & 1,
+              SCO::evaluateCompiledBooleanExpression(*largeCompiledOpt, mask))
+        << "Failed for mask " << mask;
+  }
+}
+
+TEST(IsSameBooleanFunction, ManyVariables) {
+  std::string exprA = "NOT (A AND B AND C AND D AND E AND F AND G AND H AND I "
+                      "AND J AND K AND L)";
+  std::string exprB = "NOT A OR NOT B OR NOT C OR NOT D OR NOT E OR NOT F OR "
+                      "NOT G OR NOT H OR NOT I OR NOT J OR NOT K OR NOT L";
+  EXPECT_TRUE(SCO::isSameBooleanFunction(exprA, exprB));
+
+  exprB = "NOT A OR NOT B OR NOT C OR NOT D OR NOT E OR NOT F OR "
+          "NOT G OR NOT H OR NOT I OR NOT J OR NOT K OR L";
+  EXPECT_FALSE(SCO::isSameBooleanFunction(exprA, exprB));
+}
+
+TEST(IsSameBooleanFunction, MultiCharacterVariables) {
+  EXPECT_TRUE(SCO::isBooleanVariable("carry_in"));
+  EXPECT_TRUE(SCO::isBooleanVariable("X12"));
+  EXPECT_FALSE(SCO::isBooleanVariable("AND"));
+  EXPECT_FALSE(SCO::isBooleanVariable("1A"));
+
+  EXPECT_TRUE(SCO::isSameBooleanFunction(
+      "NOT (carry_in AND sum) OR x1", "NOT carry_in OR NOT sum OR x1",
+      SCO::EquivalenceCheckMethod::TruthTable));
+  EXPECT_TRUE(SCO::isSameBooleanFunction(
+      "NOT (carry_in AND sum) OR x1", "NOT carry_in OR NOT sum OR x1",
+      SCO::EquivalenceCheckMethod::BDD));
+}
+
+TEST(IsSameBooleanFunction, CounterexampleForEveryMethod) {
+  std::string exprA = "A AND (B OR C)";
+  std::string exprB = "(A AND B) OR C";
+  auto parsedAOpt = SCO::parseBooleanExpression(exprA);
+  auto parsedBOpt = SCO::parseBooleanExpression(exprB);
+  ASSERT_TRUE(parsedAOpt and parsedBOpt);
+
+  for (auto method :
+       {SCO::EquivalenceCheckMethod::TruthTable,
+        SCO::EquivalenceCheckMethod::BDD, SCO::EquivalenceCheckMethod::SAT}) {
+    auto resultOpt = SCO::checkBooleanEquivalence(exprA, exprB, method);
+    ASSERT_TRUE(resultOpt.has_value());
+    EXPECT_FALSE(resultOpt->equivalent);
+    EXPECT_NE(SCO::solveBooleanExpression(parsedAOpt->postfixExpressionList,
+                                          resultOpt->counterexample),
+              SCO::solveBooleanExpression(parsedBOpt->postfixExpressionList,
+                                          resultOpt->counterexample));
+  }
+}
+
+TEST(IsSameBooleanFunction, Lexer) {
+  SCO::BooleanLexer lexer{"NOT (carry_in AND b1)OR c"};
+  std::vector<SCO::BooleanTokenType> types;
+  std::vector<std::string_view> texts;
+  for (auto token = lexer.next(); token.type != SCO::BooleanTokenType::End;
+       token = lexer.next()) {
+    types.push_back(token.type);
+    texts.push_back(token.text);
+  }
+
+  using enum SCO::BooleanTokenType;
+  EXPECT_EQ(types, (std::vector{Not, LeftParenthesis, Variable, And, Variable,
+                                RightParenthesis, Or, Variable}));
+  EXPECT_EQ(texts, (std::vector<std::string_view>{"NOT", "(", "carry_in", "AND",
+                                                  "b1", ")", "OR", "c"}));
+  EXPECT_EQ(SCO::BooleanLexer{"A & B"}.next().type, Variable);
+}
+
+TEST(IsSameBooleanFunction, ParserRejectsMalformedExpressions) {
+  for (const char *expression :
+       {"", "A B", "A AND OR B", "(A AND B", "A AND B)", "NOT", "A & B",
+        "() OR A"}) {
+    EXPECT_FALSE(SCO::compileBooleanExpression(expression))
+        << "Accepted '" << expression << "'";
+  }
+}
+
+TEST(IsSameBooleanFunction, ParserReusesVariableTable) {
+  SCO::BooleanExpressionParser parser;
+  SCO::CompiledBooleanExpression compiledExpression;
+
+  ASSERT_TRUE(parser.parse("NOT NOT b OR a", compiledExpression));
+  EXPECT_EQ(compiledExpression.variables, (std::vector<std::string>{"a", "b"}));
+  EXPECT_TRUE(SCO::evaluateCompiledBooleanExpression(compiledExpression, 0b10));
+  EXPECT_FALSE(SCO::evaluateCompiledBooleanExpression(compiledExpression, 0b00));
+
+  ASSERT_TRUE(parser.parse("c AND NOT a", compiledExpression));
+  EXPECT_EQ(compiledExpression.variables, (std::vector<std::string>{"a", "c"}));
+  EXPECT_TRUE(SCO::evaluateCompiledBooleanExpression(compiledExpression, 0b10));
+  EXPECT_EQ(parser.variableTable.names.size(), 3);
+}
+} // namespace SCO
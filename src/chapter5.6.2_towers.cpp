@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <print>
 
@@ -9,7 +10,7 @@ namespace SCO {
 // source: the peg to move from (1, 2, or 3)
 // destination: the peg to move to (1, 2, or 3)
 int towers(int numberOfDisks, int source, int destination) {
-  static constexpr bool debug = true;
+  static constexpr bool debug = SCO_TRACE_TOWERS;
   if (numberOfDisks == 1) {
     if (debug) {
       std::print("Moving disk from {} to {}\n", source, destination);
@@ -28,4 +29,174 @@ int towers(int numberOfDisks, int source, int destination) {
 
   return moveCount;
 }
+
+namespace {
+// Prints why and returns false unless numberOfDisks is 0 to maxHanoiDisks
+// and the pegs are two different ones of 1, 2 and 3
+bool checkTowers(int numberOfDisks, int source, int destination) {
+  if (numberOfDisks < 0 or numberOfDisks > maxHanoiDisks) {
+    std::print("Can move 0 to {} disks, not {}\n", maxHanoiDisks,
+               numberOfDisks);
+    return false;
+  }
+  auto isPeg = [](int peg) { return peg >= 1 and peg <= 3; };
+  if (not isPeg(source) or not isPeg(destination) or source == destination) {
+    std::print("Pegs must be two different ones of 1, 2 and 3, not {} and "
+               "{}\n",
+               source, destination);
+    return false;
+  }
+  return true;
+}
+
+// The work left by towers(): move the top disks, or with single only the
+// disk numbered disks
+struct TowersFrame {
+  int disks;
+  int source;
+  int destination;
+  bool single;
+};
+
+// The recursion of towers() unrolled onto an explicit stack, one move per
+// call to next()
+class TowersStack {
+public:
+  TowersStack(int numberOfDisks, int source, int destination) {
+    if (numberOfDisks >= 1) {
+      frames[size++] = {numberOfDisks, source, destination, false};
+    }
+  }
+
+  bool next(HanoiMove &move) {
+    while (size > 0) {
+      const TowersFrame frame = frames[--size];
+      if (frame.single or frame.disks == 1) {
+        move = {static_cast<std::uint8_t>(frame.single ? frame.disks : 1),
+                static_cast<std::uint8_t>(frame.source),
+                static_cast<std::uint8_t>(frame.destination)};
+        return true;
+      }
+      // Pushed in reverse so the first subproblem runs first
+      const int spare = 6 - frame.source - frame.destination;
+      frames[size++] = {frame.disks - 1, spare, frame.destination, false};
+      frames[size++] = {frame.disks, frame.source, frame.destination, true};
+      frames[size++] = {frame.disks - 1, frame.source, spare, false};
+    }
+    return false;
+  }
+
+private:
+  std::array<TowersFrame, 2 * maxHanoiDisks + 1> frames;
+  std::size_t size = 0;
+};
+} // namespace
+
+std::optional<std::uint64_t>
+towersExplicitStack(int numberOfDisks, int source, int destination) {
+  if (not checkTowers(numberOfDisks, source, destination)) {
+    return std::nullopt;
+  }
+  TowersStack stack(numberOfDisks, source, destination);
+  std::uint64_t moveCount = 0;
+  HanoiMove move;
+  while (stack.next(move)) {
+    moveCount++;
+  }
+  return moveCount;
+}
+
+HanoiGenerator hanoiCoroutine(int numberOfDisks, int source,
+                              int destination) {
+  if (not checkTowers(numberOfDisks, source, destination)) {
+    co_return;
+  }
+  TowersStack stack(numberOfDisks, source, destination);
+  HanoiMove move;
+  while (stack.next(move)) {
+    co_yield move;
+  }
+}
+
+std::size_t HanoiMoves::generate(std::uint64_t first,
+                                 std::span<HanoiMove> out) const {
+  if (first == 0 or first > size()) {
+    return 0;
+  }
+  const std::size_t count = static_cast<std::size_t>(
+      std::min<std::uint64_t>(out.size(), size() - first + 1));
+  for (std::size_t i = 0; i < count; i++) {
+    out[i] = move(first + i);
+  }
+  return count;
+}
+
+std::optional<std::vector<std::uint8_t>>
+HanoiMoves::configurationAfter(std::uint64_t k) const {
+  if (k > size()) {
+    std::print("{} disks are done after {} moves, not {}\n", disks, size(),
+               k);
+    return std::nullopt;
+  }
+
+  // In the canonical solution odd disks cycle 0 -> 2 -> 1 -> 0 and even
+  // disks 0 -> 1 -> 2 -> 0
+  std::vector<std::uint8_t> configuration(disks);
+  for (int disk = 1; disk <= disks; disk++) {
+    const std::uint64_t moved =
+        (disk < 64 ? k >> disk : 0) + ((k >> (disk - 1)) & 1);
+    const std::uint64_t step = disk % 2 == 1 ? 2 : 1;
+    configuration[disk - 1] = pegs[moved % 3 * step % 3];
+  }
+  return configuration;
+}
+
+std::optional<std::uint64_t>
+HanoiMoves::moveIndex(std::span<const std::uint8_t> configuration) const {
+  if (configuration.size() != static_cast<std::size_t>(disks)) {
+    std::print("Expected the pegs of {} disks, got {}\n", disks,
+               configuration.size());
+    return std::nullopt;
+  }
+
+  // Moving disks 1..d from source to destination: disk d is either still
+  // on the source, with disks 1..d-1 on their way to the spare peg, or
+  // already on the destination after 2^(d-1) moves, with the rest on their
+  // way from the spare peg
+  int source = pegs[0];
+  int destination = disks % 2 == 1 ? pegs[2] : pegs[1];
+  int spare = 6 - source - destination;
+  std::uint64_t k = 0;
+  for (int disk = disks; disk >= 1; disk--) {
+    const int peg = configuration[disk - 1];
+    if (peg == source) {
+      std::swap(destination, spare);
+    } else if (peg == destination) {
+      k |= std::uint64_t{1} << (disk - 1);
+      std::swap(source, spare);
+    } else {
+      std::print("Disk {} cannot be on peg {} in the optimal solution\n",
+                 disk, peg);
+      return std::nullopt;
+    }
+  }
+  return k;
+}
+
+std::optional<HanoiMoves> hanoiMoves(int numberOfDisks, int source,
+                                     int destination) {
+  if (not checkTowers(numberOfDisks, source, destination)) {
+    return std::nullopt;
+  }
+
+  // The canonical solution ends on peg 2 for an odd number of disks and on
+  // peg 1 for an even one
+  const int canonicalDestination = numberOfDisks % 2 == 1 ? 2 : 1;
+  std::array<std::uint8_t, 3> pegs;
+  pegs[0] = static_cast<std::uint8_t>(source);
+  pegs[canonicalDestination] = static_cast<std::uint8_t>(destination);
+  pegs[3 - canonicalDestination] =
+      static_cast<std::uint8_t>(6 - source - destination);
+  return HanoiMoves(numberOfDisks, pegs);
+}
 } // namespace SCO
@@ -1,6 +1,23 @@
 #pragma once
 
+#include <array>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <optional>
 #include <print>
+#include <span>
+#include <utility>
+#include <vector>
+
+// towers() prints every move unless built with SCO_TRACE_TOWERS=0, which
+// its benchmark needs to measure the calls rather than the printing
+#ifndef SCO_TRACE_TOWERS
+#define SCO_TRACE_TOWERS 1
+#endif
 
 namespace SCO {
 // Towers of Hanoi recursive solution
@@ -8,4 +25,194 @@ namespace SCO {
 // source: the peg to move from (1, 2, or 3)
 // destination: the peg to move to (1, 2, or 3)
 int towers(int numberOfDisks, int source, int destination);
+
+inline constexpr int maxHanoiDisks = 64;
+
+// Disks count from 1 for the smallest, pegs from 1 like towers()
+struct HanoiMove {
+  std::uint8_t disk;
+  std::uint8_t from;
+  std::uint8_t to;
+
+  bool operator==(const HanoiMove &) const = default;
+};
+
+// 2^n - 1, for up to maxHanoiDisks disks
+constexpr std::uint64_t hanoiMoveCount(int numberOfDisks) {
+  return numberOfDisks >= 64 ? UINT64_MAX
+                             : (std::uint64_t{1} << numberOfDisks) - 1;
+}
+
+// The moves of the optimal solution, computed from the move number alone:
+// move k moves disk countr_zero(k) + 1, and with the pegs numbered 0 to 2
+// it goes from (k & (k - 1)) % 3 to ((k | (k - 1)) + 1) % 3. That moves the
+// tower from peg 0 to peg 2 for an odd number of disks and to peg 1 for an
+// even one, and a permutation maps those onto the requested pegs.
+class HanoiMoves {
+public:
+  class Iterator {
+  public:
+    using value_type = HanoiMove;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(const HanoiMoves *moves, std::uint64_t k) : moves(moves), k(k) {}
+
+    HanoiMove operator*() const { return moves->move(k); }
+    Iterator &operator++() {
+      k++;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      k++;
+      return previous;
+    }
+    bool operator==(const Iterator &other) const { return k == other.k; }
+
+  private:
+    const HanoiMoves *moves = nullptr;
+    std::uint64_t k = 1;
+  };
+
+  int numberOfDisks() const { return disks; }
+  std::uint64_t size() const { return hanoiMoveCount(disks); }
+
+  // Moves are numbered from 1 to size(). The iterators hold a pointer to
+  // this object. For 64 disks end() wraps around to move 0, which is where
+  // incrementing past the last move ends up too.
+  Iterator begin() const { return {this, 1}; }
+  Iterator end() const { return {this, size() + 1}; }
+
+  HanoiMove move(std::uint64_t k) const {
+    // (k | (k - 1)) + 1 overflows for the last move of 64 disks, so the
+    // + 1 is applied after reducing modulo 3
+    const auto from = static_cast<std::uint8_t>((k & (k - 1)) % 3);
+    const auto to = static_cast<std::uint8_t>(((k | (k - 1)) % 3 + 1) % 3);
+    return {static_cast<std::uint8_t>(std::countr_zero(k) + 1), pegs[from],
+            pegs[to]};
+  }
+
+  // Writes moves first, first + 1, ... into out until it is full or the
+  // solution ends, and returns how many were written
+  std::size_t generate(std::uint64_t first, std::span<HanoiMove> out) const;
+
+  // The peg of each disk after k moves, smallest disk first, or nullopt
+  // past the last move. Disk d has moved (k + 2^(d-1)) / 2^d times, always
+  // in the same direction around the pegs, so this takes O(1) per disk.
+  std::optional<std::vector<std::uint8_t>>
+  configurationAfter(std::uint64_t k) const;
+
+  // The inverse: how many moves lead to a configuration in the format
+  // configurationAfter returns, or nullopt if the solution never passes
+  // through it. Each disk from the largest down decides one bit of k.
+  std::optional<std::uint64_t>
+  moveIndex(std::span<const std::uint8_t> configuration) const;
+
+private:
+  friend std::optional<HanoiMoves> hanoiMoves(int numberOfDisks, int source,
+                                              int destination);
+
+  HanoiMoves(int disks, std::array<std::uint8_t, 3> pegs)
+      : disks(disks), pegs(pegs) {}
+
+  int disks;
+  // The requested peg for each peg of the canonical solution
+  std::array<std::uint8_t, 3> pegs;
+};
+
+// The moves for numberOfDisks from 0 to maxHanoiDisks between two different
+// pegs, or nullopt for anything else
+std::optional<HanoiMoves> hanoiMoves(int numberOfDisks, int source,
+                                     int destination);
+
+// towers() without recursion: the pending subproblems live in an explicit
+// stack of at most 2 * numberOfDisks + 1 frames. Returns the number of moves,
+// or nullopt for the arguments hanoiMoves() rejects.
+std::optional<std::uint64_t>
+towersExplicitStack(int numberOfDisks, int source, int destination);
+
+// towers() evaluated at compile time, for small enough numberOfDisks to
+// stay within the compiler's constexpr limits
+constexpr std::uint64_t towersConstexpr(int numberOfDisks, int source,
+                                        int destination) {
+  if (numberOfDisks == 1) {
+    return 1;
+  }
+  const int spare = 6 - source - destination;
+  return towersConstexpr(numberOfDisks - 1, source, spare) + 1 +
+         towersConstexpr(numberOfDisks - 1, spare, destination);
+}
+
+// A coroutine yielding the moves of towers() one at a time, resumed by its
+// input iterator. Hand-rolled on <coroutine> since std::generator is not
+// available everywhere yet.
+class HanoiGenerator {
+public:
+  struct promise_type {
+    HanoiMove current{};
+
+    HanoiGenerator get_return_object() {
+      return HanoiGenerator(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    std::suspend_always yield_value(HanoiMove move) noexcept {
+      current = move;
+      return {};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  class Iterator {
+  public:
+    using value_type = HanoiMove;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    explicit Iterator(std::coroutine_handle<promise_type> handle)
+        : handle(handle) {}
+
+    HanoiMove operator*() const { return handle.promise().current; }
+    Iterator &operator++() {
+      handle.resume();
+      return *this;
+    }
+    void operator++(int) { handle.resume(); }
+    bool operator==(std::default_sentinel_t) const { return handle.done(); }
+
+  private:
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  HanoiGenerator(HanoiGenerator &&other) noexcept
+      : handle(std::exchange(other.handle, {})) {}
+  HanoiGenerator &operator=(HanoiGenerator &&other) noexcept {
+    std::swap(handle, other.handle);
+    return *this;
+  }
+  ~HanoiGenerator() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  // Runs the coroutine to its first move, so call it once
+  Iterator begin() {
+    handle.resume();
+    return Iterator(handle);
+  }
+  std::default_sentinel_t end() const { return {}; }
+
+private:
+  explicit HanoiGenerator(std::coroutine_handle<promise_type> handle)
+      : handle(handle) {}
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+// Yields nothing for the arguments hanoiMoves() rejects
+HanoiGenerator hanoiCoroutine(int numberOfDisks, int source, int destination);
 } // namespace SCO
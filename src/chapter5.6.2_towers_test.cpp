@@ -1,3 +1,20 @@
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "gtest/gtest.h"
 
@@ -28,4 +45,310 @@ TEST(TowersTest, MoveFiveDisks) {
   int moveCount = towers(5, 1, 3);
   EXPECT_EQ(moveCount, 31);
 }
-} // namespace SCO
\ No newline at end of file
+
+namespace {
+// The moves of the textbook recursion, for checking the closed form
+void recursiveMoves(int numberOfDisks, int source, int destination,
+                    std::vector<HanoiMove> &moves) {
+  if (numberOfDisks == 0) {
+    return;
+  }
+  const int spare = 6 - source - destination;
+  recursiveMoves(numberOfDisks - 1, source, spare, moves);
+  moves.push_back({static_cast<std::uint8_t>(numberOfDisks),
+                   static_cast<std::uint8_t>(source),
+                   static_cast<std::uint8_t>(destination)});
+  recursiveMoves(numberOfDisks - 1, spare, destination, moves);
+}
+} // namespace
+
+static_assert(std::forward_iterator<HanoiMoves::Iterator>);
+static_assert(std::ranges::sized_range<HanoiMoves>);
+
+TEST(TowersTest, IterativeMatchesRecursive) {
+  for (int numberOfDisks = 0; numberOfDisks <= 12; numberOfDisks++) {
+    for (auto [source, destination] :
+         {std::pair{1, 3}, {1, 2}, {2, 1}, {2, 3}, {3, 1}, {3, 2}}) {
+      std::vector<HanoiMove> expected;
+      recursiveMoves(numberOfDisks, source, destination, expected);
+
+      auto moves = hanoiMoves(numberOfDisks, source, destination);
+      ASSERT_TRUE(moves.has_value());
+      EXPECT_EQ(moves->size(), expected.size());
+      EXPECT_TRUE(std::ranges::equal(*moves, expected))
+          << numberOfDisks << " disks from " << source << " to "
+          << destination;
+
+      std::vector<HanoiMove> buffer(expected.size() + 5);
+      EXPECT_EQ(moves->generate(1, buffer), expected.size());
+      buffer.resize(expected.size());
+      EXPECT_EQ(buffer, expected);
+    }
+  }
+}
+
+TEST(TowersTest, SixtyFourDisks) {
+  EXPECT_EQ(hanoiMoveCount(31), 2147483647u);
+  EXPECT_EQ(hanoiMoveCount(40), 1099511627775u);
+  EXPECT_EQ(hanoiMoveCount(64), UINT64_MAX);
+
+  auto moves = hanoiMoves(64, 1, 3);
+  ASSERT_TRUE(moves.has_value());
+  EXPECT_EQ(moves->size(), UINT64_MAX);
+  // The largest disk moves once, in the middle, and the smallest last
+  EXPECT_EQ(moves->move(std::uint64_t{1} << 63), (HanoiMove{64, 1, 3}));
+  EXPECT_EQ(moves->move(UINT64_MAX), (HanoiMove{1, 2, 3}));
+
+  std::vector<HanoiMove> buffer(10);
+  EXPECT_EQ(moves->generate(UINT64_MAX - 2, buffer), 3u);
+  EXPECT_EQ(moves->generate(0, buffer), 0u);
+  auto last = moves->begin();
+  for (std::uint64_t i = 1; i < 3; i++) {
+    ++last;
+  }
+  EXPECT_EQ(*last, moves->move(3));
+
+  EXPECT_FALSE(hanoiMoves(65, 1, 3).has_value());
+  EXPECT_FALSE(hanoiMoves(3, 1, 1).has_value());
+  EXPECT_FALSE(hanoiMoves(3, 0, 2).has_value());
+}
+
+TEST(TowersTest, ConfigurationQueries) {
+  for (int numberOfDisks = 0; numberOfDisks <= 10; numberOfDisks++) {
+    auto moves = hanoiMoves(numberOfDisks, 2, 3);
+    ASSERT_TRUE(moves.has_value());
+
+    // Replay the moves, checking each one takes the top disk off its peg
+    std::vector<std::uint8_t> configuration(numberOfDisks, 2);
+    std::uint64_t k = 0;
+    for (HanoiMove move : *moves) {
+      EXPECT_EQ(moves->configurationAfter(k), configuration);
+      EXPECT_EQ(moves->moveIndex(configuration), k);
+      ASSERT_EQ(configuration[move.disk - 1], move.from);
+      for (int smaller = 0; smaller < move.disk - 1; smaller++) {
+        ASSERT_NE(configuration[smaller], move.from);
+        ASSERT_NE(configuration[smaller], move.to);
+      }
+      configuration[move.disk - 1] = move.to;
+      k++;
+    }
+    EXPECT_EQ(configuration, std::vector<std::uint8_t>(numberOfDisks, 3));
+    EXPECT_EQ(moves->configurationAfter(k), configuration);
+    EXPECT_EQ(moves->moveIndex(configuration), k);
+    EXPECT_FALSE(moves->configurationAfter(k + 1).has_value());
+  }
+
+  auto moves = hanoiMoves(3, 1, 3);
+  EXPECT_FALSE(moves->moveIndex(std::vector<std::uint8_t>{1, 1, 2}));
+  EXPECT_FALSE(moves->moveIndex(std::vector<std::uint8_t>{1, 1}));
+  // Legal but off the optimal path: disk 1 on top of disk 2 on peg 3
+  EXPECT_FALSE(moves->moveIndex(std::vector<std::uint8_t>{3, 3, 1}));
+
+  // Halfway through 64 disks everything but the largest is on the spare peg
+  auto huge = hanoiMoves(64, 1, 3);
+  auto halfway = huge->configurationAfter(std::uint64_t{1} << 63);
+  std::vector<std::uint8_t> expected(64, 2);
+  expected[63] = 3;
+  EXPECT_EQ(halfway, expected);
+  for (std::uint64_t k : {std::uint64_t{0}, std::uint64_t{12345678987654321},
+                          UINT64_MAX - 1, UINT64_MAX}) {
+    EXPECT_EQ(huge->moveIndex(*huge->configurationAfter(k)), k);
+  }
+}
+
+static_assert(towersConstexpr(10, 1, 3) == 1023);
+static_assert(std::input_iterator<HanoiGenerator::Iterator>);
+
+TEST(TowersTest, RecursionFreeVariants) {
+  for (int numberOfDisks = 1; numberOfDisks <= 10; numberOfDisks++) {
+    std::vector<HanoiMove> expected;
+    recursiveMoves(numberOfDisks, 3, 2, expected);
+    EXPECT_EQ(towersExplicitStack(numberOfDisks, 3, 2).value_or(0),
+              expected.size());
+    EXPECT_EQ(towersConstexpr(numberOfDisks, 3, 2), expected.size());
+
+    std::vector<HanoiMove> generated;
+    for (HanoiMove move : hanoiCoroutine(numberOfDisks, 3, 2)) {
+      generated.push_back(move);
+    }
+    EXPECT_EQ(generated, expected);
+  }
+  EXPECT_EQ(towersExplicitStack(0, 1, 3).value_or(1), 0u);
+
+  // The explicit stack holds frames for at most maxHanoiDisks disks
+  EXPECT_FALSE(towersExplicitStack(maxHanoiDisks + 1, 1, 3).has_value());
+  EXPECT_FALSE(towersExplicitStack(3, 2, 2).has_value());
+  auto rejected = hanoiCoroutine(maxHanoiDisks + 1, 1, 3);
+  EXPECT_TRUE(rejected.begin() == rejected.end());
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(TowersTest, DISABLED_GenerateBenchmark) {
+  using Clock = std::chrono::steady_clock;
+  auto moves = hanoiMoves(30, 1, 3);
+  std::vector<HanoiMove> buffer(1 << 16);
+  std::uint64_t checksum = 0;
+
+  auto start = Clock::now();
+  for (std::uint64_t first = 1; first <= moves->size();
+       first += buffer.size()) {
+    const std::size_t count = moves->generate(first, buffer);
+    checksum += buffer[count - 1].to;
+  }
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  std::print("{} moves of 30 disks in {:.2f} s: {:.0f} M moves/s "
+             "(checksum {})\n",
+             moves->size(), elapsed.count(),
+             moves->size() / elapsed.count() / 1e6, checksum);
+}
+
+namespace {
+#ifdef __linux__
+// Instructions retired in user space by the calling thread while work
+// runs, or nullopt where perf events are unavailable or not permitted
+std::optional<std::uint64_t>
+countInstructions(const std::function<void()> &work) {
+  perf_event_attr attributes{};
+  attributes.type = PERF_TYPE_HARDWARE;
+  attributes.size = sizeof(attributes);
+  attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attributes.disabled = 1;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  const int fd = static_cast<int>(
+      syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+  if (fd < 0) {
+    return std::nullopt;
+  }
+
+  ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  work();
+  ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  std::uint64_t count = 0;
+  const bool haveCount = read(fd, &count, sizeof(count)) == sizeof(count);
+  close(fd);
+  return haveCount ? std::optional(count) : std::nullopt;
+}
+
+// Bytes of stack work touches: it runs on a thread whose stack is painted
+// with a pattern first, and the deepest overwritten byte marks the high
+// water. Includes the thread start-up, so callers subtract a baseline.
+std::optional<std::size_t> measureStack(std::function<void()> work) {
+  constexpr std::size_t stackSize = 1 << 20;
+  constexpr unsigned char paint = 0xA5;
+  std::vector<unsigned char> stack(stackSize, paint);
+
+  pthread_attr_t attributes;
+  pthread_attr_init(&attributes);
+  pthread_attr_setstack(&attributes, stack.data(), stack.size());
+  pthread_t thread;
+  auto run = [](void *argument) -> void * {
+    (*static_cast<std::function<void()> *>(argument))();
+    return nullptr;
+  };
+  const bool started =
+      pthread_create(&thread, &attributes, run, &work) == 0;
+  pthread_attr_destroy(&attributes);
+  if (not started) {
+    return std::nullopt;
+  }
+  pthread_join(thread, nullptr);
+
+  // The stack grows down from the end of the buffer
+  const auto untouched = std::ranges::find_if(
+      stack, [](unsigned char byte) { return byte != paint; });
+  return static_cast<std::size_t>(stack.end() - untouched);
+}
+#else
+std::optional<std::uint64_t>
+countInstructions(const std::function<void()> &) {
+  return std::nullopt;
+}
+
+std::optional<std::size_t> measureStack(std::function<void()>) {
+  return std::nullopt;
+}
+#endif
+
+template <typename T> std::string formatOptional(std::optional<T> value) {
+  return value ? std::to_string(*value) : "n/a";
+}
+} // namespace
+
+// Run with --gtest_also_run_disabled_tests, and SCO_TRACE_TOWERS=0 for the
+// recursive towers() row. Compares towers() with the same moves made by an
+// explicit stack, a coroutine and the closed form, plus a compile-time
+// evaluation that leaves nothing to do at run time.
+TEST(TowersTest, DISABLED_RecursionBenchmark) {
+  using Clock = std::chrono::steady_clock;
+  constexpr int numberOfDisks = 24;
+  const std::uint64_t numMoves = hanoiMoveCount(numberOfDisks);
+  volatile std::uint64_t sink = 0;
+
+  struct Variant {
+    const char *name;
+    std::function<void()> run;
+  };
+  const std::vector<Variant> variants = {
+      {"recursive",
+       [&] {
+         if (not SCO_TRACE_TOWERS) {
+           sink = towers(numberOfDisks, 1, 3);
+         }
+       }},
+      {"explicit stack",
+       [&] { sink = *towersExplicitStack(numberOfDisks, 1, 3); }},
+      {"coroutine",
+       [&] {
+         std::uint64_t checksum = 0;
+         for (HanoiMove move : hanoiCoroutine(numberOfDisks, 1, 3)) {
+           checksum += move.to;
+         }
+         sink = checksum;
+       }},
+      {"closed form",
+       [&] {
+         std::uint64_t checksum = 0;
+         const auto moves = hanoiMoves(numberOfDisks, 1, 3);
+         for (HanoiMove move : *moves) {
+           checksum += move.to;
+         }
+         sink = checksum;
+       }},
+  };
+
+  const auto baseline = measureStack([] {});
+  std::print("{} disks, {} moves\n{:>16} {:>10} {:>12} {:>14}\n",
+             numberOfDisks, numMoves, "", "ns/move", "stack bytes",
+             "instr/move");
+  for (const Variant &variant : variants) {
+    if (variant.name == std::string("recursive") and SCO_TRACE_TOWERS) {
+      std::print("{:>16} skipped, build with SCO_TRACE_TOWERS=0\n",
+                 variant.name);
+      continue;
+    }
+    auto start = Clock::now();
+    variant.run();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+    auto stack = measureStack(variant.run);
+    if (stack and baseline) {
+      *stack -= std::min(*stack, *baseline);
+    }
+    auto instructions = countInstructions(variant.run);
+    if (instructions) {
+      *instructions /= numMoves;
+    }
+    std::print("{:>16} {:>10.2f} {:>12} {:>14}\n", variant.name,
+               elapsed.count() / numMoves, formatOptional(stack),
+               formatOptional(instructions));
+  }
+
+  // Evaluated by the compiler; at run time only the result is loaded
+  constexpr std::uint64_t compileTime = towersConstexpr(14, 1, 3);
+  sink = compileTime;
+  std::print("{:>16} {:>10} {:>12} {:>14}   ({} moves of 14 disks)\n",
+             "constexpr", "n/a", "n/a", "n/a", compileTime);
+}
+} // namespace SCO
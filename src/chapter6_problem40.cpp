@@ -1,4 +1,3 @@
-
 #ifdef __linux__
 #include "gtest/gtest.h"
 
@@ -6,19 +5,26 @@
 #include <string>
 
 #include <dirent.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 
 namespace SCO {
 TEST(ListDir, UNIX) {
   std::string rootDir = "../testing_dir";
   auto dirPointer = opendir(rootDir.c_str());
+  if (dirPointer == nullptr) {
+    GTEST_SKIP() << "Cannot open " << rootDir;
+  }
   while (auto dirEntry = readdir(dirPointer)) {
     struct stat stat;
     std::string filepath = rootDir + "/" + dirEntry->d_name;
-    lstat(filepath.c_str(), &stat);
+    if (lstat(filepath.c_str(), &stat) != 0) {
+      continue;
+    }
     std::print("[Dir entry] Name: '{}', Size: {} Bytes\n", dirEntry->d_name,
                stat.st_size);
   }
+  closedir(dirPointer);
 }
+} // namespace SCO
 #endif
-} // namespace SCO
\ No newline at end of file
@@ -0,0 +1,528 @@
+#include "chapter6_problem40_scan.hpp"
+
+#include <print>
+
+#ifdef __linux__
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace SCO {
+#ifdef __linux__
+namespace {
+// The kernel's record for getdents64; glibc only wraps it in newer versions
+struct LinuxDirent64 {
+  std::uint64_t inode;
+  std::int64_t offset;
+  unsigned short recordLength;
+  unsigned char type;
+  char name[];
+};
+
+int openDirectory(const std::string &path) {
+  return open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+struct DirectoryWork {
+  std::string path;
+  std::size_t parent;
+};
+
+// One deque per thread: the owner pushes and pops at the back, so it goes
+// depth first through directories whose parents it just read, and thieves
+// take the oldest work from the front
+class WorkQueues {
+public:
+  explicit WorkQueues(unsigned numThreads) : queues(numThreads) {}
+
+  void push(unsigned self, DirectoryWork work) {
+    pending++;
+    {
+      std::lock_guard lock(queues[self].mutex);
+      queues[self].work.push_back(std::move(work));
+    }
+    changes++;
+    changes.notify_one();
+  }
+
+  // Blocks until there is work, or returns nullopt once every directory is
+  // finished. Idle threads sleep on changes rather than spin: it is read
+  // before looking for work, so a push or finish in between makes the wait
+  // return at once.
+  std::optional<DirectoryWork> next(unsigned self) {
+    while (true) {
+      const std::uint64_t seen = changes;
+      if (auto work = pop(self)) {
+        return work;
+      }
+      if (pending == 0) {
+        return std::nullopt;
+      }
+      changes.wait(seen);
+    }
+  }
+
+  // Called once a popped directory is done, after pushing its children
+  void finished() {
+    if (--pending == 0) {
+      changes++;
+      changes.notify_all();
+    }
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<DirectoryWork> work;
+  };
+
+  std::optional<DirectoryWork> pop(unsigned self) {
+    {
+      Queue &own = queues[self];
+      std::lock_guard lock(own.mutex);
+      if (not own.work.empty()) {
+        DirectoryWork work = std::move(own.work.back());
+        own.work.pop_back();
+        return work;
+      }
+    }
+    for (std::size_t i = 1; i < queues.size(); i++) {
+      Queue &victim = queues[(self + i) % queues.size()];
+      std::lock_guard lock(victim.mutex);
+      if (not victim.work.empty()) {
+        DirectoryWork work = std::move(victim.work.front());
+        victim.work.pop_front();
+        return work;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::vector<Queue> queues;
+  std::atomic<std::uint64_t> pending = 0;
+  // Bumped by every push and by the last finish
+  std::atomic<std::uint64_t> changes = 0;
+};
+
+// The few io_uring pieces that batching statx needs, on the raw system
+// calls like getdents64 rather than liburing. Each thread has its own ring,
+// so one thread submits and reaps.
+class StatxRing {
+public:
+  // Statx calls per batch
+  static constexpr unsigned numEntries = 256;
+
+  StatxRing() = default;
+  StatxRing(const StatxRing &) = delete;
+  StatxRing &operator=(const StatxRing &) = delete;
+  ~StatxRing() {
+    if (sqes != nullptr) {
+      munmap(sqes, sqesSize);
+    }
+    if (cqRing != nullptr and cqRing != sqRing) {
+      munmap(cqRing, cqRingSize);
+    }
+    if (sqRing != nullptr) {
+      munmap(sqRing, sqRingSize);
+    }
+    if (ringFd >= 0) {
+      close(ringFd);
+    }
+  }
+
+  // 0, or the errno of the failed call. ENOSYS also stands for a kernel
+  // that has io_uring but not IORING_OP_STATX, which came in 5.6.
+  int setup() {
+    io_uring_params params{};
+    ringFd =
+        static_cast<int>(syscall(__NR_io_uring_setup, numEntries, &params));
+    if (ringFd < 0) {
+      return errno;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+      sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+    sqRing = map(sqRingSize, IORING_OFF_SQ_RING);
+    if (sqRing == nullptr) {
+      return errno;
+    }
+    cqRing = singleMmap ? sqRing : map(cqRingSize, IORING_OFF_CQ_RING);
+    if (cqRing == nullptr) {
+      return errno;
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(map(sqesSize, IORING_OFF_SQES));
+    if (sqes == nullptr) {
+      return errno;
+    }
+
+    sqTail = at<unsigned>(sqRing, params.sq_off.tail);
+    sqMask = *at<unsigned>(sqRing, params.sq_off.ring_mask);
+    sqArray = at<unsigned>(sqRing, params.sq_off.array);
+    cqHead = at<unsigned>(cqRing, params.cq_off.head);
+    cqTail = at<unsigned>(cqRing, params.cq_off.tail);
+    cqMask = *at<unsigned>(cqRing, params.cq_off.ring_mask);
+    cqes = at<io_uring_cqe>(cqRing, params.cq_off.cqes);
+    tail = *sqTail;
+    return supportsStatx() ? 0 : ENOSYS;
+  }
+
+  // Queues an lstat-like statx of name relative to the directory fd. name
+  // and status must stay valid until submitAndWait returns, and a batch
+  // holds at most numEntries.
+  void queue(int directory, const char *name, unsigned mask,
+             struct statx *status, std::uint64_t tag) {
+    const unsigned index = tail & sqMask;
+    io_uring_sqe &sqe = sqes[index];
+    sqe = {};
+    sqe.opcode = IORING_OP_STATX;
+    sqe.fd = directory;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(name);
+    sqe.len = mask;
+    sqe.off = reinterpret_cast<std::uintptr_t>(status);
+    sqe.statx_flags = AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT;
+    sqe.user_data = tag;
+    sqArray[index] = index;
+    tail++;
+    numQueued++;
+  }
+
+  // Submits the batch in one io_uring_enter, and calls done(tag, result)
+  // for each completion with the result of statx as 0 or -errno. false if
+  // io_uring_enter fails, which leaves the rest of the batch unreported.
+  template <typename Done> bool submitAndWait(Done done) {
+    std::atomic_ref(*sqTail).store(tail, std::memory_order_release);
+    unsigned toSubmit = numQueued;
+    unsigned remaining = numQueued;
+    numQueued = 0;
+    while (remaining > 0) {
+      const long submitted =
+          syscall(__NR_io_uring_enter, ringFd, toSubmit, remaining,
+                  IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (submitted < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      toSubmit -= static_cast<unsigned>(submitted);
+
+      unsigned head = *cqHead;
+      const unsigned completed =
+          std::atomic_ref(*cqTail).load(std::memory_order_acquire);
+      for (; head != completed; head++) {
+        const io_uring_cqe &cqe = cqes[head & cqMask];
+        done(cqe.user_data, cqe.res);
+        remaining--;
+      }
+      std::atomic_ref(*cqHead).store(head, std::memory_order_release);
+    }
+    return true;
+  }
+
+private:
+  template <typename T> static T *at(void *ring, std::uint32_t offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+  }
+
+  void *map(std::size_t size, std::uint64_t offset) const {
+    void *ring = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd,
+                      static_cast<off_t>(offset));
+    return ring == MAP_FAILED ? nullptr : ring;
+  }
+
+  bool supportsStatx() const {
+    constexpr unsigned numOps = 256;
+    std::vector<char> buffer(sizeof(io_uring_probe) +
+                             numOps * sizeof(io_uring_probe_op));
+    auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe,
+                numOps) < 0) {
+      return false;
+    }
+    return probe->last_op >= IORING_OP_STATX and
+           (probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED);
+  }
+
+  int ringFd = -1;
+  void *sqRing = nullptr;
+  void *cqRing = nullptr;
+  io_uring_sqe *sqes = nullptr;
+  std::size_t sqRingSize = 0;
+  std::size_t cqRingSize = 0;
+  std::size_t sqesSize = 0;
+  unsigned *sqTail = nullptr;
+  unsigned sqMask = 0;
+  unsigned *sqArray = nullptr;
+  unsigned *cqHead = nullptr;
+  unsigned *cqTail = nullptr;
+  unsigned cqMask = 0;
+  io_uring_cqe *cqes = nullptr;
+  // The submission tail as far as this thread has filled it
+  unsigned tail = 0;
+  unsigned numQueued = 0;
+};
+
+class Scanner {
+public:
+  Scanner(unsigned numThreads, std::size_t bufferSize)
+      : queues(numThreads), bufferSize(bufferSize) {}
+
+  // One ring per thread, or none where the kernel has no io_uring or it is
+  // not allowed, and every entry gets its own statx. 0, or the errno of any
+  // other failure.
+  int setupRings(unsigned numThreads) {
+    for (unsigned t = 0; t < numThreads; t++) {
+      auto ring = std::make_unique<StatxRing>();
+      const int error = ring->setup();
+      if (error == ENOSYS or error == EPERM) {
+        rings.clear();
+        return 0;
+      }
+      if (error != 0) {
+        return error;
+      }
+      rings.push_back(std::move(ring));
+    }
+    return 0;
+  }
+
+  void run(std::string root, unsigned numThreads) {
+    queues.push(0, {std::move(root), SIZE_MAX});
+    auto worker = [this](unsigned self) {
+      Scratch scratch;
+      scratch.buffer.resize(bufferSize);
+      if (not rings.empty()) {
+        scratch.statuses.resize(StatxRing::numEntries);
+      }
+      while (auto work = queues.next(self)) {
+        scan(self, std::move(*work), scratch);
+        queues.finished();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < numThreads; t++) {
+      threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  DirectoryScan result() {
+    // Children come after their parents, so one backwards pass sums the
+    // subtrees
+    for (auto &directory : scan_.directories) {
+      directory.totalFiles = directory.numFiles;
+      directory.totalBytes = directory.numBytes;
+    }
+    for (std::size_t i = scan_.directories.size(); i-- > 1;) {
+      const ScannedDirectory &directory = scan_.directories[i];
+      ScannedDirectory &parent = scan_.directories[directory.parent];
+      parent.totalFiles += directory.totalFiles;
+      parent.totalBytes += directory.totalBytes;
+    }
+    scan_.numErrors = numErrors;
+    return std::move(scan_);
+  }
+
+private:
+  // Per thread, reused for every directory
+  struct Scratch {
+    std::vector<char> buffer;
+    // Entries of the current buffer waiting for their statx, and where the
+    // ring writes the results of one batch
+    std::vector<const LinuxDirent64 *> toStat;
+    std::vector<struct statx> statuses;
+  };
+
+  // What scan() fills in for one directory
+  struct Listing {
+    const std::string &prefix;
+    ScannedDirectory &directory;
+    std::vector<std::string> &children;
+  };
+
+  void scan(unsigned self, DirectoryWork work, Scratch &scratch) {
+    const int fd = openDirectory(work.path);
+    if (fd < 0) {
+      numErrors++;
+      return;
+    }
+
+    const std::string prefix =
+        work.path.ends_with('/') ? work.path : work.path + '/';
+    ScannedDirectory directory{.path = std::move(work.path),
+                               .parent = work.parent};
+    std::vector<std::string> children;
+    const Listing listing{prefix, directory, children};
+    StatxRing *ring = rings.empty() ? nullptr : rings[self].get();
+    while (true) {
+      const long numRead = syscall(SYS_getdents64, fd, scratch.buffer.data(),
+                                   scratch.buffer.size());
+      if (numRead <= 0) {
+        numErrors += numRead < 0;
+        break;
+      }
+      scratch.toStat.clear();
+      for (long offset = 0; offset < numRead;) {
+        const auto *entry = reinterpret_cast<const LinuxDirent64 *>(
+            scratch.buffer.data() + offset);
+        offset += entry->recordLength;
+        if (std::strcmp(entry->name, ".") == 0 or
+            std::strcmp(entry->name, "..") == 0 or
+            not needsStatx(*entry, listing)) {
+          continue;
+        }
+        if (ring != nullptr) {
+          scratch.toStat.push_back(entry);
+          continue;
+        }
+        struct statx status;
+        if (statx(fd, entry->name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+                  statxMask(*entry), &status) != 0) {
+          numErrors++;
+          continue;
+        }
+        addStatus(*entry, status, listing);
+      }
+      if (ring != nullptr) {
+        statBatches(*ring, fd, scratch, listing);
+      }
+    }
+    close(fd);
+
+    std::size_t index;
+    {
+      std::lock_guard lock(resultMutex);
+      index = scan_.directories.size();
+      scan_.directories.push_back(std::move(directory));
+    }
+    for (std::string &child : children) {
+      queues.push(self, {std::move(child), index});
+    }
+  }
+
+  // d_type says whether an entry is a directory without a stat; only
+  // sizes, and the odd file system that leaves d_type unknown, need statx.
+  // Counts the entries that d_type settles and returns whether this one
+  // needs statx.
+  bool needsStatx(const LinuxDirent64 &entry, const Listing &listing) {
+    if (entry.type == DT_DIR) {
+      listing.children.push_back(listing.prefix + entry.name);
+      return false;
+    }
+    if (entry.type != DT_REG and entry.type != DT_LNK and
+        entry.type != DT_UNKNOWN) {
+      // Devices, pipes and sockets have no size
+      listing.directory.numFiles++;
+      return false;
+    }
+    return true;
+  }
+
+  static unsigned statxMask(const LinuxDirent64 &entry) {
+    return entry.type == DT_UNKNOWN ? STATX_TYPE | STATX_SIZE : STATX_SIZE;
+  }
+
+  void addStatus(const LinuxDirent64 &entry, const struct statx &status,
+                 const Listing &listing) {
+    if (entry.type == DT_UNKNOWN and S_ISDIR(status.stx_mode)) {
+      listing.children.push_back(listing.prefix + entry.name);
+      return;
+    }
+    listing.directory.numFiles++;
+    listing.directory.numBytes += status.stx_size;
+  }
+
+  // The statx calls of one getdents64 buffer, a ring's worth per
+  // io_uring_enter. The names point into the buffer, which stays put until
+  // the next getdents64.
+  void statBatches(StatxRing &ring, int fd, Scratch &scratch,
+                   const Listing &listing) {
+    for (std::size_t first = 0; first < scratch.toStat.size();
+         first += StatxRing::numEntries) {
+      const std::size_t count = std::min<std::size_t>(
+          StatxRing::numEntries, scratch.toStat.size() - first);
+      for (std::size_t i = 0; i < count; i++) {
+        const LinuxDirent64 &entry = *scratch.toStat[first + i];
+        ring.queue(fd, entry.name, statxMask(entry), &scratch.statuses[i], i);
+      }
+      std::size_t numDone = 0;
+      ring.submitAndWait([&](std::uint64_t i, int result) {
+        numDone++;
+        if (result < 0) {
+          numErrors++;
+          return;
+        }
+        addStatus(*scratch.toStat[first + i], scratch.statuses[i], listing);
+      });
+      numErrors += count - numDone;
+    }
+  }
+
+  WorkQueues queues;
+  std::vector<std::unique_ptr<StatxRing>> rings;
+  std::size_t bufferSize;
+  std::mutex resultMutex;
+  DirectoryScan scan_;
+  std::atomic<std::uint64_t> numErrors = 0;
+};
+} // namespace
+
+std::optional<DirectoryScan>
+scanDirectory(std::string_view root, const DirectoryScanOptions &options) {
+  const std::string rootPath(root);
+  const int fd = openDirectory(rootPath);
+  if (fd < 0) {
+    std::print("Cannot open directory '{}': {}\n", root,
+               std::strerror(errno));
+    return std::nullopt;
+  }
+  close(fd);
+
+  const unsigned numThreads =
+      options.numThreads != 0
+          ? options.numThreads
+          : std::max(1u, std::thread::hardware_concurrency());
+  Scanner scanner(numThreads,
+                  std::max<std::size_t>(options.bufferSize, 1 << 12));
+  if (options.useIoUring) {
+    if (const int error = scanner.setupRings(numThreads); error != 0) {
+      std::print("Cannot set up io_uring: {}\n", std::strerror(error));
+      return std::nullopt;
+    }
+  }
+  scanner.run(rootPath, numThreads);
+  return scanner.result();
+}
+#else
+std::optional<DirectoryScan> scanDirectory(std::string_view root,
+                                           const DirectoryScanOptions &) {
+  std::print("Cannot scan '{}': getdents64 and statx are Linux only\n",
+             root);
+  return std::nullopt;
+}
+#endif
+} // namespace SCO
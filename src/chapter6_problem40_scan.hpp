@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SCO {
+struct DirectoryScanOptions {
+  // 0 for one per core
+  unsigned numThreads = 0;
+  // Per thread, for the getdents64 calls that read directory entries
+  std::size_t bufferSize = 1 << 18;
+  // Batches the statx calls of each getdents64 buffer through io_uring.
+  // Without it, or where io_uring_setup fails with ENOSYS or EPERM, every
+  // entry gets its own statx.
+  bool useIoUring = true;
+};
+
+struct ScannedDirectory {
+  std::string path;
+  // Index of the parent in DirectoryScan::directories, SIZE_MAX for the root
+  std::size_t parent = SIZE_MAX;
+  // Entries directly in this directory that are not directories, and the
+  // sum of their sizes
+  std::uint64_t numFiles = 0;
+  std::uint64_t numBytes = 0;
+  // The same over the whole subtree
+  std::uint64_t totalFiles = 0;
+  std::uint64_t totalBytes = 0;
+};
+
+struct DirectoryScan {
+  // The root first; every directory comes after its parent
+  std::vector<ScannedDirectory> directories;
+  // Entries that could not be opened or stat'ed, and were skipped
+  std::uint64_t numErrors = 0;
+};
+
+// Walks the tree under root in parallel, like lstat on every entry: symbolic
+// links are counted with their own size and not followed, and hard links
+// count once per name. Entries are read with getdents64 into large buffers,
+// and only entries whose d_type does not already say they are directories
+// get a statx for their size, submitted a buffer at a time to a per-thread
+// io_uring. Each thread works depth first on its own queue of directories
+// and steals from the others when it runs dry. nullopt if root cannot be
+// opened or io_uring fails to set up for another reason; Linux only.
+std::optional<DirectoryScan>
+scanDirectory(std::string_view root, const DirectoryScanOptions &options = {});
+} // namespace SCO
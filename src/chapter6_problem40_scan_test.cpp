@@ -0,0 +1,167 @@
+#ifdef __linux__
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <print>
+#include <string>
+#include <utility>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "chapter6_problem40_scan.hpp"
+#include "gtest/gtest.h"
+
+namespace SCO {
+namespace {
+namespace fs = std::filesystem;
+
+// A fresh directory under the system temporary directory, removed with
+// everything in it at the end of the test
+class TemporaryTree {
+public:
+  TemporaryTree()
+      : root(fs::temp_directory_path() /
+             ("sco_scan_" + std::to_string(getpid()) + "_" +
+              std::to_string(counter++))) {
+    fs::create_directories(root);
+  }
+  ~TemporaryTree() { fs::remove_all(root); }
+
+  void file(const fs::path &name, std::size_t size) const {
+    fs::create_directories((root / name).parent_path());
+    std::ofstream(root / name) << std::string(size, 'x');
+  }
+
+  const fs::path root;
+
+private:
+  static inline int counter = 0;
+};
+
+const ScannedDirectory *find(const DirectoryScan &scan,
+                             const fs::path &path) {
+  auto it = std::ranges::find(scan.directories, path.string(),
+                              &ScannedDirectory::path);
+  return it == scan.directories.end() ? nullptr : &*it;
+}
+} // namespace
+
+TEST(DirectoryScanTest, SizesPerSubtree) {
+  TemporaryTree tree;
+  tree.file("a.txt", 10);
+  tree.file("b.bin", 1000);
+  tree.file("sub/c.txt", 100);
+  tree.file("sub/deep/d.txt", 7);
+  tree.file("sub/deep/e.txt", 0);
+  fs::create_directory(tree.root / "empty");
+  // Links count with the length of their target and are not followed
+  fs::create_symlink("a.txt", tree.root / "link");
+  fs::create_directory_symlink("sub", tree.root / "loop");
+
+  for (auto [numThreads, useIoUring] :
+       {std::pair{1u, true}, {4u, true}, {1u, false}, {4u, false}}) {
+    auto scan = scanDirectory(
+        tree.root.string(),
+        {.numThreads = numThreads, .useIoUring = useIoUring});
+    ASSERT_TRUE(scan.has_value());
+    EXPECT_EQ(scan->numErrors, 0u);
+    ASSERT_EQ(scan->directories.size(), 4u);
+
+    const ScannedDirectory &root = scan->directories[0];
+    EXPECT_EQ(root.path, tree.root.string());
+    EXPECT_EQ(root.parent, SIZE_MAX);
+    EXPECT_EQ(root.numFiles, 4u);
+    EXPECT_EQ(root.numBytes, 10u + 1000 + 5 + 3);
+    EXPECT_EQ(root.totalFiles, 7u);
+    EXPECT_EQ(root.totalBytes, 10u + 1000 + 5 + 3 + 100 + 7);
+
+    const ScannedDirectory *sub = find(*scan, tree.root / "sub");
+    const ScannedDirectory *deep = find(*scan, tree.root / "sub" / "deep");
+    const ScannedDirectory *empty = find(*scan, tree.root / "empty");
+    ASSERT_NE(sub, nullptr);
+    ASSERT_NE(deep, nullptr);
+    ASSERT_NE(empty, nullptr);
+    EXPECT_EQ(sub->numFiles, 1u);
+    EXPECT_EQ(sub->totalFiles, 3u);
+    EXPECT_EQ(sub->totalBytes, 107u);
+    EXPECT_EQ(deep->totalFiles, 2u);
+    EXPECT_EQ(deep->totalBytes, 7u);
+    EXPECT_EQ(empty->totalFiles, 0u);
+    EXPECT_EQ(&scan->directories[deep->parent], sub);
+    EXPECT_EQ(scan->directories[sub->parent].path, root.path);
+  }
+}
+
+TEST(DirectoryScanTest, ThreadsAgreeWithFilesystem) {
+  TemporaryTree tree;
+  // Wide and deep enough that the threads have something to steal
+  for (int i = 0; i < 16; i++) {
+    for (int j = 0; j < 8; j++) {
+      tree.file(fs::path(std::to_string(i)) / std::to_string(j) / "f",
+                i * 8 + j);
+    }
+  }
+
+  std::uint64_t numFiles = 0;
+  std::uint64_t numBytes = 0;
+  for (const auto &entry : fs::recursive_directory_iterator(tree.root)) {
+    if (not entry.is_directory()) {
+      numFiles++;
+      numBytes += entry.file_size();
+    }
+  }
+
+  // A small buffer takes several getdents64 calls per directory
+  for (unsigned numThreads : {1u, 2u, 4u}) {
+    for (bool useIoUring : {true, false}) {
+      auto scan = scanDirectory(tree.root.string(),
+                                {.numThreads = numThreads,
+                                 .bufferSize = 4096,
+                                 .useIoUring = useIoUring});
+      ASSERT_TRUE(scan.has_value());
+      EXPECT_EQ(scan->directories.size(), 1u + 16 + 16 * 8);
+      EXPECT_EQ(scan->directories[0].totalFiles, numFiles);
+      EXPECT_EQ(scan->directories[0].totalBytes, numBytes);
+      for (std::size_t i = 1; i < scan->directories.size(); i++) {
+        EXPECT_LT(scan->directories[i].parent, i);
+      }
+    }
+  }
+}
+
+TEST(DirectoryScanTest, MissingRoot) {
+  EXPECT_FALSE(scanDirectory("/nonexistent/sco/scan/root").has_value());
+}
+
+TEST(DirectoryScanTest, DISABLED_ScanBenchmark) {
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](const timeval &time) {
+    return time.tv_sec + time.tv_usec / 1e6;
+  };
+
+  for (auto [numThreads, useIoUring] :
+       {std::pair{1u, false}, {1u, true}, {0u, false}, {0u, true}}) {
+    rusage before;
+    getrusage(RUSAGE_SELF, &before);
+    auto start = Clock::now();
+    auto scan = scanDirectory(
+        "/usr", {.numThreads = numThreads, .useIoUring = useIoUring});
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    rusage after;
+    getrusage(RUSAGE_SELF, &after);
+    ASSERT_TRUE(scan.has_value());
+
+    const ScannedDirectory &root = scan->directories[0];
+    std::print("/usr with {} threads{}: {} directories, {} files, {} bytes, "
+               "{} errors in {:.2f} s ({:.2f} s user, {:.2f} s system)\n",
+               numThreads, useIoUring ? " and io_uring" : "",
+               scan->directories.size(), root.totalFiles,
+               root.totalBytes, scan->numErrors, elapsed.count(),
+               seconds(after.ru_utime) - seconds(before.ru_utime),
+               seconds(after.ru_stime) - seconds(before.ru_stime));
+  }
+}
+} // namespace SCO
+#endif